@@ -126,6 +126,10 @@ if(MIRRAGE_ENABLE_TESTS)
 	enable_testing()
 endif()
 
+option(MIRRAGE_ENABLE_BENCHMARKS "Build the micro-benchmarks" OFF)
+
+option(MIRRAGE_ENABLE_CPU_PROFILER "Record the CPU time of instrumented scopes (MIRRAGE_PROFILE_ZONE)" ON)
+
 option(MIRRAGE_ENABLE_CLANG_FORMAT "Includes a clangformat target, that automatically formats the source files." OFF)
 if(MIRRAGE_ENABLE_CLANG_FORMAT)
 	include(${MIRRAGE_ROOT_DIR}/clang-format.cmake)
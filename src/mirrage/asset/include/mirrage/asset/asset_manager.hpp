@@ -9,12 +9,17 @@
 
 #include <mirrage/asset/aid.hpp>
 #include <mirrage/asset/error.hpp>
+#include <mirrage/asset/load_trace.hpp>
 #include <mirrage/asset/stream.hpp>
 
 #include <mirrage/utils/container_utils.hpp>
+#include <mirrage/utils/cpu_profiler.hpp>
+#include <mirrage/utils/interned_str.hpp>
+#include <mirrage/utils/job_system.hpp>
 #include <mirrage/utils/log.hpp>
 #include <mirrage/utils/maybe.hpp>
 #include <mirrage/utils/reflection.hpp>
+#include <mirrage/utils/sharded_map.hpp>
 #include <mirrage/utils/string_utils.hpp>
 
 #include <async++.h>
@@ -92,12 +97,30 @@ namespace mirrage::asset {
 		        tsl::robin_map<K, V, std::hash<K>, std::equal_to<>, std::allocator<std::pair<K, V>>, true>;
 
 
+		/// marks the asset that is currently loaded by the calling thread, so that all assets
+		///   requested by its loader can be recorded as its dependencies
+		class Loading_scope {
+		  public:
+			explicit Loading_scope(const AID& aid) noexcept;
+			~Loading_scope();
+
+			Loading_scope(const Loading_scope&) = delete;
+			Loading_scope& operator=(const Loading_scope&) = delete;
+
+			static auto current() noexcept -> const AID*;
+
+		  private:
+			const AID* _parent;
+		};
+
 		class Asset_container_base {
 		  public:
 			virtual ~Asset_container_base() = default;
 
-			virtual void shrink_to_fit() noexcept = 0;
-			virtual void reload()                 = 0;
+			virtual void shrink_to_fit() noexcept                          = 0;
+			virtual void reload()                                          = 0;
+			virtual void prefetch(const AID& aid, const std::string& path) = 0;
+			virtual auto type_name() const noexcept -> const std::string&  = 0;
 		};
 
 		template <typename T>
@@ -108,11 +131,7 @@ namespace mirrage::asset {
 			  : Loader<T>(std::forward<Args>(args)...), _manager(manager)
 			{
 			}
-			~Asset_container()
-			{
-				auto lock = std::scoped_lock{_container_mutex};
-				_assets.clear();
-			}
+			~Asset_container() { _assets.clear(); }
 
 			using Loader<T>::load;
 			using Loader<T>::save;
@@ -123,27 +142,47 @@ namespace mirrage::asset {
 
 			void shrink_to_fit() noexcept override;
 			void reload() override;
+			void prefetch(const AID& aid, const std::string& path) override { _load(aid, path, true, false); }
+			auto type_name() const noexcept -> const std::string& override;
 
 		  private:
 			struct Asset {
 				AID                   aid;
 				async::shared_task<T> task;
 				int64_t               last_modified;
+				bool                  deduplicated = false; //< task is shared with other files
 			};
+			struct Content {
+				std::string path;
+				std::string hash; //< calculated when a file with the same size is loaded; empty until then
+				int64_t     last_modified;
+			};
+
+			// keyed by the resolved path
+			Asset_manager&                                    _manager;
+			util::sharded_map<Map<util::Interned_str, Asset>> _assets;
 
-			Asset_manager&          _manager;
-			Map<std::string, Asset> _assets;
-			std::mutex              _container_mutex;
+			// known files by their size, used to find byte-identical files (only if enabled by the Loader)
+			std::mutex                              _contents_mutex;
+			Map<std::int64_t, std::vector<Content>> _contents;
 
+			auto _load(AID aid, const std::string& path, bool cache, bool prefetch_dependencies) -> Ptr<T>;
+			auto _spawn_loading(const AID& aid, const std::string& path, std::string hash = {})
+			        -> async::shared_task<T>;
+			auto _find_duplicate(const std::string& path, std::string& hash) -> async::shared_task<T>;
+			void _add_content(const std::string& path, std::string hash);
 			void _reload_asset(Asset&, const std::string& path);
 		};
 	} // namespace detail
 
 	extern const std::string default_archives_list_filename;
+	extern const std::string dependency_manifest_filename;
 
 	class Asset_manager {
 	  public:
-		Asset_manager(const std::string&       exe_name,
+		/// assets are loaded by low priority jobs, so they don't delay time-critical work (e.g. rendering)
+		Asset_manager(util::job_system&        jobs,
+		              const std::string&       exe_name,
 		              const std::string&       org_name,
 		              const std::string&       app_name,
 		              util::maybe<std::string> additional_search_path,
@@ -154,6 +193,12 @@ namespace mirrage::asset {
 		void shrink_to_fit() noexcept;
 		void clear();
 
+		/// writes the recorded asset dependencies to the write dir, to prefetch them on the next start
+		void save_dependency_manifest();
+
+		auto load_tracer() noexcept -> Load_tracer& { return _load_tracer; }
+		auto jobs() noexcept -> util::job_system& { return _jobs; }
+
 
 		template <typename T>
 		auto load(const AID& id, bool cache = true) -> Ptr<T>;
@@ -200,13 +245,24 @@ namespace mirrage::asset {
 			std::string base_dir;
 			std::string default_extension;
 		};
+		struct Dependency {
+			AID         aid;
+			std::string type_name;
+		};
 
+		util::job_system&         _jobs;
 		mutable std::mutex        _containers_mutex;
 		mutable std::shared_mutex _dispatchers_mutex;
+		mutable std::mutex        _dependencies_mutex;
 
 		detail::Map<util::type_uid_t, std::unique_ptr<detail::Asset_container_base>> _containers;
 		detail::Map<AID, std::string>                                                _dispatchers;
 		detail::Map<Asset_type, General_Disptacher>                                  _general_dispatchers;
+		detail::Map<AID, std::vector<Dependency>>                                    _dependencies;
+
+		bool _dependencies_dirty = false;
+
+		Load_tracer _load_tracer;
 
 
 		void _post_write();
@@ -215,7 +271,13 @@ namespace mirrage::asset {
 
 		void _reload_dispatchers();
 
+		void _load_dependency_manifest();
+		void _add_dependency(const AID& parent, const AID& child, const std::string& type_name);
+		void _prefetch_dependencies(const AID& id);
+
 		auto _last_modified(const std::string& path) const -> int64_t;
+		auto _file_size(const std::string& path) const -> int64_t;
+		auto _content_hash(const std::string& path) const -> std::string;
 		auto _open(const asset::AID& id, const std::string& path) -> istream;
 		auto _open_rw(const asset::AID& id, const std::string& path) -> ostream;
 
@@ -64,6 +64,14 @@ namespace mirrage::asset {
 		template <class T>
 		constexpr auto has_reload_v = has_reload<T>::value;
 
+		template <class T, class = void>
+		struct has_content_deduplication : std::false_type {
+		};
+		template <class T>
+		struct has_content_deduplication<T, std::void_t<decltype(Loader<T>::deduplicate_content)>>
+		  : std::bool_constant<Loader<T>::deduplicate_content> {
+		};
+
 		template <class TaskType, class T>
 		constexpr auto is_task_v =
 		        std::is_same_v<T,
@@ -72,60 +80,267 @@ namespace mirrage::asset {
 		template <typename T>
 		auto Asset_container<T>::load(AID aid, const std::string& path, bool cache) -> Ptr<T>
 		{
-			auto lock = std::scoped_lock{_container_mutex};
+			return _load(std::move(aid), path, cache, !Loading_scope::current());
+		}
+
+		template <typename T>
+		auto Asset_container<T>::_load(AID                aid,
+		                               const std::string& path,
+		                               bool               cache,
+		                               bool               prefetch_dependencies) -> Ptr<T>
+		{
+			auto result = Ptr<T>();
+			auto key    = util::Interned_str::hashed(path);
 
-			auto found = _assets.find(path);
-			if(found != _assets.end())
-				return {aid, found->second.task};
+			// fast path for cache hits, that only requires a shared lock
+			if(_assets.visit(key, [&](const Asset& asset) { result = Ptr<T>(aid, asset.task); }))
+				return result;
+
+			// only on cache misses, because the dependencies of cached assets have already been loaded
+			if(prefetch_dependencies)
+				_manager._prefetch_dependencies(aid);
+
+			if(!cache)
+				return {aid, _spawn_loading(aid, path)};
+
+			auto duplicate = async::shared_task<T>();
+			auto hash      = std::string();
+			if constexpr(has_content_deduplication<T>::value) {
+				duplicate = _find_duplicate(path, hash);
+			}
+
+			return _assets.modify(key, [&](auto& assets) -> Ptr<T> {
+				// recheck, because another thread might have started loading it in the meantime
+				auto found = assets.find(key);
+				if(found != assets.end())
+					return {aid, found->second.task};
+
+				auto interned_path = util::Interned_str(path);
+
+				if(duplicate.valid()) {
+					assets.try_emplace(
+					        interned_path, Asset{aid, duplicate, _manager._last_modified(path), true});
+					return {aid, duplicate};
+				}
+
+				// not found => load
+				auto loading = _spawn_loading(aid, path, std::move(hash));
+				assets.try_emplace(interned_path, Asset{aid, loading, _manager._last_modified(path)});
+
+				return {aid, loading};
+			});
+		}
+
+		template <typename T>
+		auto Asset_container<T>::_spawn_loading(const AID& aid, const std::string& path, std::string hash)
+		        -> async::shared_task<T>
+		{
+			auto  trace     = _manager._load_tracer.begin(aid, type_name());
+			auto& scheduler = _manager._jobs.scheduler(util::Job_priority::low);
 
-			// not found => load
 			// clang-format off
-			auto loading = async::spawn([path = std::string(path), aid, this] {
-				return Loader<T>::load(_manager._open(aid, path));
+			auto loading = async::spawn(scheduler, [path = std::string(path), hash = std::move(hash), aid,
+			                                        trace, this]() mutable {
+				MIRRAGE_PROFILE_ZONE("Asset_manager::load");
+				auto scope = Loading_scope{aid};
+
+				if constexpr(has_content_deduplication<T>::value) {
+					_add_content(path, std::move(hash));
+				}
+
+				if(!trace)
+					return Loader<T>::load(_manager._open(aid, path));
+
+				trace->mark_io_start();
+				auto in = _manager._open(aid, path);
+				trace->mark_decode_start();
+				auto result = Loader<T>::load(std::move(in));
+				trace->mark_decode_end();
+				return result;
 			}).share();
 			// clang-format on
 
-			if(cache)
-				_assets.try_emplace(path, Asset{aid, loading, _manager._last_modified(path)});
+			if(trace) {
+				loading.then(scheduler,
+				             [trace, &tracer = _manager._load_tracer](const async::shared_task<T>&) {
+					             tracer.finish(trace);
+				             });
+			}
 
-			return {aid, loading};
+			return loading;
 		}
 
 		template <typename T>
-		void Asset_container<T>::save(const AID& aid, const std::string& name, const T& obj)
+		auto Asset_container<T>::_find_duplicate(const std::string& path, std::string& hash)
+		        -> async::shared_task<T>
 		{
-			auto lock = std::scoped_lock{_container_mutex};
+			// files are only hashed if a file with the same size has already been loaded, which is
+			//   also when the loaded file is hashed (once) for the first time
+			auto size       = std::int64_t(0);
+			auto candidates = std::vector<Content>();
+			try {
+				size = _manager._file_size(path);
+
+				auto lock = std::scoped_lock{_contents_mutex};
+				if(auto found = _contents.find(size); found != _contents.end())
+					candidates = found->second;
+
+			} catch(const std::system_error&) {
+				return {}; // missing files are reported by the loading task
+			}
 
-			Loader<T>::save(_manager._open_rw(aid, name), obj);
+			for(auto& c : candidates) {
+				if(c.path == path)
+					continue;
 
-			auto found = _assets.find(name);
-			if(found != _assets.end() && &found.value().task.get() != &obj) {
-				_reload_asset(found.value(), found.key()); // replace existing value
+				try {
+					if(_manager._last_modified(c.path) != c.last_modified)
+						continue; // modified since it has been loaded
+				} catch(const std::system_error&) {
+					continue; // file has been removed
+				}
+
+				if(hash.empty() && (hash = _manager._content_hash(path)).empty())
+					return {};
+
+				if(c.hash.empty()) {
+					if((c.hash = _manager._content_hash(c.path)).empty())
+						continue;
+
+					auto lock = std::scoped_lock{_contents_mutex};
+					for(auto& content : _contents[size]) {
+						if(content.path == c.path && content.last_modified == c.last_modified)
+							content.hash = c.hash;
+					}
+				}
+
+				if(c.hash != hash)
+					continue;
+
+				auto duplicate = async::shared_task<T>();
+				auto key       = util::Interned_str::hashed(c.path);
+				_assets.modify(key, [&](auto& assets) {
+					auto found = assets.find(key);
+					if(found != assets.end()) {
+						found.value().deduplicated = true;
+						duplicate                  = found->second.task;
+					}
+				});
+
+				if(duplicate.valid())
+					return duplicate;
 			}
+
+			return {};
 		}
 
 		template <typename T>
-		void Asset_container<T>::shrink_to_fit() noexcept
+		void Asset_container<T>::_add_content(const std::string& path, std::string hash)
 		{
-			auto lock = std::scoped_lock{_container_mutex};
+			auto content = Content{path, std::move(hash), 0};
+			auto size    = std::int64_t(0);
+			try {
+				size                  = _manager._file_size(path);
+				content.last_modified = _manager._last_modified(path);
+			} catch(const std::system_error&) {
+				return; // reported by the loader, when it tries to open the file
+			}
 
-			util::erase_if(_assets, [](const auto& v) { return v.second.task.refcount() <= 1; });
+			auto  lock     = std::scoped_lock{_contents_mutex};
+			auto& contents = _contents[size];
+			util::erase_if(contents, [&](auto& c) { return c.path == path; });
+			contents.emplace_back(std::move(content));
 		}
 
 		template <typename T>
-		void Asset_container<T>::reload()
+		void Asset_container<T>::save(const AID& aid, const std::string& name, const T& obj)
 		{
-			auto lock = std::scoped_lock{_container_mutex};
+			auto key = util::Interned_str::hashed(name);
+			_assets.modify(key, [&](auto& assets) {
+				Loader<T>::save(_manager._open_rw(aid, name), obj);
+
+				auto found = assets.find(key);
+				if(found != assets.end() && found->second.deduplicated) {
+					// the old value is shared with other files, that haven't been modified
+					found.value().task          = _spawn_loading(aid, name);
+					found.value().last_modified = _manager._last_modified(name);
+					found.value().deduplicated  = false;
+
+				} else if(found != assets.end() && &found.value().task.get() != &obj) {
+					_reload_asset(found.value(), name); // replace existing value
+				}
+			});
+		}
 
-			for(auto&& entry : _assets) {
-				auto last_mod = _manager._last_modified(entry.first);
+		template <typename T>
+		auto Asset_container<T>::type_name() const noexcept -> const std::string&
+		{
+			static const auto name = util::type_name<T>();
+			return name;
+		}
 
-				if(last_mod > entry.second.last_modified) {
-					_reload_asset(const_cast<Asset&>(entry.second), entry.first);
+		template <typename T>
+		void Asset_container<T>::shrink_to_fit() noexcept
+		{
+			if constexpr(!has_content_deduplication<T>::value) {
+				_assets.for_each_shard([](auto& assets) {
+					util::erase_if(assets, [](const auto& v) { return v.second.task.refcount() <= 1; });
+				});
+
+			} else {
+				// deduplicated assets are referenced once by each file that shares them
+				auto is_shared = [](const Asset& a) {
+					return a.deduplicated && a.task.ready() && !a.task.canceled();
+				};
+				auto references = Map<const T*, std::size_t>();
+				_assets.for_each_shard([&](auto& assets) {
+					for(auto&& entry : assets) {
+						if(is_shared(entry.second))
+							references[&entry.second.task.get()]++;
+					}
+				});
+
+				_assets.for_each_shard([&](auto& assets) {
+					util::erase_if(assets, [&](const auto& v) {
+						auto& task = v.second.task;
+						auto  refs = is_shared(v.second) ? references[&task.get()] : std::size_t(1);
+						return std::size_t(task.refcount()) <= refs;
+					});
+				});
+
+				auto lock = std::scoped_lock{_contents_mutex};
+				for(auto iter = _contents.begin(); iter != _contents.end(); ++iter) {
+					util::erase_if(iter.value(), [&](auto& c) {
+						return !_assets.visit(util::Interned_str::hashed(c.path), [](const Asset&) {});
+					});
 				}
 			}
 		}
 
+		template <typename T>
+		void Asset_container<T>::reload()
+		{
+			_assets.for_each_shard([&](auto& assets) {
+				for(auto&& entry : assets) {
+					auto& path     = entry.first.str();
+					auto  last_mod = _manager._last_modified(path);
+
+					if(last_mod > entry.second.last_modified) {
+						auto& asset = const_cast<Asset&>(entry.second);
+
+						if(asset.deduplicated) {
+							// the old value is shared with other files, that haven't been modified
+							asset.task          = _spawn_loading(asset.aid, path);
+							asset.last_modified = last_mod;
+							asset.deduplicated  = false;
+						} else {
+							_reload_asset(asset, path);
+						}
+					}
+				}
+			});
+		}
+
 		// TODO: test if this actually works
 		template <typename T>
 		void Asset_container<T>::_reload_asset(Asset& asset, const std::string& path)
@@ -164,6 +379,9 @@ namespace mirrage::asset {
 		if(container.is_nothing())
 			throw std::system_error(Asset_error::stateful_loader_not_initialized, util::type_name<T>());
 
+		if(auto parent = detail::Loading_scope::current())
+			_add_dependency(*parent, id, container.get_or_throw().type_name());
+
 		return container.get_or_throw().load(id, path.get_or_throw(), cache);
 	}
 
@@ -175,6 +393,9 @@ namespace mirrage::asset {
 			return util::nothing;
 
 		return _find_container<T>().process([&](detail::Asset_container<T>& container) {
+			if(auto parent = detail::Loading_scope::current())
+				_add_dependency(*parent, id, container.type_name());
+
 			return container.load(id, path.get_or_throw(), cache);
 		});
 	}
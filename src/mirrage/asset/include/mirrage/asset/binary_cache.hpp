@@ -0,0 +1,382 @@
+/** binary cache for assets parsed from JSON *********************************
+ *                                                                           *
+ * Copyright (c) 2020 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <mirrage/utils/interned_str.hpp>
+#include <mirrage/utils/maybe.hpp>
+#include <mirrage/utils/reflection.hpp>
+#include <mirrage/utils/str_id.hpp>
+#include <mirrage/utils/xxhash.hpp>
+
+#include <boost/pfr/precise.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <sf2/sf2.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace mirrage::asset {
+
+	class istream;
+	template <class R>
+	class Ptr;
+
+	/// globally enables/disables the binary cache (enabled by default)
+	extern void binary_cache_enabled(bool);
+	extern auto binary_cache_enabled() noexcept -> bool;
+
+	/**
+	 * Specialize for types that can be cached by copying their bytes.
+	 * Types that are neither trivially cacheable, aggregates, strings or containers of
+	 *   cacheable types are always parsed from their JSON source. So are aggregates with base classes,
+	 *   because they can't be restored field by field.
+	 * Asset handles (Ptr) are not stored and are restored as empty handles, that have to be resolved
+	 *   again by the loader (e.g. from an AID string that is part of the cached value).
+	 */
+	template <class T>
+	struct is_trivially_cacheable : std::bool_constant<std::is_arithmetic_v<T> || std::is_enum_v<T>> {
+	};
+	template <>
+	struct is_trivially_cacheable<util::Str_id> : std::true_type {
+	};
+	template <>
+	struct is_trivially_cacheable<glm::vec2> : std::true_type {
+	};
+	template <>
+	struct is_trivially_cacheable<glm::vec3> : std::true_type {
+	};
+	template <>
+	struct is_trivially_cacheable<glm::vec4> : std::true_type {
+	};
+	template <>
+	struct is_trivially_cacheable<glm::ivec2> : std::true_type {
+	};
+	template <>
+	struct is_trivially_cacheable<glm::ivec3> : std::true_type {
+	};
+	template <>
+	struct is_trivially_cacheable<glm::ivec4> : std::true_type {
+	};
+	template <>
+	struct is_trivially_cacheable<glm::mat3> : std::true_type {
+	};
+	template <>
+	struct is_trivially_cacheable<glm::mat4> : std::true_type {
+	};
+	template <>
+	struct is_trivially_cacheable<glm::quat> : std::true_type {
+	};
+
+
+	namespace detail {
+		template <class T, class = void>
+		struct is_sequence : std::false_type {
+		};
+		template <class T>
+		struct is_sequence<T,
+		                   std::void_t<typename T::value_type,
+		                               decltype(std::declval<T&>().push_back(
+		                                       std::declval<typename T::value_type>())),
+		                               decltype(std::declval<const T&>().size())>> : std::true_type {
+		};
+
+		template <class T, class = void>
+		struct is_map : std::false_type {
+		};
+		template <class T>
+		struct is_map<T,
+		              std::void_t<typename T::key_type,
+		                          typename T::mapped_type,
+		                          decltype(std::declval<T&>().emplace(
+		                                  std::declval<typename T::key_type>(),
+		                                  std::declval<typename T::mapped_type>()))>> : std::true_type {
+		};
+
+		template <class T>
+		struct is_asset_ptr : std::false_type {
+		};
+		template <class R>
+		struct is_asset_ptr<Ptr<R>> : std::true_type {
+		};
+
+		/// converts only to the (direct or indirect) base classes of T
+		template <class T>
+		struct Any_base_of {
+			template <class U, class = std::enable_if_t<std::is_base_of_v<U, T> && !std::is_same_v<U, T>>>
+			operator U() const;
+		};
+
+		/// true if the first element of the aggregate T is a base class, which boost::pfr doesn't support
+		template <class T, class = void>
+		struct has_base_class : std::false_type {
+		};
+		template <class T>
+		struct has_base_class<T, std::void_t<decltype(T{Any_base_of<T>{}})>> : std::true_type {
+		};
+
+		/// aggregates that can be traversed field by field with boost::pfr
+		template <class T>
+		constexpr auto is_reflectable_aggregate() -> bool
+		{
+			if constexpr(std::is_class_v<T> && std::is_aggregate_v<T> && !std::is_union_v<T>)
+				return !has_base_class<T>::value;
+			else
+				return false;
+		}
+
+		/// member names of sf2 annotated structs are either string literals or sf2::String_literal
+		template <class Name>
+		auto member_name(const Name& name) -> std::string
+		{
+			if constexpr(std::is_convertible_v<const Name&, std::string_view>)
+				return std::string(std::string_view(name));
+			else
+				return name.str();
+		}
+
+		template <class T>
+		constexpr auto is_binary_cacheable() -> bool;
+
+		template <class T, std::size_t... I>
+		constexpr auto all_fields_cacheable(std::index_sequence<I...>) -> bool
+		{
+			return (is_binary_cacheable<boost::pfr::tuple_element_t<I, T>>() && ...);
+		}
+
+		/// true if T can be stored in and restored from the binary cache
+		template <class T>
+		constexpr auto is_binary_cacheable() -> bool
+		{
+			if constexpr(is_trivially_cacheable<T>::value || std::is_same_v<T, std::string>
+			             || std::is_same_v<T, util::Interned_str> || is_asset_ptr<T>::value)
+				return true;
+			else if constexpr(is_map<T>::value)
+				return is_binary_cacheable<typename T::key_type>()
+				       && is_binary_cacheable<typename T::mapped_type>();
+			else if constexpr(is_sequence<T>::value)
+				return is_binary_cacheable<typename T::value_type>();
+			else if constexpr(is_reflectable_aggregate<T>())
+				return all_fields_cacheable<T>(std::make_index_sequence<boost::pfr::tuple_size_v<T>>{});
+			else
+				return false;
+		}
+
+
+		template <class T>
+		auto layout_hash() -> std::uint64_t;
+
+		template <class T, std::size_t... I>
+		auto fields_layout_hash(std::uint64_t hash, std::index_sequence<I...>) -> std::uint64_t
+		{
+			((hash = hash * 31u + layout_hash<boost::pfr::tuple_element_t<I, T>>()), ...);
+			return hash;
+		}
+
+		template <class T>
+		void write_binary(std::vector<char>& out, const T& value);
+
+		/// hash of the layout and default values, used to invalidate cache entries after the type has been
+		///   changed; covers the names and types of all fields, as well as the default values of all
+		///   aggregates, because fields that are missing in the JSON source are cached with them
+		template <class T>
+		auto layout_hash() -> std::uint64_t
+		{
+			auto hash = util::xxh3_64(util::type_name<T>(), std::uint64_t(sizeof(T)) * 31u + alignof(T));
+
+			if constexpr(is_map<T>::value) {
+				hash = hash * 31u + layout_hash<typename T::key_type>();
+				hash = hash * 31u + layout_hash<typename T::mapped_type>();
+			} else if constexpr(is_sequence<T>::value && !std::is_same_v<T, std::string>) {
+				hash = hash * 31u + layout_hash<typename T::value_type>();
+			} else if constexpr(is_reflectable_aggregate<T>() && !is_trivially_cacheable<T>::value) {
+				hash = hash * 31u + boost::pfr::tuple_size_v<T>;
+				hash = fields_layout_hash<T>(hash, std::make_index_sequence<boost::pfr::tuple_size_v<T>>{});
+
+				if constexpr(sf2::is_annotated<T>::value) {
+					sf2::get_struct_info<T>().for_each([&](auto&& name, auto&&...) {
+						hash = util::xxh3_64(member_name(name), hash);
+					});
+				}
+
+				auto defaults = std::vector<char>();
+				write_binary(defaults, T{});
+				hash = util::xxh3_64(defaults.data(), defaults.size(), hash);
+			}
+
+			return hash;
+		}
+
+		template <class T>
+		auto type_hash() -> std::uint64_t
+		{
+			static const auto hash = layout_hash<T>();
+			return hash;
+		}
+
+
+		template <class T>
+		void write_binary(std::vector<char>& out, const T& value)
+		{
+			if constexpr(is_trivially_cacheable<T>::value) {
+				auto bytes = reinterpret_cast<const char*>(&value);
+				out.insert(out.end(), bytes, bytes + sizeof(T));
+
+			} else if constexpr(is_asset_ptr<T>::value) {
+				// not stored, because the asset might not even be loaded when the cache is read
+				(void) value;
+
+			} else if constexpr(std::is_same_v<T, util::Interned_str>) {
+				// the handle is only valid while the string is part of the table, so it's stored as a string
+				write_binary(out, value.str());
+
+			} else if constexpr(is_map<T>::value || is_sequence<T>::value) {
+				write_binary(out, std::uint64_t(value.size()));
+
+				if constexpr(std::is_same_v<T, std::string>) {
+					out.insert(out.end(), value.begin(), value.end());
+				} else {
+					for(auto& e : value) {
+						if constexpr(is_map<T>::value) {
+							write_binary(out, e.first);
+							write_binary(out, e.second);
+						} else {
+							write_binary(out, e);
+						}
+					}
+				}
+
+			} else {
+				boost::pfr::for_each_field(value, [&](auto& field) { write_binary(out, field); });
+			}
+		}
+
+		/// @return false if the data is truncated
+		template <class T>
+		auto read_binary(const char*& pos, const char* end, T& value) -> bool
+		{
+			if constexpr(is_trivially_cacheable<T>::value) {
+				if(end - pos < std::ptrdiff_t(sizeof(T)))
+					return false;
+
+				std::memcpy(&value, pos, sizeof(T));
+				pos += sizeof(T);
+				return true;
+
+			} else if constexpr(is_asset_ptr<T>::value) {
+				value = T{};
+				return true;
+
+			} else if constexpr(std::is_same_v<T, util::Interned_str>) {
+				auto str = std::string();
+				if(!read_binary(pos, end, str))
+					return false;
+
+				value = util::Interned_str(str);
+				return true;
+
+			} else if constexpr(is_map<T>::value || is_sequence<T>::value) {
+				auto size = std::uint64_t(0);
+				if(!read_binary(pos, end, size))
+					return false;
+
+				value.clear();
+
+				if constexpr(std::is_same_v<T, std::string>) {
+					if(std::uint64_t(end - pos) < size)
+						return false;
+
+					value.assign(pos, pos + size);
+					pos += size;
+					return true;
+
+				} else {
+					for(auto i = std::uint64_t(0); i < size; i++) {
+						if constexpr(is_map<T>::value) {
+							auto key = typename T::key_type{};
+							auto val = typename T::mapped_type{};
+							if(!read_binary(pos, end, key) || !read_binary(pos, end, val))
+								return false;
+
+							value.emplace(std::move(key), std::move(val));
+						} else {
+							value.push_back(typename T::value_type{});
+							if(!read_binary(pos, end, value.back()))
+								return false;
+						}
+					}
+					return true;
+				}
+
+			} else {
+				auto success = true;
+				boost::pfr::for_each_field(value, [&](auto& field) {
+					success = success && read_binary(pos, end, field);
+				});
+				return success;
+			}
+		}
+
+		/// @return the cached payload, if the cache entry for the file is valid
+		extern auto read_binary_cache(const istream&, std::uint64_t type_hash)
+		        -> util::maybe<std::vector<char>>;
+		extern void write_binary_cache(const istream&,
+		                               std::uint64_t            type_hash,
+		                               const std::vector<char>& data);
+	} // namespace detail
+
+
+	/**
+	 * Restores the value from the binary cache of the file, if it's still up-to-date, or uses the given
+	 *   function parse(istream&, T&) to read it, otherwise.
+	 * If parse returns false, the result is not cached (e.g. because of parse errors).
+	 */
+	template <class T, class Parse>
+	void load_cached(istream& in, T& value, Parse&& parse)
+	{
+		if constexpr(!detail::is_binary_cacheable<T>()) {
+			parse(in, value);
+
+		} else {
+			auto enabled = binary_cache_enabled();
+
+			if(enabled) {
+				auto cached = detail::read_binary_cache(in, detail::type_hash<T>());
+				if(cached.is_some()) {
+					auto& data = cached.get_or_throw();
+					auto  pos  = const_cast<const char*>(data.data());
+					auto  end  = pos + data.size();
+
+					if(detail::read_binary(pos, end, value) && pos == end)
+						return;
+
+					value = T{};
+				}
+			}
+
+			auto success = true;
+			if constexpr(std::is_same_v<decltype(parse(in, value)), bool>)
+				success = parse(in, value);
+			else
+				parse(in, value);
+
+			if(enabled && success) {
+				auto data = std::vector<char>();
+				detail::write_binary(data, value);
+				detail::write_binary_cache(in, detail::type_hash<T>(), data);
+			}
+		}
+	}
+
+} // namespace mirrage::asset
@@ -0,0 +1,81 @@
+/** recording & export of asset load timelines *******************************
+ *                                                                           *
+ * Copyright (c) 2020 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <mirrage/asset/aid.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace mirrage::asset {
+
+	using Trace_clock = std::chrono::steady_clock;
+
+	/// timeline of a single asset load. Phases that have not been reached are default-initialized
+	struct Load_trace {
+		AID         aid;
+		std::string type_name;
+
+		Trace_clock::time_point queued;
+		Trace_clock::time_point io_start;
+		Trace_clock::time_point io_end;
+		Trace_clock::time_point decode_start;
+		Trace_clock::time_point decode_end; //< the synchronous part of Loader<T>::load returned
+		Trace_clock::time_point ready;      //< the task completed (including async work like GPU uploads)
+		Trace_clock::duration   read_time{}; //< time spent reading from the file while decoding
+
+		std::uint32_t queued_thread = 0;
+		std::uint32_t load_thread   = 0;
+		std::uint32_t ready_thread  = 0;
+
+		void mark_io_start();
+		void mark_decode_start();
+		void mark_decode_end();
+	};
+
+	/**
+	 * Collects the Load_traces of all assets loaded while it's active.
+	 * The result can be exported in the Chrome trace-event format (chrome://tracing, ui.perfetto.dev).
+	 */
+	class Load_tracer {
+	  public:
+		/// discards all previously collected traces and starts recording
+		void start();
+		void stop();
+		auto active() const noexcept { return _active.load(std::memory_order_relaxed); }
+
+		/// @return a new trace for the asset or nullptr, if the tracer is not active
+		auto begin(const AID& aid, const std::string& type_name) -> std::shared_ptr<Load_trace>;
+		void finish(std::shared_ptr<Load_trace>);
+
+		auto traces() const -> std::vector<Load_trace>;
+		void write_chrome_trace(std::ostream&) const;
+
+	  private:
+		std::atomic<bool>       _active{false};
+		mutable std::mutex      _mutex;
+		Trace_clock::time_point _start;
+		std::vector<Load_trace> _traces;
+	};
+
+	namespace detail {
+		/// a small sequential id for the calling thread
+		extern auto trace_thread_id() noexcept -> std::uint32_t;
+
+		/// the accumulated time the calling thread spent reading asset files
+		extern auto thread_read_time() noexcept -> Trace_clock::duration;
+		extern void add_thread_read_time(Trace_clock::duration) noexcept;
+	} // namespace detail
+} // namespace mirrage::asset
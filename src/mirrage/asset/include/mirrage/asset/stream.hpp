@@ -41,6 +41,7 @@ namespace mirrage::asset {
 		auto length() const noexcept -> size_t;
 
 		auto  aid() const noexcept { return _aid; }
+		auto& path() const noexcept { return _path; }
 		auto& manager() noexcept { return _manager; }
 
 		void close();
@@ -48,6 +49,7 @@ namespace mirrage::asset {
 	  protected:
 		File_handle*   _file;
 		AID            _aid;
+		std::string    _path;
 		Asset_manager& _manager;
 
 		class fbuf;
@@ -80,13 +82,34 @@ namespace mirrage::asset {
 } // namespace mirrage::asset
 
 #ifdef ENABLE_SF2_ASSETS
+#include <mirrage/asset/binary_cache.hpp>
+
 #include <sf2/sf2.hpp>
 
 namespace mirrage::asset {
+	/// parses the JSON content of the stream into value and returns false on errors
+	template <class T>
+	auto read_json(istream& in, T& value) -> bool
+	{
+		auto success = true;
+		sf2::deserialize_json(
+		        in,
+		        [&](auto& msg, uint32_t row, uint32_t column) {
+			        success = false;
+			        LOG(plog::error) << "Error parsing JSON from " << in.aid().str() << " at " << row << ":"
+			                         << column << ": " << msg;
+		        },
+		        value);
+
+		return success;
+	}
+
 	/**
 	 * Specialize this template for each asset-type
 	 * Instances should be lightweight
 	 * Implementations should NEVER return nullptr
+	 * Loaders can define `static constexpr bool deduplicate_content = true` to share a single
+	 *   instance between all byte-identical files
 	 */
 	template <class T>
 	struct Loader {
@@ -96,15 +119,7 @@ namespace mirrage::asset {
 		static auto load(istream in) -> T
 		{
 			auto r = T();
-
-			sf2::deserialize_json(
-			        in,
-			        [&](auto& msg, uint32_t row, uint32_t column) {
-				        LOG(plog::error) << "Error parsing JSON from " << in.aid().str() << " at " << row
-				                         << ":" << column << ": " << msg;
-			        },
-			        r);
-
+			load_cached(in, r, [](istream& s, T& value) { return read_json(s, value); });
 			return r;
 		}
 		static void save(ostream out, const T& asset) { sf2::serialize_json(out, asset); }
@@ -118,6 +133,8 @@ namespace mirrage::asset {
 	 * Specialize this template for each asset-type
 	 * Instances should be lightweight
 	 * Implementations should NEVER return nullptr
+	 * Loaders can define `static constexpr bool deduplicate_content = true` to share a single
+	 *   instance between all byte-identical files
 	 */
 	template <class T>
 	struct Loader {
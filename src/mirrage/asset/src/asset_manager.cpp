@@ -6,11 +6,13 @@
 #include <mirrage/utils/log.hpp>
 #include <mirrage/utils/md5.hpp>
 #include <mirrage/utils/template_utils.hpp>
+#include <mirrage/utils/xxhash.hpp>
 
 #include <physfs.h>
 
 #include <cstdio>
 #include <cstring>
+#include <unordered_set>
 
 #ifdef _WIN32
 #include <direct.h>
@@ -191,12 +193,29 @@ namespace mirrage::asset {
 	}
 
 	const std::string default_archives_list_filename = "archives.lst";
+	const std::string dependency_manifest_filename   = "asset_dependencies.lst";
 
-	Asset_manager::Asset_manager(const std::string&       exe_name,
+	namespace detail {
+		namespace {
+			thread_local const AID* current_loading_aid = nullptr;
+		}
+
+		Loading_scope::Loading_scope(const AID& aid) noexcept : _parent(current_loading_aid)
+		{
+			current_loading_aid = &aid;
+		}
+		Loading_scope::~Loading_scope() { current_loading_aid = _parent; }
+
+		auto Loading_scope::current() noexcept -> const AID* { return current_loading_aid; }
+	} // namespace detail
+
+	Asset_manager::Asset_manager(util::job_system&        jobs,
+	                             const std::string&       exe_name,
 	                             const std::string&       org_name,
 	                             const std::string&       app_name,
 	                             util::maybe<std::string> additional_search_path,
 	                             const std::string&       archives_list_filename)
+	  : _jobs(jobs)
 	{
 		init_physicsfs(exe_name, additional_search_path);
 
@@ -286,10 +305,17 @@ namespace mirrage::asset {
 		additional_search_path.process([&](auto& dir) { PHYSFS_unmount(dir.c_str()); });
 
 		_reload_dispatchers();
+		_load_dependency_manifest();
 	}
 
 	Asset_manager::~Asset_manager()
 	{
+		try {
+			save_dependency_manifest();
+		} catch(std::exception& e) {
+			LOG(plog::warning) << "Couldn't write asset dependency manifest: " << e.what();
+		}
+
 		_containers.clear();
 		if(!PHYSFS_deinit()) {
 			MIRRAGE_FAIL(
@@ -420,8 +446,7 @@ namespace mirrage::asset {
 	auto Asset_manager::_resolve_unkown(const AID& id, bool only_preexisting) const
 	        -> util::maybe<std::string>
 	{
-		auto lock = std::shared_lock{_dispatchers_mutex};
-
+		// _dispatchers_mutex is already held by the caller (resolve)
 		auto dir = _general_dispatchers.find(id.type());
 
 		if(dir == _general_dispatchers.end())
@@ -454,8 +479,111 @@ namespace mirrage::asset {
 		return util::nothing;
 	}
 
+	void Asset_manager::save_dependency_manifest()
+	{
+		auto lock = std::scoped_lock{_dependencies_mutex};
+
+		if(!_dependencies_dirty)
+			return;
+
+		auto out = _open_rw(AID("cfg"_strid, dependency_manifest_filename), dependency_manifest_filename);
+		for(auto& [parent, children] : _dependencies) {
+			for(auto& child : children) {
+				out << parent.str() << '\t' << child.aid.str() << '\t' << child.type_name << '\n';
+			}
+		}
+
+		_dependencies_dirty = false;
+	}
+
 	void Asset_manager::_post_write() {}
 
+	void Asset_manager::_load_dependency_manifest()
+	{
+		if(!exists_file(dependency_manifest_filename))
+			return;
+
+		auto in = _open(AID("cfg"_strid, dependency_manifest_filename), dependency_manifest_filename);
+
+		auto lock = std::scoped_lock{_dependencies_mutex};
+		_dependencies.clear();
+
+		for(auto&& l : in.lines()) {
+			auto [parent, rest]     = util::split(l, "\t");
+			auto [child, type_name] = util::split(rest, "\t");
+
+			if(!parent.empty() && !child.empty() && !type_name.empty())
+				_dependencies[AID{parent}].push_back(Dependency{AID{child}, type_name});
+		}
+
+		LOG(plog::debug) << "Loaded " << _dependencies.size()
+		                 << " entries from the asset dependency manifest";
+	}
+
+	void Asset_manager::_add_dependency(const AID& parent, const AID& child, const std::string& type_name)
+	{
+		auto lock = std::scoped_lock{_dependencies_mutex};
+
+		auto& children = _dependencies[parent];
+		auto  known    = std::any_of(children.begin(), children.end(), [&](auto& d) {
+			return d.aid == child && d.type_name == type_name;
+		});
+
+		if(!known) {
+			children.push_back(Dependency{child, type_name});
+			_dependencies_dirty = true;
+		}
+	}
+
+	void Asset_manager::_prefetch_dependencies(const AID& id)
+	{
+		// collect the transitive closure of all known dependencies
+		auto closure = std::vector<Dependency>();
+		{
+			auto lock = std::scoped_lock{_dependencies_mutex};
+
+			if(_dependencies.find(id) == _dependencies.end())
+				return;
+
+			auto visited = std::unordered_set<AID>{id};
+			auto open    = std::vector<AID>{id};
+			while(!open.empty()) {
+				auto next = std::move(open.back());
+				open.pop_back();
+
+				util::find_maybe(_dependencies, next).process([&](auto& children) {
+					for(auto& child : children) {
+						if(visited.insert(child.aid).second) {
+							open.push_back(child.aid);
+							closure.push_back(child);
+						}
+					}
+				});
+			}
+		}
+
+		auto containers = std::vector<detail::Asset_container_base*>();
+		{
+			auto lock = std::scoped_lock{_containers_mutex};
+			containers.reserve(_containers.size());
+
+			for(auto& container : _containers) {
+				containers.emplace_back(container.second.get());
+			}
+		}
+
+		// start loading all of them at once, instead of waiting for the parent loaders to discover them
+		for(auto& dep : closure) {
+			auto container = std::find_if(containers.begin(), containers.end(), [&](auto* c) {
+				return c->type_name() == dep.type_name;
+			});
+			if(container == containers.end())
+				continue; // stateful loader has not been created, yet
+
+			resolve(dep.aid).process([&](auto& path) { (*container)->prefetch(dep.aid, path); });
+		}
+	}
+
 	void Asset_manager::_reload_dispatchers()
 	{
 		auto lock = std::unique_lock{_dispatchers_mutex};
@@ -490,6 +618,31 @@ namespace mirrage::asset {
 
 		return stat.modtime;
 	}
+	auto Asset_manager::_file_size(const std::string& path) const -> int64_t
+	{
+		auto stat = PHYSFS_Stat{};
+		if(!PHYSFS_stat(path.c_str(), &stat))
+			throw std::system_error(static_cast<Asset_error>(PHYSFS_getLastErrorCode()));
+
+		return stat.filesize;
+	}
+	auto Asset_manager::_content_hash(const std::string& path) const -> std::string
+	{
+		auto file = PHYSFS_openRead(path.c_str());
+		if(!file)
+			return {};
+
+		auto hasher = util::xxh3_hasher();
+		auto buffer = std::vector<char>(64 * 1024);
+		auto read   = PHYSFS_sint64(0);
+		while((read = PHYSFS_readBytes(file, buffer.data(), buffer.size())) > 0)
+			hasher.update(buffer.data(), static_cast<std::size_t>(read));
+
+		auto success = read == 0 && PHYSFS_eof(file);
+		PHYSFS_close(file);
+
+		return success ? util::to_hex(hasher.digest128()) : std::string();
+	}
 	auto Asset_manager::_open(const asset::AID& id, const std::string& path) -> istream
 	{
 		return {id, *this, path};
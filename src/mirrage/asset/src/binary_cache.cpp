@@ -0,0 +1,130 @@
+#include <mirrage/asset/binary_cache.hpp>
+
+#include <mirrage/asset/stream.hpp>
+
+#include <mirrage/utils/log.hpp>
+#include <mirrage/utils/md5.hpp>
+#include <mirrage/utils/random.hpp>
+
+#include <physfs.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+
+
+namespace mirrage::asset {
+
+	namespace {
+		std::atomic<bool> cache_enabled{true};
+
+		constexpr auto cache_dir     = "cache/json";
+		constexpr auto cache_magic   = std::uint32_t(0x4d424331); // "MBC1"
+		constexpr auto cache_version = std::uint32_t(2);
+
+		struct Cache_header {
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint64_t type_hash;
+			std::int64_t  source_modtime;
+			std::uint64_t source_size;
+			std::uint64_t payload_size;
+		};
+
+		auto source_stat(const istream& in) -> util::maybe<PHYSFS_Stat>
+		{
+			auto stat = PHYSFS_Stat{};
+			if(in.path().empty() || !PHYSFS_stat(in.path().c_str(), &stat))
+				return util::nothing;
+
+			return stat;
+		}
+
+		auto cache_path(const istream& in) -> util::maybe<std::string>
+		{
+			auto write_dir = PHYSFS_getWriteDir();
+			if(!write_dir)
+				return util::nothing;
+
+			return std::string(write_dir) + "/" + cache_dir + "/" + util::md5(in.path()) + ".bin";
+		}
+	} // namespace
+
+	void binary_cache_enabled(bool enabled) { cache_enabled = enabled; }
+	auto binary_cache_enabled() noexcept -> bool { return cache_enabled; }
+
+	namespace detail {
+		auto read_binary_cache(const istream& in, std::uint64_t type_hash) -> util::maybe<std::vector<char>>
+		{
+			auto stat = source_stat(in);
+			auto path = cache_path(in);
+			if(stat.is_nothing() || path.is_nothing())
+				return util::nothing;
+
+			auto file = std::ifstream(path.get_or_throw(), std::ios::binary | std::ios::ate);
+			if(!file)
+				return util::nothing;
+
+			auto file_size = std::uint64_t(file.tellg());
+			file.seekg(0);
+
+			auto header = Cache_header{};
+			if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+				return util::nothing;
+
+			auto& s = stat.get_or_throw();
+			if(header.magic != cache_magic || header.version != cache_version
+			   || header.type_hash != type_hash || header.source_modtime != s.modtime
+			   || header.source_size != std::uint64_t(s.filesize)
+			   || header.payload_size != file_size - sizeof(header))
+				return util::nothing;
+
+			auto data = std::vector<char>(header.payload_size);
+			if(!file.read(data.data(), std::streamsize(data.size())))
+				return util::nothing;
+
+			return data;
+		}
+
+		void write_binary_cache(const istream& in, std::uint64_t type_hash, const std::vector<char>& data)
+		{
+			auto stat = source_stat(in);
+			auto path = cache_path(in);
+			if(stat.is_nothing() || path.is_nothing())
+				return;
+
+			PHYSFS_mkdir(cache_dir);
+
+			auto& s               = stat.get_or_throw();
+			auto  header          = Cache_header{};
+			header.magic          = cache_magic;
+			header.version        = cache_version;
+			header.type_hash      = type_hash;
+			header.source_modtime = s.modtime;
+			header.source_size    = std::uint64_t(s.filesize);
+			header.payload_size   = std::uint64_t(data.size());
+
+			// written to a temporary file first, so other processes never observe partial entries;
+			//   the name is unique to the writer, because other threads might load the same file
+			thread_local auto random = util::construct_random_engine();
+
+			auto& target = path.get_or_throw();
+			auto  tmp    = target + "." + std::to_string(random()) + ".tmp";
+			{
+				auto file = std::ofstream(tmp, std::ios::binary | std::ios::trunc);
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				file.write(data.data(), std::streamsize(data.size()));
+				if(!file) {
+					LOG(plog::warning) << "Unable to write binary cache for " << in.aid().str();
+					return;
+				}
+			}
+
+			if(std::rename(tmp.c_str(), target.c_str()) != 0) {
+				LOG(plog::warning) << "Unable to write binary cache for " << in.aid().str();
+				std::remove(tmp.c_str());
+			}
+		}
+	} // namespace detail
+
+} // namespace mirrage::asset
@@ -0,0 +1,155 @@
+#include <mirrage/asset/load_trace.hpp>
+
+#include <mirrage/utils/string_utils.hpp>
+
+#include <ostream>
+
+
+namespace mirrage::asset {
+
+	namespace detail {
+		namespace {
+			thread_local auto read_time = Trace_clock::duration::zero();
+		}
+
+		auto trace_thread_id() noexcept -> std::uint32_t
+		{
+			static auto           next_id = std::atomic<std::uint32_t>(1);
+			thread_local const auto id    = next_id++;
+			return id;
+		}
+
+		auto thread_read_time() noexcept -> Trace_clock::duration { return read_time; }
+		void add_thread_read_time(Trace_clock::duration time) noexcept { read_time += time; }
+	} // namespace detail
+
+	namespace {
+		auto is_set(Trace_clock::time_point t) { return t != Trace_clock::time_point{}; }
+	} // namespace
+
+	void Load_trace::mark_io_start()
+	{
+		io_start    = Trace_clock::now();
+		load_thread = detail::trace_thread_id();
+	}
+	void Load_trace::mark_decode_start()
+	{
+		io_end = decode_start = Trace_clock::now();
+		read_time             = detail::thread_read_time();
+	}
+	void Load_trace::mark_decode_end()
+	{
+		decode_end = Trace_clock::now();
+		read_time  = detail::thread_read_time() - read_time;
+	}
+
+
+	void Load_tracer::start()
+	{
+		auto lock = std::scoped_lock{_mutex};
+		_traces.clear();
+		_start = Trace_clock::now();
+		_active.store(true);
+	}
+	void Load_tracer::stop() { _active.store(false); }
+
+	auto Load_tracer::begin(const AID& aid, const std::string& type_name) -> std::shared_ptr<Load_trace>
+	{
+		if(!active())
+			return {};
+
+		auto trace           = std::make_shared<Load_trace>();
+		trace->aid           = aid;
+		trace->type_name     = type_name;
+		trace->queued        = Trace_clock::now();
+		trace->queued_thread = detail::trace_thread_id();
+		return trace;
+	}
+	void Load_tracer::finish(std::shared_ptr<Load_trace> trace)
+	{
+		if(!trace)
+			return;
+
+		trace->ready        = Trace_clock::now();
+		trace->ready_thread = detail::trace_thread_id();
+
+		auto lock = std::scoped_lock{_mutex};
+		if(trace->queued >= _start)
+			_traces.emplace_back(std::move(*trace));
+	}
+
+	auto Load_tracer::traces() const -> std::vector<Load_trace>
+	{
+		auto lock = std::scoped_lock{_mutex};
+		return _traces;
+	}
+
+	void Load_tracer::write_chrome_trace(std::ostream& out) const
+	{
+		auto lock = std::scoped_lock{_mutex};
+
+		auto us = [&](Trace_clock::time_point t) {
+			return std::chrono::duration_cast<std::chrono::microseconds>(t - _start).count();
+		};
+		auto dur_us = [](Trace_clock::duration d) {
+			return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+		};
+
+		auto first = true;
+		auto event = [&](const char*             phase,
+		                 const std::string&      name,
+		                 std::uint32_t           tid,
+		                 Trace_clock::time_point ts) -> std::ostream& {
+			out << (first ? "\n" : ",\n");
+			first = false;
+
+			out << "{\"name\":\"";
+			util::write_json_escaped(out, name);
+			return out << "\",\"cat\":\"asset\",\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << tid
+			           << ",\"ts\":" << us(ts);
+		};
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		auto id = 0;
+		for(auto& trace : _traces) {
+			id++;
+
+			// the complete lifetime, from the request until the task is ready, as a nestable async span
+			//   and the work done by the loader thread as complete events
+			event("b", trace.aid.str(), trace.queued_thread, trace.queued)
+			        << ",\"id\":" << id << ",\"args\":{\"type\":\"";
+			util::write_json_escaped(out, trace.type_name);
+			out << "\"}}";
+
+			if(is_set(trace.io_start)) {
+				event("b", "queued", trace.queued_thread, trace.queued) << ",\"id\":" << id << "}";
+				event("e", "queued", trace.load_thread, trace.io_start) << ",\"id\":" << id << "}";
+
+				event("X", "open", trace.load_thread, trace.io_start)
+				        << ",\"dur\":" << dur_us(trace.io_end - trace.io_start) << ",\"args\":{\"aid\":\"";
+				util::write_json_escaped(out, trace.aid.str());
+				out << "\"}}";
+			}
+
+			if(is_set(trace.decode_end)) {
+				event("X", "decode", trace.load_thread, trace.decode_start)
+				        << ",\"dur\":" << dur_us(trace.decode_end - trace.decode_start)
+				        << ",\"args\":{\"aid\":\"";
+				util::write_json_escaped(out, trace.aid.str());
+				out << "\",\"read_us\":" << dur_us(trace.read_time)
+				    << ",\"parse_us\":" << dur_us(trace.decode_end - trace.decode_start - trace.read_time)
+				    << "}}";
+
+				// waiting for dependencies and asynchronous work (e.g. GPU uploads) started by the loader
+				event("b", "finish", trace.load_thread, trace.decode_end) << ",\"id\":" << id << "}";
+				event("e", "finish", trace.ready_thread, trace.ready) << ",\"id\":" << id << "}";
+			}
+
+			event("e", trace.aid.str(), trace.ready_thread, trace.ready) << ",\"id\":" << id << "}";
+		}
+
+		out << "\n]}\n";
+	}
+
+} // namespace mirrage::asset
@@ -2,6 +2,7 @@
 
 #include <mirrage/asset/asset_manager.hpp>
 #include <mirrage/asset/error.hpp>
+#include <mirrage/asset/load_trace.hpp>
 
 #include <mirrage/utils/log.hpp>
 #include <mirrage/utils/string_utils.hpp>
@@ -23,7 +24,9 @@ namespace mirrage::asset {
 			if(PHYSFS_eof(file)) {
 				return traits_type::eof();
 			}
+			auto start     = Trace_clock::now();
 			auto bytesRead = PHYSFS_readBytes(file, buffer.data(), bufferSize);
+			detail::add_thread_read_time(Trace_clock::now() - start);
 			if(bytesRead < 1) {
 				return traits_type::eof();
 			}
@@ -110,7 +113,7 @@ namespace mirrage::asset {
 	};
 
 	stream::stream(AID aid, Asset_manager& manager, File_handle* file, const std::string& path)
-	  : _file(file), _aid(aid), _manager(manager), _fbuf(std::make_unique<fbuf>(file))
+	  : _file(file), _aid(aid), _path(path), _manager(manager), _fbuf(std::make_unique<fbuf>(file))
 	{
 
 		if(file == nullptr) {
@@ -120,7 +123,11 @@ namespace mirrage::asset {
 	}
 
 	stream::stream(stream&& o)
-	  : _file(o._file), _aid(std::move(o._aid)), _manager(o._manager), _fbuf(std::move(o._fbuf))
+	  : _file(o._file)
+	  , _aid(std::move(o._aid))
+	  , _path(std::move(o._path))
+	  , _manager(o._manager)
+	  , _fbuf(std::move(o._fbuf))
 	{
 		o._file = nullptr;
 	}
@@ -138,6 +145,7 @@ namespace mirrage::asset {
 		MIRRAGE_INVARIANT(&_manager == &rhs._manager, "cross-manager move");
 		_file = std::move(rhs._file);
 		_aid  = std::move(rhs._aid);
+		_path = std::move(rhs._path);
 		_fbuf = std::move(rhs._fbuf);
 		return *this;
 	}
@@ -201,7 +209,9 @@ namespace mirrage::asset {
 	void istream::read_direct(char* target, std::size_t size)
 	{
 		seekg(0, cur);
+		auto start = Trace_clock::now();
 		PHYSFS_readBytes(reinterpret_cast<PHYSFS_File*>(_file), target, size);
+		detail::add_thread_read_time(Trace_clock::now() - start);
 	}
 
 
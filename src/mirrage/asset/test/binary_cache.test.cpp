@@ -0,0 +1,77 @@
+#include <mirrage/asset/binary_cache.hpp>
+
+#include <mirrage/asset/asset_manager.hpp>
+#include <mirrage/utils/job_system.hpp>
+
+#include <doctest.h>
+
+#include <string>
+#include <vector>
+
+using namespace mirrage;
+
+namespace {
+	struct Test_texture {
+	};
+
+	/// shaped like the particle configs: the handle is resolved by the loader from the stored AID
+	struct Test_particle_config {
+		std::vector<float> keyframes;
+		float              size = 1.f;
+
+		std::string              texture_id;
+		asset::Ptr<Test_texture> texture;
+	};
+	sf2_structDef(Test_particle_config, keyframes, size, texture_id);
+
+	/// the Asset_manager is set up with the assets of the engine, the test file is created in its write dir
+	constexpr auto test_assets = MIRRAGE_ASSET_TEST_ASSETS;
+} // namespace
+
+TEST_CASE("Aggregates with asset handles are cached without the handle.")
+{
+	static_assert(asset::detail::is_binary_cacheable<Test_particle_config>());
+
+	auto jobs   = util::job_system(0);
+	auto assets = asset::Asset_manager(jobs, "", "mirrage", "asset_tests", std::string(test_assets));
+	auto aid    = asset::AID("cfg"_strid, "binary_cache_test.json");
+
+	auto source       = Test_particle_config{};
+	source.keyframes  = {0.f, 0.5f, 1.f};
+	source.size       = 2.f;
+	source.texture_id = "tex:particle";
+	{
+		auto out = assets.open_rw(aid);
+		sf2::serialize_json(out, source);
+	}
+
+	auto parsed = 0;
+	auto load   = [&] {
+		// a handle from a previous load, that has to be reset instead of being kept
+		auto value    = Test_particle_config{};
+		value.texture = asset::make_ready_asset(asset::AID("tex"_strid, "stale"), Test_texture{});
+
+		auto in = assets.open(aid).get_or_throw();
+		asset::load_cached(in, value, [&](asset::istream& s, Test_particle_config& v) {
+			parsed++;
+			v.texture = {};
+			return asset::read_json(s, v);
+		});
+		return value;
+	};
+
+	// the first load might already be served by the cache entry of a previous run
+	auto first          = load();
+	auto parsed_initial = parsed;
+	CHECK(parsed_initial <= 1);
+
+	auto second = load();
+	CHECK(parsed == parsed_initial);
+
+	for(auto& v : {first, second}) {
+		CHECK(v.keyframes == source.keyframes);
+		CHECK(v.size == source.size);
+		CHECK(v.texture_id == source.texture_id);
+		CHECK_FALSE(v.texture);
+	}
+}
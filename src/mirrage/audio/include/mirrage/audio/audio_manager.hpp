@@ -109,6 +109,8 @@ namespace mirrage::asset {
 
 	template <>
 	struct Loader<mirrage::audio::Sample> {
+		static constexpr bool deduplicate_content = true;
+
 		static auto load(istream in) -> mirrage::audio::Sample;
 		static void save(ostream out, const mirrage::audio::Sample& asset)
 		{
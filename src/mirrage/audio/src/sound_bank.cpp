@@ -1,5 +1,7 @@
 #include <mirrage/audio/sound_bank.hpp>
 
+#include <mirrage/asset/binary_cache.hpp>
+
 
 namespace mirrage::audio {
 
@@ -41,13 +43,18 @@ namespace mirrage::asset {
 
 	auto Loader<mirrage::audio::Sound_bank>::load(istream in) -> mirrage::audio::Sound_bank
 	{
-		auto on_error = [&](auto& msg, uint32_t row, uint32_t column) {
-			LOG(plog::error) << "Error parsing JSON from " << in.aid().str() << " at " << row << ":" << column
-			                 << ": " << msg;
-		};
-
 		auto cfg = std::unordered_map<std::string, std::vector<Sound_effect_config>>{};
-		sf2::JsonDeserializer{sf2::format::Json_reader{in, on_error}, on_error}.read_value(cfg);
+		load_cached(in, cfg, [](istream& s, auto& value) {
+			auto success  = true;
+			auto on_error = [&](auto& msg, uint32_t row, uint32_t column) {
+				success = false;
+				LOG(plog::error) << "Error parsing JSON from " << s.aid().str() << " at " << row << ":"
+				                 << column << ": " << msg;
+			};
+
+			sf2::JsonDeserializer{sf2::format::Json_reader{s, on_error}, on_error}.read_value(value);
+			return success;
+		});
 
 		auto bank = mirrage::audio::Sound_bank{};
 		for(auto&& [key, val] : cfg) {
@@ -44,7 +44,8 @@ namespace mirrage {
 	}
 	namespace util {
 		class Console_command_container;
-	}
+		class job_system;
+	} // namespace util
 	class Translator;
 	struct Engine_event_filter;
 
@@ -74,6 +75,8 @@ namespace mirrage {
 		auto& graphics_context() const noexcept { return *_graphics_context; }
 		auto& window() noexcept { return _graphics_main_window.get_or_throw("No window created!"); }
 		auto& window() const noexcept { return _graphics_main_window.get_or_throw("No window created!"); }
+		auto& jobs() noexcept { return *_jobs; }
+		auto& jobs() const noexcept { return *_jobs; }
 		auto& assets() noexcept { return *_asset_manager; }
 		auto& assets() const noexcept { return *_asset_manager; }
 		auto& input() noexcept { return *_input_manager; }
@@ -95,9 +98,12 @@ namespace mirrage {
 			~Sdl_wrapper();
 		};
 
+		using Job_system_ptr = std::unique_ptr<util::job_system, void (*)(util::job_system*)>;
+
 		bool                                  _quit = false;
 		Screen_manager                        _screens;
 		util::Message_bus                     _bus;
+		Job_system_ptr                        _jobs;
 		std::unique_ptr<asset::Asset_manager> _asset_manager;
 		std::unique_ptr<Translator>           _translator;
 		Sdl_wrapper                           _sdl;
@@ -12,6 +12,7 @@
 #include <mirrage/asset/asset_manager.hpp>
 #include <mirrage/gui/debug_ui.hpp>
 #include <mirrage/info.hpp>
+#include <mirrage/utils/async_log_appender.hpp>
 #include <mirrage/utils/maybe.hpp>
 
 #include <doctest.h>
@@ -70,12 +71,18 @@ namespace mirrage {
 
 			const auto write_dir = asset::write_dir(argv[0], org_name, app_name, base_dir);
 
-			static auto fileAppender = plog::RollingFileAppender<plog::TxtFormatter>(
+			static auto fileAppender = plog::RollingFileAppender<util::log_formatter>(
 			        (write_dir + "/mirrage.log").c_str(), 1024L * 1024L, 4);
-			static auto consoleAppender = plog::ColorConsoleAppender<plog::TxtFormatter>();
-			plog::init(plog::debug, &fileAppender)
-			        .addAppender(&consoleAppender)
-			        .addAppender(&gui::debug_console_appender());
+			static auto consoleAppender = plog::ColorConsoleAppender<util::log_formatter>();
+			auto&       debugAppender   = gui::debug_console_appender();
+
+			// formatting and I/O are done on a background thread. Has to be constructed after the other
+			//   appenders, so it's destroyed (and flushed) before them
+			static auto asyncAppender = util::async_log_appender();
+			asyncAppender.add_appender(&fileAppender)
+			        .add_appender(&consoleAppender)
+			        .add_appender(&debugAppender);
+			plog::init(plog::debug, &asyncAppender);
 
 			LOG(plog::debug) << "\n"
 			                 << app_name << " by " << org_name << " V" << version_major << "."
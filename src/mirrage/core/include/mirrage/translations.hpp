@@ -9,6 +9,8 @@
 
 #include <mirrage/asset/asset_manager.hpp>
 
+#include <mirrage/utils/interned_str.hpp>
+
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -21,8 +23,8 @@ namespace mirrage {
 	using Language_id = std::string;
 
 	struct Localisation_data {
-		using Translation_table = std::unordered_map<std::string, std::string>;
-		using Category_table    = std::unordered_map<Category_id, Translation_table>;
+		using Translation_table = std::unordered_map<util::Interned_str, std::string>;
+		using Category_table    = std::unordered_map<util::Interned_str, Translation_table>;
 
 		Category_table categories;
 	};
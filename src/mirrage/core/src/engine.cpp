@@ -9,11 +9,16 @@
 #include <mirrage/net/net_manager.hpp>
 #include <mirrage/translations.hpp>
 #include <mirrage/utils/console_command.hpp>
+#include <mirrage/utils/cpu_profiler.hpp>
+#include <mirrage/utils/job_system.hpp>
 #include <mirrage/utils/log.hpp>
 #include <mirrage/utils/time.hpp>
 #include <mirrage/utils/units.hpp>
 
+#include <async++.h>
+
 #include <chrono>
+#include <fstream>
 #include <stdexcept>
 
 #ifdef _WIN32
@@ -41,6 +46,38 @@ namespace mirrage {
 		auto interruptRequested = false;
 		void sigIntHandler(int s) { interruptRequested = true; }
 
+		// async++ only accepts a plain function pointer as wait handler
+		util::job_system*   helping_job_system   = nullptr;
+		async::wait_handler default_wait_handler = nullptr;
+
+		/// executes pending jobs while the thread waits for an async++ task (e.g. asset loads, parallel_for)
+		/// the wait handle doesn't know the scheduler of the task, so only jobs that are at least as
+		///   important as the waiting one (or normal on the main thread) are executed
+		void help_while_waiting(async::task_wait_handle task)
+		{
+			helping_job_system->help_until([&] { return task.ready(); },
+			                               helping_job_system->current_priority());
+		}
+
+		auto create_job_system()
+		{
+			auto jobs = new util::job_system(util::job_system::default_worker_count(), [](std::size_t) {
+				async::set_thread_wait_handler(help_while_waiting);
+			});
+
+			helping_job_system   = jobs;
+			default_wait_handler = async::set_thread_wait_handler(help_while_waiting);
+
+			return jobs;
+		}
+		void destroy_job_system(util::job_system* jobs)
+		{
+			// the remaining jobs are executed during the destruction and might still wait for each other
+			delete jobs;
+			async::set_thread_wait_handler(default_wait_handler);
+			helping_job_system = nullptr;
+		}
+
 	} // namespace
 
 	using namespace util::unit_literals;
@@ -99,8 +136,9 @@ namespace mirrage {
 	               const std::string& archives_list_filename,
 	               bool               headless)
 	  : _screens(*this)
+	  , _jobs(create_job_system(), &destroy_job_system)
 	  , _asset_manager(std::make_unique<asset::Asset_manager>(
-	            argc > 0 ? argv[0] : "", org, title, base_dir, archives_list_filename))
+	            *_jobs, argc > 0 ? argv[0] : "", org, title, base_dir, archives_list_filename))
 	  , _translator(std::make_unique<Translator>(*_asset_manager))
 	  , _sdl(headless)
 	  , _graphics_context(headless ? std::unique_ptr<graphic::Context>()
@@ -142,6 +180,37 @@ namespace mirrage {
 			        LOG(plog::info) << "Open Screens: " << screen_list;
 		        });
 
+		_console_commands->add("assets.trace.start | Starts recording the timeline of all asset loads",
+		                       [&]() { assets().load_tracer().start(); });
+
+		_console_commands->add(
+		        "assets.trace.save <file> | Stops recording asset loads and writes them as a Chrome trace "
+		        "(chrome://tracing)",
+		        [&](std::string file) {
+			        auto& tracer = assets().load_tracer();
+			        tracer.stop();
+
+			        auto out = std::ofstream(file);
+			        tracer.write_chrome_trace(out);
+			        LOG(plog::info) << "Wrote asset load trace to " << file;
+		        });
+
+		_console_commands->add("profiler.cpu.start | Starts recording all instrumented CPU zones",
+		                       [&]() { util::cpu_profiler::start_capture(); });
+
+		_console_commands->add(
+		        "profiler.cpu.save <file> | Stops recording CPU zones and writes them as a Chrome trace "
+		        "(chrome://tracing, ui.perfetto.dev)",
+		        [&](std::string file) {
+			        util::cpu_profiler::stop_capture();
+
+			        auto out = std::ofstream(file);
+			        util::cpu_profiler::write_chrome_trace(out);
+			        LOG(plog::info) << "Wrote CPU profile to " << file;
+		        });
+
+		util::cpu_profiler::set_thread_name("main");
+
 		if(headless) {
 #ifdef _WIN32
 			// TODO
@@ -200,6 +269,10 @@ namespace mirrage {
 
 	void Engine::on_frame()
 	{
+		// collect the zones of the previous frame, before the first zone of this one is opened
+		util::cpu_profiler::end_frame();
+		MIRRAGE_PROFILE_ZONE("Engine::on_frame");
+
 		_last_time               = _current_time;
 		_current_time            = util::current_time_sec();
 		auto delta_time          = std::max(0.f, static_cast<float>(_current_time - _last_time));
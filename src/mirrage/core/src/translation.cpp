@@ -1,5 +1,7 @@
 #include <mirrage/translations.hpp>
 
+#include <mirrage/asset/binary_cache.hpp>
+
 #include <sf2/sf2.hpp>
 
 #include <locale>
@@ -44,15 +46,26 @@ namespace mirrage {
 		{
 			auto r = Localisation_data{};
 
-			auto on_error = [&](auto& msg, uint32_t row, uint32_t column) {
-				LOG(plog::error) << "Error parsing JSON from " << in.aid().str() << " at " << row << ":"
-				                 << column << ": " << msg;
-			};
-
-			sf2::JsonDeserializer reader{sf2::format::Json_reader{in, on_error}, on_error};
-			reader.read_lambda([&](auto& category) {
-				reader.read_value(r.categories[category]);
-				return true;
+			load_cached(in, r, [](istream& s, Localisation_data& value) {
+				auto success  = true;
+				auto on_error = [&](auto& msg, uint32_t row, uint32_t column) {
+					success = false;
+					LOG(plog::error) << "Error parsing JSON from " << s.aid().str() << " at " << row << ":"
+					                 << column << ": " << msg;
+				};
+
+				sf2::JsonDeserializer reader{sf2::format::Json_reader{s, on_error}, on_error};
+				reader.read_lambda([&](auto& category) {
+					auto translations = std::unordered_map<std::string, std::string>();
+					reader.read_value(translations);
+
+					auto& table = value.categories[util::Interned_str(category)];
+					for(auto& [key, text] : translations)
+						table.emplace(util::Interned_str(key), std::move(text));
+
+					return true;
+				});
+				return success;
 			});
 
 			return r;
@@ -131,13 +144,16 @@ namespace mirrage {
 	auto Translator::translate(const Category_id& category, const std::string& str) const
 	        -> const std::string&
 	{
+		auto category_key = util::Interned_str::hashed(category);
+		auto key          = util::Interned_str::hashed(str);
+
 		for(auto& f : _files) {
-			auto cat_iter = f->categories.find(category);
+			auto cat_iter = f->categories.find(category_key);
 
 			if(cat_iter == f->categories.end())
 				continue;
 
-			auto iter = cat_iter->second.find(str);
+			auto iter = cat_iter->second.find(key);
 			if(iter == cat_iter->second.end()) {
 				if(_missing_translations.emplace(category, str).second) {
 					LOG(plog::warning) << "Missing translation for language '" << _language << "' "
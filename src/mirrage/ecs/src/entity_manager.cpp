@@ -5,6 +5,7 @@
 
 #include <mirrage/ecs/components/transform_comp.hpp>
 
+#include <mirrage/utils/cpu_profiler.hpp>
 #include <mirrage/utils/log.hpp>
 #include <mirrage/utils/string_utils.hpp>
 
@@ -92,6 +93,8 @@ namespace mirrage::ecs {
 
 	void Entity_manager::process_queued_actions()
 	{
+		MIRRAGE_PROFILE_ZONE("Entity_manager::process_queued_actions");
+
 		MIRRAGE_INVARIANT(_local_queue_erase.empty(),
 		                  "Someone's been sleeping in my bed! (_local_queue_erase is dirty)");
 
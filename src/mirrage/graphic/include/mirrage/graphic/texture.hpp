@@ -183,6 +183,8 @@ namespace mirrage::asset {
 	template <graphic::Image_type Type>
 	struct Loader<graphic::Texture<Type>> {
 	  public:
+		static constexpr bool deduplicate_content = true;
+
 		Loader(graphic::Device& device, std::uint32_t owner_qfamily)
 		  : _device(device), _owner_qfamily(owner_qfamily)
 		{
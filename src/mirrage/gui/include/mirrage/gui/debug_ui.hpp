@@ -14,7 +14,9 @@
 #include <imgui.h>
 
 #include <iostream>
+#include <mutex>
 #include <unordered_set>
+#include <vector>
 
 
 namespace mirrage::gui {
@@ -22,6 +24,8 @@ namespace mirrage::gui {
 	class Gui;
 	class Debug_ui;
 
+	/// write() is called by the thread of the async log appender, so the received messages are only
+	///   moved to the console by Debug_ui::draw() on the main thread
 	class Debug_console_appender : public plog::IAppender {
 	  public:
 		void write(const plog::Record& record) override;
@@ -34,7 +38,11 @@ namespace mirrage::gui {
 			Msg(plog::Severity s, std::string msg) : severity(s), msg(std::move(msg)) {}
 		};
 
-		std::vector<Msg> _messages;
+		std::mutex       _received_mutex;
+		std::vector<Msg> _received;
+		std::vector<Msg> _messages; //< only accessed by the main thread
+
+		void _take_received();
 	};
 	inline auto& debug_console_appender()
 	{
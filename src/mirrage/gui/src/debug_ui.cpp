@@ -3,11 +3,14 @@
 #include <mirrage/gui/gui.hpp>
 
 #include <mirrage/input/events.hpp>
+#include <mirrage/utils/async_log_appender.hpp>
 #include <mirrage/utils/console_command.hpp>
 #include <mirrage/utils/ranges.hpp>
 
 #include <imgui.h>
 
+#include <iterator>
+
 
 template <class = void>
 void quick_exit(int) noexcept
@@ -42,22 +45,31 @@ namespace mirrage::gui {
 	{
 		auto msg =
 #ifdef _WIN32
-		        plog::util::toNarrow(plog::TxtFormatter::format(record), 0);
+		        plog::util::toNarrow(util::log_formatter::format(record), 0);
 #else
-		        plog::TxtFormatter::format(record);
+		        util::log_formatter::format(record);
 #endif
+		auto lock     = std::scoped_lock{_received_mutex};
 		auto prev_pos = std::string::size_type(0);
 		auto pos      = std::string::size_type(0);
 		while((pos = msg.find("\n", prev_pos)) != std::string::npos) {
 			auto len = pos - prev_pos + 1;
 			if(len > 0)
-				_messages.emplace_back(record.getSeverity(),
+				_received.emplace_back(record.getSeverity(),
 				                       prev_pos == 0 ? msg.substr(prev_pos, pos - prev_pos)
 				                                     : "    " + msg.substr(prev_pos, pos - prev_pos));
 
 			prev_pos = pos + 1;
 		}
 	}
+	void Debug_console_appender::_take_received()
+	{
+		auto lock = std::scoped_lock{_received_mutex};
+		_messages.insert(_messages.end(),
+		                 std::make_move_iterator(_received.begin()),
+		                 std::make_move_iterator(_received.end()));
+		_received.clear();
+	}
 
 
 	Debug_ui::Debug_ui(asset::Asset_manager& assets, Gui& gui, util::Message_bus& bus)
@@ -155,6 +167,7 @@ namespace mirrage::gui {
 	void Debug_ui::draw()
 	{
 		_mailbox.update_subscriptions();
+		debug_console_appender()._take_received();
 
 		for(auto& dm : _shown_debug_menus) {
 			Debug_menu::draw_all(dm, _gui);
@@ -0,0 +1,80 @@
+#include <mirrage/net/client.hpp>
+#include <mirrage/net/loopback.hpp>
+#include <mirrage/net/net_manager.hpp>
+#include <mirrage/net/server.hpp>
+
+#include <mirrage/utils/benchmark.hpp>
+
+#include <enet/enet.h>
+
+#include <string>
+#include <vector>
+
+using namespace mirrage;
+using namespace mirrage::util;
+
+namespace {
+	/// number of packets sent between two polls, i.e. per simulated frame
+	constexpr auto packets_per_poll = std::size_t(64);
+	constexpr auto packet_size      = std::size_t(200);
+
+	auto run(const char* name, const util::maybe<net::Network_conditions>& conditions)
+	{
+		auto channels = net::Channel_def_builder{}
+		                        .channel("reliable"_strid, net::Channel_type::reliable)
+		                        .channel("unreliable"_strid, net::Channel_type::unreliable)
+		                        .build();
+
+		auto network        = net::Loopback_network();
+		auto server_builder = net::Server::on_loopback(network, 4242, channels);
+		auto client_builder = net::Client_builder(network, 4242, channels);
+		conditions.process([&](auto& c) {
+			server_builder.network_conditions(c);
+			client_builder.network_conditions(c);
+		});
+
+		auto server = server_builder.create();
+		auto client = client_builder.connect();
+		while(!server.connected() || !client.connected()) {
+			server.poll([](auto&&...) {});
+			client.poll([](auto&&...) {});
+		}
+
+		auto data = std::vector<gsl::byte>(packet_size);
+
+		for(auto channel : {"reliable"_strid, "unreliable"_strid}) {
+			auto out      = client.channel(channel);
+			auto sent     = std::size_t(0);
+			auto received = std::size_t(0);
+
+			auto ns = benchmark::measure([&](std::size_t n) {
+				for(auto i = std::size_t(0); i < n; i += packets_per_poll) {
+					for(auto j = std::size_t(0); j < packets_per_poll; j++)
+						out.send(data);
+
+					sent += packets_per_poll;
+					client.poll([](auto&&...) {});
+					server.poll([&](auto&&...) { received++; });
+				}
+			});
+
+			benchmark::report(std::string(name) + " " + channel.str(),
+			                  ns,
+			                  "received=" + std::to_string(double(received) / double(sent)));
+		}
+	}
+} // namespace
+
+MIRRAGE_BENCHMARK(loopback_transport)
+{
+	auto manager = net::Net_manager();
+
+	run("loopback", util::nothing);
+
+	// without latency, so the conditioner has to keep up with the sender
+	auto conditions        = net::Network_conditions{};
+	conditions.loss        = 0.05f;
+	conditions.duplication = 0.01f;
+	conditions.seed        = 42;
+	run("conditioned", conditions);
+}
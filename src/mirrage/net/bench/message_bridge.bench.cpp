@@ -0,0 +1,189 @@
+#include <mirrage/net/client.hpp>
+#include <mirrage/net/message_bridge.hpp>
+#include <mirrage/net/net_manager.hpp>
+#include <mirrage/net/server.hpp>
+
+#include <mirrage/utils/benchmark.hpp>
+#include <mirrage/utils/messagebus.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace mirrage;
+using namespace mirrage::util;
+
+namespace {
+	constexpr auto port         = std::uint16_t(47621);
+	constexpr auto channel_name = "bench"_strid;
+
+	/// typical small gameplay message
+	struct Entity_moved {
+		std::uint32_t entity;
+		std::int32_t  x;
+		std::int32_t  y;
+		std::int32_t  z;
+		std::int16_t  yaw;
+	};
+
+	constexpr auto messages = net::Message_types<Entity_moved>{};
+
+	/// one of many message types, to measure the dispatch of bridges that receive dozens of types
+	template <int N>
+	struct Numbered_msg {
+		std::int32_t value;
+	};
+
+	template <int... Ns>
+	constexpr auto numbered_messages(std::integer_sequence<int, Ns...>)
+	{
+		return net::Message_types<Numbered_msg<Ns>...>{};
+	}
+
+	void ignore_packet(Str_id, net::Client_handle, gsl::span<const gsl::byte>) {}
+
+	/// a server and a client connected over localhost, that counts the received messages and packets
+	struct Loopback {
+		net::Net_manager         manager;
+		net::Channel_definitions channels;
+		net::Server              server;
+		net::Client              client;
+		Message_bus              tx_bus;
+		Message_bus              rx_bus;
+		net::Message_bridge      rx_bridge;
+		Mailbox_collection       rx_mailbox;
+		std::size_t              received_messages = 0;
+		std::size_t              received_packets  = 0;
+
+		Loopback()
+		  : channels(net::Channel_def_builder{}.channel(channel_name, net::Channel_type::reliable).build())
+		  , server(net::Server::on_named_interface("localhost", port, channels).create())
+		  , client(net::Client_builder("localhost", port, channels).connect())
+		  , rx_bridge(rx_bus, client, channel_name)
+		  , rx_mailbox(rx_bus)
+		{
+			rx_mailbox.subscribe<Entity_moved>([&](const Entity_moved&) { received_messages++; });
+
+			auto timeout = benchmark::Clock::now() + std::chrono::seconds(5);
+			while(!client.connected() || !server.connected()) {
+				if(benchmark::Clock::now() > timeout)
+					MIRRAGE_FAIL("Couldn't connect to the benchmark server on port " << port);
+
+				server.poll(ignore_packet);
+				client.poll(ignore_packet);
+			}
+		}
+
+		/// sends n messages in ticks of tick_size and waits until all of them have been received
+		template <typename F>
+		void run(std::size_t n, std::size_t tick_size, F&& end_tick)
+		{
+			for(auto sent = std::size_t(0); sent < n; sent += tick_size) {
+				auto count = std::min(tick_size, n - sent);
+				for(auto i = std::size_t(0); i < count; i++)
+					tx_bus.send<Entity_moved>(std::uint32_t(i), 1, 2, 3, std::int16_t(4));
+
+				end_tick();
+
+				auto target = received_messages + count;
+				while(received_messages < target) {
+					server.poll(ignore_packet);
+					client.poll([&](auto&&... packet) {
+						received_packets++;
+						rx_bridge.on_packet(messages, packet...);
+					});
+					rx_mailbox.update_subscriptions();
+				}
+			}
+		}
+
+		template <typename F>
+		void measure(const std::string& name, std::size_t tick_size, F&& end_tick)
+		{
+			auto total_messages = std::size_t(0);
+			auto packets_before = received_packets;
+
+			auto ns = benchmark::measure([&](std::size_t n) {
+				run(n, tick_size, end_tick);
+				total_messages += n;
+			});
+
+			auto packets_per_tick = double(received_packets - packets_before) * double(tick_size)
+			                        / double(std::max(total_messages, std::size_t(1)));
+
+			benchmark::report(name + " tick=" + std::to_string(tick_size),
+			                  ns,
+			                  "packets/tick=" + std::to_string(packets_per_tick));
+		}
+	};
+} // namespace
+
+MIRRAGE_BENCHMARK(message_bridge_loopback)
+{
+	auto loopback = Loopback();
+
+	for(auto tick_size : {std::size_t(1), std::size_t(16), std::size_t(256)}) {
+		{
+			// previous behaviour: one packet per message
+			auto channel = loopback.server.broadcast_channel(channel_name);
+			auto mailbox = Mailbox_collection(loopback.tx_bus);
+			mailbox.subscribe<Entity_moved>([&](const Entity_moved& msg) {
+				auto size = net::detail::calculate_size(msg);
+				channel.send(net::detail::msg_header_size(size) + size, [&](auto data) {
+					auto out = net::Bit_writer(data);
+					out.write(0, 16);
+					out.write(net::detail::type_hash<Entity_moved>, 16);
+					out.write_varint(size);
+					net::detail::write_obj(msg, out);
+					out.flush();
+				});
+			});
+
+			loopback.measure("packet per message", tick_size, [&] { mailbox.update_subscriptions(); });
+		}
+		{
+			auto bridge = net::Message_bridge(loopback.tx_bus, loopback.server, channel_name);
+			bridge.register_msg_types(messages);
+
+			loopback.measure("Message_bridge", tick_size, [&] { bridge.pump(); });
+		}
+	}
+}
+
+MIRRAGE_BENCHMARK(message_bridge_dispatch)
+{
+	constexpr auto messages_per_packet = std::size_t(64);
+
+	auto loopback = Loopback();
+
+	auto measure = [&](const std::string& name, auto types, std::uint16_t type_count) {
+		// ids spread over all registered types; all Numbered_msg have the same type-hash
+		auto packet = std::vector<gsl::byte>();
+		auto msg    = Numbered_msg<0>{42};
+		auto size   = net::detail::calculate_size(msg);
+		for(auto i = std::size_t(0); i < messages_per_packet; i++) {
+			auto offset = packet.size();
+			packet.resize(offset + net::detail::msg_header_size(size) + size);
+
+			auto out = net::Bit_writer(gsl::span<gsl::byte>(packet).subspan(std::ptrdiff_t(offset)));
+			out.write((i * 7) % type_count, 16);
+			out.write(net::detail::type_hash<Numbered_msg<0>>, 16);
+			out.write_varint(size);
+			net::detail::write_obj(msg, out);
+			out.flush();
+		}
+
+		auto ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i += messages_per_packet)
+				loopback.rx_bridge.on_packet(types, channel_name, nullptr, packet);
+		});
+
+		benchmark::report(name + " types=" + std::to_string(type_count), ns);
+	};
+
+	measure("on_packet", numbered_messages(std::make_integer_sequence<int, 1>{}), 1);
+	measure("on_packet", numbered_messages(std::make_integer_sequence<int, 8>{}), 8);
+	measure("on_packet", numbered_messages(std::make_integer_sequence<int, 48>{}), 48);
+}
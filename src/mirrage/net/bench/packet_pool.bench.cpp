@@ -0,0 +1,65 @@
+#include <mirrage/net/net_manager.hpp>
+
+#include <mirrage/utils/benchmark.hpp>
+
+#include <enet/enet.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace mirrage;
+using namespace mirrage::util;
+
+namespace {
+	/// number of packets that are alive at the same time, e.g. queued for sending
+	constexpr auto packets_in_flight = std::size_t(64);
+	constexpr std::size_t packet_sizes[] = {16, 200, 1200};
+} // namespace
+
+MIRRAGE_BENCHMARK(packet_pool)
+{
+	auto manager = net::Net_manager();
+
+	auto packets = std::vector<ENetPacket*>(packets_in_flight);
+	auto blocks  = std::vector<void*>(packets_in_flight * 2);
+
+	for(auto size : packet_sizes) {
+		// what enet_packet_create/destroy cost before: two malloc/free pairs per packet
+		auto ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i += packets_in_flight) {
+				for(auto j = std::size_t(0); j < packets_in_flight; j++) {
+					blocks[j * 2]     = std::malloc(sizeof(ENetPacket));
+					blocks[j * 2 + 1] = std::malloc(size);
+					benchmark::do_not_optimize(blocks[j * 2 + 1]);
+				}
+				for(auto block : blocks)
+					std::free(block);
+			}
+		});
+		benchmark::report("malloc size=" + std::to_string(size), ns);
+
+		auto before = net::Net_manager::allocation_stats();
+
+		ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i += packets_in_flight) {
+				for(auto& p : packets) {
+					p = enet_packet_create(nullptr, size, ENET_PACKET_FLAG_UNSEQUENCED);
+					benchmark::do_not_optimize(p->data);
+				}
+				for(auto p : packets)
+					enet_packet_destroy(p);
+			}
+		});
+
+		auto after = net::Net_manager::allocation_stats();
+
+		auto system_per_packet = double(after.system_allocations - before.system_allocations)
+		                         / double(std::max(after.allocations - before.allocations, std::uint64_t(1)));
+
+		benchmark::report("enet_packet_create size=" + std::to_string(size),
+		                  ns,
+		                  "system allocations/allocation=" + std::to_string(system_per_packet));
+	}
+}
@@ -0,0 +1,107 @@
+#include <mirrage/net/serialization.hpp>
+
+#include <mirrage/utils/benchmark.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mirrage;
+using namespace mirrage::util;
+
+namespace {
+	constexpr auto message_count = std::size_t(1024);
+
+	/// state update of an entity with native fields
+	struct Entity_state {
+		std::uint32_t entity;
+		float         x;
+		float         y;
+		float         z;
+		float         qx;
+		float         qy;
+		float         qz;
+		float         qw;
+		std::int32_t  health;
+		float         speed;
+	};
+
+	/// the same state with annotated fields
+	struct Packed_entity_state {
+		net::Varint<std::uint32_t>         entity;
+		net::Bounded_vec3<-1024, 1024, 18> position;
+		net::Quantized_quat<10>            orientation;
+		net::Varint<std::int32_t>          health;
+		net::Quantized_float<0, 20, 10>    speed;
+	};
+
+	auto make_messages()
+	{
+		auto rng    = std::mt19937(42);
+		auto dist   = std::uniform_real_distribution<float>(-1.f, 1.f);
+		auto native = std::vector<Entity_state>();
+		auto packed = std::vector<Packed_entity_state>();
+
+		for(auto i = std::size_t(0); i < message_count; i++) {
+			auto position    = glm::vec3(dist(rng), dist(rng), dist(rng)) * 1000.f;
+			auto orientation = glm::normalize(glm::quat(dist(rng), dist(rng), dist(rng), dist(rng)));
+			auto health      = std::int32_t(dist(rng) * 50.f + 50.f);
+			auto speed       = dist(rng) * 10.f + 10.f;
+
+			native.push_back({std::uint32_t(i),
+			                  position.x,
+			                  position.y,
+			                  position.z,
+			                  orientation.x,
+			                  orientation.y,
+			                  orientation.z,
+			                  orientation.w,
+			                  health,
+			                  speed});
+			packed.push_back({{std::uint32_t(i)}, {position}, {orientation}, {health}, {speed}});
+		}
+
+		return std::make_pair(native, packed);
+	}
+
+	template <typename T>
+	void run(const std::string& name, const std::vector<T>& messages)
+	{
+		auto size = std::size_t(0);
+		for(auto& msg : messages)
+			size += net::detail::calculate_size(msg);
+
+		auto buffer = std::vector<gsl::byte>(size);
+
+		auto write_ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				auto& msg = messages[i % message_count];
+				auto  out = net::Bit_writer(buffer);
+				net::detail::write_obj(msg, out);
+				out.flush();
+				benchmark::do_not_optimize(out.bytes_written());
+			}
+		});
+
+		auto read_ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				auto msg = T{};
+				auto in  = net::Bit_reader(buffer);
+				net::detail::read_obj(msg, in);
+				benchmark::do_not_optimize(msg);
+			}
+		});
+
+		auto bytes = "bytes/message=" + std::to_string(double(size) / double(message_count));
+		benchmark::report(name + " write", write_ns, bytes);
+		benchmark::report(name + " read", read_ns, bytes);
+	}
+} // namespace
+
+MIRRAGE_BENCHMARK(message_serialization)
+{
+	auto [native, packed] = make_messages();
+
+	run("native fields", native);
+	run("annotated fields", packed);
+}
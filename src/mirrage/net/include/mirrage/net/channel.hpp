@@ -16,6 +16,10 @@ typedef struct _ENetPacket ENetPacket;
 
 namespace mirrage::net {
 
+	namespace detail {
+		class Transport;
+	}
+
 	enum class Channel_type : std::uint8_t { reliable, unreliable };
 
 	struct Channel_definition {
@@ -73,8 +77,8 @@ namespace mirrage::net {
 	 */
 	class Channel {
 	  public:
-		Channel(ENetPeer* peer, Channel_definition definition);
-		Channel(ENetHost* host, Channel_definition definition);
+		/// sends to all peers of the transport if peer is nullptr
+		Channel(detail::Transport&, ENetPeer* peer, Channel_definition definition);
 
 		void send(gsl::span<gsl::byte> data);
 
@@ -88,16 +92,31 @@ namespace mirrage::net {
 			_send_packet(std::move(p));
 		}
 
+		/// sends a single packet to all given peers, that is shared between them instead of copied;
+		/// only supported by broadcast channels and errors are only logged, because the others still succeed
+		void multicast(gsl::span<ENetPeer* const> peers, gsl::span<gsl::byte> data);
+
+		template <typename F>
+		void multicast(gsl::span<ENetPeer* const> peers, std::size_t size, F&& f)
+		{
+			auto p = _create_empty_packet(size);
+
+			f(_packet_data(*p));
+
+			_multicast_packet(peers, std::move(p));
+		}
+
 	  private:
 		using Packet = std::unique_ptr<ENetPacket, void (*)(ENetPacket*)>;
 
+		detail::Transport* _transport;
 		ENetPeer*          _peer;
-		ENetHost*          _host;
 		Channel_definition _definition;
 
 		auto _create_empty_packet(std::size_t) -> Packet;
 		auto _packet_data(ENetPacket&) -> gsl::span<gsl::byte>;
 		void _send_packet(Packet);
+		void _multicast_packet(gsl::span<ENetPeer* const>, Packet);
 	};
 
 } // namespace mirrage::net
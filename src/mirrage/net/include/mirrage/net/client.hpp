@@ -2,6 +2,7 @@
 
 #include <mirrage/net/channel.hpp>
 #include <mirrage/net/common.hpp>
+#include <mirrage/net/loopback.hpp>
 
 #include <mirrage/utils/maybe.hpp>
 #include <mirrage/utils/reflection.hpp>
@@ -20,18 +21,27 @@ namespace mirrage::net {
 	class Client_builder {
 	  public:
 		Client_builder(std::string hostname, std::uint16_t port, const Channel_definitions&);
+		/// connects to a server on the Loopback_network, which has to outlive the client
+		Client_builder(Loopback_network&, std::uint16_t port, const Channel_definitions&);
 
 		auto on_connect(Connected_callback) -> Client_builder&;
 		auto on_disconnect(Disconnected_callback) -> Client_builder&;
+		/// services the connection on a background thread with the given rate, instead of in poll()
+		auto io_thread(int updates_per_second) -> Client_builder&;
+		/// simulates latency, jitter and packet loss for all outgoing packets
+		auto network_conditions(const Network_conditions&) -> Client_builder&;
 
 		auto connect() -> Client;
 
 	  private:
-		std::string                _hostname;
-		std::uint16_t              _port;
-		const Channel_definitions& _channels;
-		Connected_callback         _on_connected_callback;
-		Disconnected_callback      _on_disconnected_callback;
+		std::string                     _hostname;
+		std::uint16_t                   _port;
+		const Channel_definitions&      _channels;
+		Loopback_network*               _network = nullptr;
+		Connected_callback              _on_connected_callback;
+		Disconnected_callback           _on_disconnected_callback;
+		int                             _io_updates_per_second = 0;
+		util::maybe<Network_conditions> _network_conditions;
 	};
 
 
@@ -52,6 +62,10 @@ namespace mirrage::net {
 	 */
 	class Client final : public detail::Connection {
 	  public:
+		Client(Client&&) noexcept = default;
+		Client& operator=(Client&&) noexcept = default;
+		~Client();
+
 		auto channel(util::Str_id channel) -> Channel;
 
 		void disconnect(std::uint32_t reason);
@@ -59,13 +73,13 @@ namespace mirrage::net {
 	  private:
 		friend auto Client_builder::connect() -> Client;
 
-		std::unique_ptr<ENetPeer, void (*)(ENetPeer*)> _peer;
+		ENetPeer* _peer;
 
-		Client(const std::string&         hostname,
-		       std::uint16_t              port,
-		       const Channel_definitions& channels,
-		       Connected_callback         on_connected,
-		       Disconnected_callback      on_disconnected);
+		Client(std::unique_ptr<detail::Transport> transport,
+		       ENetPeer*                          peer,
+		       const Channel_definitions&         channels,
+		       Connected_callback                 on_connected,
+		       Disconnected_callback              on_disconnected);
 	};
 
 } // namespace mirrage::net
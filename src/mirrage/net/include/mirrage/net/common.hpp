@@ -47,16 +47,16 @@ namespace mirrage::net {
 			using Packet          = std::unique_ptr<ENetPacket, void (*)(ENetPacket*)>;
 			using Received_packet = std::tuple<util::Str_id, Client_handle, Packet>;
 
-			std::unique_ptr<ENetHost, void (*)(ENetHost*)> _host;
-			Channel_definitions                            _channels;
+			std::unique_ptr<Transport> _transport;
+			Channel_definitions        _channels;
 
-			Connection(std::unique_ptr<ENetHost, void (*)(ENetHost*)> host,
-			           Channel_definitions                            channels,
-			           Connected_callback                             on_connected,
-			           Disconnected_callback                          on_disconencted);
-			Connection(Connection&&) = default;
-			Connection& operator=(Connection&&) = default;
-			~Connection()                       = default;
+			Connection(std::unique_ptr<Transport> transport,
+			           Channel_definitions        channels,
+			           Connected_callback         on_connected,
+			           Disconnected_callback      on_disconencted);
+			Connection(Connection&&) noexcept;
+			Connection& operator=(Connection&&) noexcept;
+			~Connection();
 
 			virtual void _on_connected(Client_handle) {}
 			virtual void _on_disconnected(Client_handle, std::uint32_t) {}
@@ -64,9 +64,10 @@ namespace mirrage::net {
 		  private:
 			Connected_callback    _on_connected_callback;
 			Disconnected_callback _on_disconnected_callback;
-			int                   _connections;
+			int                   _connections = 0;
 
 			auto        _poll_packet() -> util::maybe<Received_packet>;
+			auto        _next_event(ENetEvent&) -> int;
 			static auto _packet_data(const ENetPacket&) -> gsl::span<const gsl::byte>;
 		};
 
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <mirrage/net/replication.hpp>
+#include <mirrage/net/server.hpp>
+
+#include <mirrage/ecs/entity_manager.hpp>
+
+#include <mirrage/utils/flat_map.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+namespace mirrage::net {
+
+	/**
+	 * @brief Area of interest of each client, based on the positions of their Transform_comp.
+	 * Each client has a viewer entity (e.g. its avatar or camera) and an entity is relevant for the client,
+	 *   if it is within view_distance of the viewer, or if it has been marked as global. Relevant entities
+	 *   stay relevant until they are more than view_distance + hysteresis away, so entities at the border
+	 *   aren't created and destroyed on the client every few ticks.
+	 * The priority of an entity falls off with its distance and is scaled by its importance.
+	 * Clients without a viewer only receive the global entities.
+	 *
+	 * Example:
+	 *  	auto interest = Interest_manager(server, ecs);
+	 *  	interest.attach(replication);
+	 *  	interest.viewer(client, client_avatar);
+	 *
+	 *  	// in update, before replication.update()
+	 *  	interest.update();
+	 */
+	class Interest_manager {
+	  public:
+		Interest_manager(Server&,
+		                 ecs::Entity_manager&,
+		                 float view_distance = 128.f,
+		                 float hysteresis    = 16.f,
+		                 float cell_size     = 32.f);
+
+		/// the entity whose position is the point of view of the client
+		void viewer(Client_handle, ecs::Entity_handle);
+		void remove_viewer(Client_handle);
+
+		/// multiplier for the priority of the entity (default: 1)
+		void importance(ecs::Entity_handle, float);
+		/// global entities are relevant for all clients, regardless of their position
+		void global(ecs::Entity_handle, bool);
+
+		// recalculates the relevant entities of each client; should be called once per tick
+		void update();
+
+		auto relevant(Client_handle, ecs::Entity_handle) const -> bool;
+		/// 0 if the entity is not relevant for the client
+		auto priority(Client_handle, ecs::Entity_handle) const -> float;
+
+		/// uses relevant() and priority() as the relevance filter and priority function of the replication
+		void attach(Replication_server&);
+
+	  private:
+		using Entity_key = detail::Entity_key;
+
+		struct Cell_entry {
+			std::uint64_t cell;
+			Entity_key    entity;
+			glm::vec3     position;
+		};
+		struct Client_interest {
+			ecs::Entity_handle viewer;
+			/// relevant entities and their priority
+			util::flat_map<Entity_key, float> relevant;
+		};
+
+		Server&                                            _server;
+		ecs::Entity_manager&                               _ecs;
+		float                                              _view_distance;
+		float                                              _hysteresis;
+		float                                              _cell_size;
+		std::unordered_map<Client_handle, Client_interest> _clients;
+		util::flat_map<Entity_key, float>                  _importance;
+		util::flat_set<Entity_key>                         _global;
+		std::vector<Cell_entry>                            _grid; //< sorted by cell
+		std::vector<std::pair<Entity_key, float>>          _relevant;
+
+		auto _cell(glm::vec3 position) const -> glm::ivec3;
+		void _update_grid();
+		void _update_client(Client_interest&);
+	};
+
+} // namespace mirrage::net
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+
+namespace mirrage::net {
+
+	namespace detail {
+		class Loopback_transport;
+		struct Loopback_state;
+	} // namespace detail
+
+	/**
+	 * @brief Simulated conditions for the outgoing packets of a Server or Client, e.g. to test and
+	 *   benchmark the replication under bad network conditions.
+	 * Works with the real network as well as with a Loopback_network. To simulate both directions, both
+	 *   ends have to be configured.
+	 *
+	 * Example:
+	 *  	auto conditions = Network_conditions{};
+	 *  	conditions.latency = std::chrono::milliseconds(50);
+	 *  	conditions.jitter  = std::chrono::milliseconds(10);
+	 *  	conditions.loss    = 0.05f;
+	 *
+	 *  	auto server = Server::on_loopback(network, 4242, channels)
+	 *  	                      .network_conditions(conditions)
+	 *  	                      .create();
+	 */
+	struct Network_conditions {
+		/// one-way delay that is added to each packet
+		std::chrono::microseconds latency{0};
+		/// maximum additional random delay
+		std::chrono::microseconds jitter{0};
+		/// probability that an unreliable packet is dropped or a reliable packet has to be retransmitted
+		float loss = 0.f;
+		/// probability that an unreliable packet is received twice
+		float duplication = 0.f;
+		/// bandwidth limit; 0 = unlimited
+		std::size_t bytes_per_second = 0;
+		/// of the random number generator, that decides which packets are affected, so the same seed
+		///   reproduces the same losses for the same sequence of packets
+		std::uint64_t seed = 0;
+	};
+
+	/**
+	 * @brief In-process replacement for the real network, for deterministic tests and benchmarks.
+	 * Servers and clients created with it exchange packets directly through memory, instead of UDP sockets.
+	 * Packets are delivered in order and without loss (unless Network_conditions are set), when the
+	 *   receiver polls the next time. Must outlive all servers and clients that use it.
+	 *
+	 * Example:
+	 *  	auto network = Loopback_network();
+	 *  	auto server  = Server::on_loopback(network, 4242, channels).create();
+	 *  	auto client  = Client_builder(network, 4242, channels).connect();
+	 */
+	class Loopback_network {
+	  public:
+		Loopback_network();
+		~Loopback_network();
+
+		Loopback_network(const Loopback_network&) = delete;
+		Loopback_network& operator=(const Loopback_network&) = delete;
+
+	  private:
+		friend class detail::Loopback_transport;
+
+		std::unique_ptr<detail::Loopback_state> _state;
+	};
+
+} // namespace mirrage::net
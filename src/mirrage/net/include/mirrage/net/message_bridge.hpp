@@ -2,14 +2,17 @@
 
 #include <mirrage/net/channel.hpp>
 #include <mirrage/net/client.hpp>
+#include <mirrage/net/serialization.hpp>
 #include <mirrage/net/server.hpp>
 
+#include <mirrage/utils/flat_map.hpp>
 #include <mirrage/utils/messagebus.hpp>
 
-#include <boost/pfr/precise.hpp>
-
+#include <array>
 #include <atomic>
 #include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 namespace mirrage::net {
 
@@ -22,6 +25,12 @@ namespace mirrage::net {
 	 * @brief Transfers selected messages between server and clients (bidirectional).
 	 * The types to be send have to registered with: register_msg_types(...)
 	 * For each received packet on_packet(...) should be called with the set of messages to receive.
+	 * Outgoing messages are packed into a shared buffer, that is sent as a single packet by flush() at the
+	 *   end of pump() or whenever it would exceed max_packet_size.
+	 * Fields are written at their native size, unless they are annotated with one of the compact
+	 *   representations from serialization.hpp (e.g. Varint<int> or Quantized_float<-1, 1, 12>).
+	 * Received messages are dispatched through a table indexed by their id, that is generated for each
+	 *   set of message types. Unknown ids and type-hash mismatches are only logged once per peer and id.
 	 *
 	 * Example:
 	 *  	struct Foo {
@@ -63,11 +72,23 @@ namespace mirrage::net {
 			(void(_register_msg_type<Ts>(idx++)), ...);
 		}
 
-		void pump() { _mailbox.update_subscriptions(); }
+		// packet size that fits into a single datagram with ENet's default MTU of 1400 bytes
+		static constexpr auto max_packet_size = std::size_t(1200);
+
+		// should be called once per tick, after all messages for this tick have been sent
+		void pump()
+		{
+			_mailbox.update_subscriptions();
+			flush();
+			_forget_disconnected_peers();
+		}
+		// sends all messages that have been packed since the last flush as a single packet
+		void flush();
+
 		void enable() { _mailbox.enable(); }
 		void disable() { _mailbox.disable(); }
 
-		// should be called for each incoming packet
+		// should be called for each incoming packet, which may contain any number of messages
 		// return: true if the packet has been processed
 		template <typename... Ts>
 		bool on_packet(const Message_types<Ts...>&,
@@ -79,176 +100,65 @@ namespace mirrage::net {
 		util::Mailbox_collection _mailbox;
 		Channel                  _channel;
 		util::Str_id             _channel_name;
+		std::vector<gsl::byte>   _outgoing;
+		const Server*            _server = nullptr; //< exactly one of them is set
+		const Client*            _client = nullptr;
 
-		template <typename T, std::size_t bulk_size = 4>
-		void _register_msg_type(std::uint16_t id, std::size_t queue_size = 16);
-
-		template <typename T>
-		bool _process_packet(std::uint16_t              t_id,
-		                     std::uint16_t              msg_id,
-		                     std::uint16_t              msg_hash,
-		                     gsl::span<const gsl::byte> data);
-	};
+		/// ids of received messages that have already been reported as unknown or mismatched, per peer
+		std::unordered_map<Client_handle, util::flat_set<std::uint16_t>> _reported_msg_ids;
 
+		/// entry of the dispatch table of on_packet(); process is nullptr for unknown (void) ids
+		struct Msg_handler {
+			bool (Message_bridge::*process)(std::uint16_t id, gsl::span<const gsl::byte>);
+			detail::type_hash_t hash;
+		};
 
-	// IMPLEMENTATION
-	namespace detail {
-		using type_hash_t = std::uint16_t;
+		/// returns size bytes at the end of the outgoing buffer, flushing it first if they wouldn't fit
+		auto _reserve(std::size_t size) -> gsl::span<gsl::byte>;
 
-		template <typename T, std::size_t... I, typename F>
-		constexpr void for_each_struct_type(std::index_sequence<I...>, F f)
-		{
-			(void(f(static_cast<boost::pfr::tuple_element_t<I, T>*>(nullptr))), ...);
-		}
+		template <typename T, std::size_t bulk_size = 4>
+		void _register_msg_type(std::uint16_t id, std::size_t queue_size = 16);
 
 		template <typename T>
-		constexpr type_hash_t calc_type_hash()
-		{
-			auto hash = type_hash_t(0);
-
-			for_each_struct_type<T>(std::make_index_sequence<boost::pfr::tuple_size_v<T>>{}, [&](auto t) {
-				hash = hash * 31 + calc_type_hash<std::remove_pointer_t<decltype(t)>>();
-			});
-
-			return hash;
-		}
-		template <>
-		constexpr inline type_hash_t calc_type_hash<bool>()
-		{
-			return 1;
-		}
-		template <>
-		constexpr inline type_hash_t calc_type_hash<float>()
-		{
-			return 2;
-		}
-		template <>
-		constexpr inline type_hash_t calc_type_hash<double>()
-		{
-			return 3;
-		}
-		template <>
-		constexpr inline type_hash_t calc_type_hash<std::int8_t>()
-		{
-			return 4;
-		}
-		template <>
-		constexpr inline type_hash_t calc_type_hash<std::uint8_t>()
-		{
-			return 5;
-		}
-		template <>
-		constexpr inline type_hash_t calc_type_hash<std::int16_t>()
-		{
-			return 6;
-		}
-		template <>
-		constexpr inline type_hash_t calc_type_hash<std::uint16_t>()
-		{
-			return 7;
-		}
-		template <>
-		constexpr inline type_hash_t calc_type_hash<std::int32_t>()
-		{
-			return 8;
-		}
-		template <>
-		constexpr inline type_hash_t calc_type_hash<std::uint32_t>()
-		{
-			return 9;
-		}
-		template <>
-		constexpr inline type_hash_t calc_type_hash<std::int64_t>()
-		{
-			return 10;
-		}
-		template <>
-		constexpr inline type_hash_t calc_type_hash<std::uint64_t>()
-		{
-			return 11;
-		}
-		template <>
-		constexpr inline type_hash_t calc_type_hash<std::string>()
-		{
-			return 12;
-		}
+		static constexpr auto _msg_handler() -> Msg_handler;
 
 		template <typename T>
-		constexpr type_hash_t type_hash = calc_type_hash<T>();
+		bool _process_message(std::uint16_t id, gsl::span<const gsl::byte> data);
 
+		/// returns true, if the error hasn't been reported for this peer and message id before
+		bool _report_once(Client_handle, std::uint16_t msg_id);
 
-		template <typename T>
-		auto calculate_size(const T& val)
-		{
-			if constexpr(std::is_integral_v<T>) {
-				return sizeof(T);
-			} else {
-				auto size = std::size_t(0);
-				boost::pfr::for_each_field(val, [&](auto& field) { size += calculate_size(field); });
-
-				return size;
-			}
-		}
-		template <>
-		inline auto calculate_size(const std::string& val)
-		{
-			return sizeof(std::uint32_t) + val.size();
-		}
+		/// removes the reported ids of peers that are no longer connected
+		void _forget_disconnected_peers();
+	};
 
-		template <typename T>
-		auto read_obj(T& val, gsl::span<const gsl::byte> out) -> gsl::span<const gsl::byte>
-		{
-			if constexpr(std::is_integral_v<T>) {
-				val = reinterpret_cast<const T&>(out[0]);
-				return out.subspan<sizeof(T)>();
-			} else {
-				boost::pfr::for_each_field(val, [&](auto& field) { out = read_obj(field, out); });
-				return out;
-			}
-		}
-		template <>
-		inline auto read_obj(std::string& val, gsl::span<const gsl::byte> out) -> gsl::span<const gsl::byte>
-		{
-			auto size = reinterpret_cast<const std::uint32_t&>(out[0]);
-			val.resize(size);
-			std::memcpy(val.data(), &out[sizeof(std::uint32_t)], size);
-			return out.subspan(sizeof(std::uint32_t) + size);
-		}
 
-		template <typename T>
-		auto write_obj(const T& val, gsl::span<gsl::byte> out) -> gsl::span<gsl::byte>
-		{
-			if constexpr(std::is_integral_v<T>) {
-				reinterpret_cast<T&>(out[0]) = val;
-				return out.subspan<sizeof(T)>();
-			} else {
-				boost::pfr::for_each_field(val, [&](auto& field) { out = write_obj(field, out); });
-				return out;
-			}
-		}
-		template <>
-		inline auto write_obj(const std::string& val, gsl::span<gsl::byte> out) -> gsl::span<gsl::byte>
+	// IMPLEMENTATION
+	namespace detail {
+		/// each message in a packet starts with its type id, type hash and the size of its data as a varint
+		///   (1 byte for most messages, without limiting the size of large ones)
+		constexpr auto msg_header_size(std::size_t data_size) -> std::size_t
 		{
-			reinterpret_cast<std::uint32_t&>(out[0]) = gsl::narrow<std::uint32_t>(val.size());
-			std::memcpy(&out[sizeof(std::uint32_t)], val.data(), val.size());
-			return out.subspan(
-			        gsl::narrow<gsl::span<gsl::byte>::index_type>(sizeof(std::uint32_t) + val.size()));
+			auto size = sizeof(std::uint16_t) + sizeof(type_hash_t) + 1;
+			for(; data_size >= 0x80u; data_size >>= 7)
+				size++;
+			return size;
 		}
-
+		constexpr auto msg_min_header_size = msg_header_size(0);
 	} // namespace detail
 
 	template <class T, std::size_t bulk_size>
 	void Message_bridge::_register_msg_type(std::uint16_t id, std::size_t queue_size)
 	{
-		_mailbox.subscribe<T, bulk_size>(queue_size, [&, id](const T& event) {
-			auto size = detail::calculate_size(event) + sizeof(id) + sizeof(detail::type_hash_t);
-
-			_channel.send(size, [&](auto data) {
-				reinterpret_cast<std::uint16_t&>(data[0])                           = id;
-				reinterpret_cast<detail::type_hash_t&>(data[sizeof(std::uint16_t)]) = detail::type_hash<T>;
-
-				detail::write_obj(event, data.subspan(sizeof(id) + sizeof(detail::type_hash_t)));
-			});
+		_mailbox.subscribe_batched<T, bulk_size>(queue_size, [&, id](const T& event) {
+			auto size = detail::calculate_size(event);
+
+			auto out = Bit_writer(_reserve(detail::msg_header_size(size) + size));
+			out.write(id, 16);
+			out.write(detail::type_hash<T>, 16);
+			out.write_varint(size);
+			detail::write_obj(event, out);
+			out.flush();
 		});
 	}
 
@@ -258,62 +168,90 @@ namespace mirrage::net {
 	}
 
 	template <typename T>
-	bool Message_bridge::_process_packet(std::uint16_t              t_id,
-	                                     std::uint16_t              msg_id,
-	                                     std::uint16_t              msg_hash,
-	                                     gsl::span<const gsl::byte> data)
+	constexpr auto Message_bridge::_msg_handler() -> Msg_handler
 	{
-		if(t_id != msg_id) {
-			return false;
-		}
+		if constexpr(std::is_void_v<T>)
+			return {nullptr, 0};
+		else
+			return {&Message_bridge::_process_message<T>, detail::type_hash<T>};
+	}
+
+	template <typename T>
+	bool Message_bridge::_process_message(std::uint16_t id, gsl::span<const gsl::byte> data)
+	{
+		auto event = T{};
+		auto in    = Bit_reader(data);
+		detail::read_obj(event, in);
 
-		constexpr auto t_hash = detail::type_hash<T>;
-		if(msg_hash != t_hash) {
-			LOG(plog::warning) << "Type-hash of message " << util::type_name<T>() << " (" << t_id
-			                   << ") doesn't match " << t_hash << "!=" << msg_hash
-			                   << " (different app version?).";
+		if(in.failed()) {
+			LOG(plog::warning) << "Message " << util::type_name<T>() << " (" << id
+			                   << ") dropped, because it is truncated.";
 			return false;
 		}
 
-		auto event = T{};
-		detail::read_obj(event, data);
-
 		_mailbox.send_msg(event);
 
 		return true;
 	}
-	template <>
-	inline bool Message_bridge::_process_packet<void>(std::uint16_t,
-	                                                  std::uint16_t,
-	                                                  std::uint16_t,
-	                                                  gsl::span<const gsl::byte>)
-	{
-		return false;
-	}
 
 	template <typename... Ts>
 	bool Message_bridge::on_packet(const Message_types<Ts...>&,
-	                               util::Str_id channel,
-	                               Client_handle,
+	                               util::Str_id               channel,
+	                               Client_handle              peer,
 	                               gsl::span<const gsl::byte> data)
 	{
-		constexpr auto header_size = sizeof(std::uint16_t) + sizeof(detail::type_hash_t);
+		static constexpr auto handlers = std::array<Msg_handler, sizeof...(Ts)>{_msg_handler<Ts>()...};
+
+		auto size = [&] { return gsl::narrow<std::size_t>(data.size_bytes()); };
 
-		if(channel != _channel_name || gsl::narrow<std::size_t>(data.size_bytes()) < header_size) {
+		if(channel != _channel_name || size() < detail::msg_min_header_size) {
 			LOG(plog::info) << "Packet dropped because channel-name doesn't match or packet is too small.";
 			return false;
 		}
 
-		auto msg_type_id   = *reinterpret_cast<const std::uint16_t*>(&data[0]);
-		auto msg_type_hash = *reinterpret_cast<const detail::type_hash_t*>(&data[sizeof(std::uint16_t)]);
-		auto rest          = data.subspan<header_size>();
+		auto processed = false;
 
-		if(msg_type_id >= sizeof...(Ts)) {
-			return false;
+		while(size() >= detail::msg_min_header_size) {
+			auto header        = Bit_reader(data);
+			auto msg_type_id   = std::uint16_t(header.read(16));
+			auto msg_type_hash = detail::type_hash_t(header.read(16));
+			auto msg_size      = header.read_varint();
+			if(header.failed()) {
+				LOG(plog::warning) << "Rest of packet dropped, because a message header is truncated.";
+				break;
+			}
+
+			auto header_size = size() - header.bits_left() / 8;
+			data             = data.subspan(std::ptrdiff_t(header_size));
+
+			if(msg_size > size()) {
+				LOG(plog::warning) << "Rest of packet dropped, because a message is larger than the packet.";
+				break;
+			}
+
+			auto msg = data.first(std::ptrdiff_t(msg_size));
+			data     = data.subspan(std::ptrdiff_t(msg_size));
+
+			// unknown messages are skipped, so the remaining messages can still be processed
+			if(msg_type_id >= handlers.size() || !handlers[msg_type_id].process) {
+				if(_report_once(peer, msg_type_id))
+					LOG(plog::warning) << "Received unknown message type " << msg_type_id << ".";
+				continue;
+			}
+
+			auto& handler = handlers[msg_type_id];
+			if(msg_type_hash != handler.hash) {
+				if(_report_once(peer, msg_type_id))
+					LOG(plog::warning) << "Type-hash of message " << msg_type_id << " doesn't match "
+					                   << handler.hash << "!=" << msg_type_hash
+					                   << " (different app version?).";
+				continue;
+			}
+
+			processed |= (this->*handler.process)(msg_type_id, msg);
 		}
 
-		auto idx = std::uint16_t(0);
-		return (_process_packet<Ts>(idx++, msg_type_id, msg_type_hash, rest) || ...);
+		return processed;
 	}
 
 } // namespace mirrage::net
@@ -5,9 +5,19 @@
 
 namespace mirrage::net {
 
+	/// counters of the allocator that is used for all memory allocated by ENet, e.g. packets
+	struct Allocation_stats {
+		std::uint64_t allocations;        //< total number of allocations
+		std::uint64_t system_allocations; //< allocations that couldn't be served from a freelist
+		std::uint64_t live;               //< allocated blocks that have not been freed yet
+		std::uint64_t cached_bytes;       //< memory kept in the freelists for reuse
+	};
+
 	/**
 	 * @brief Initializes the network subsystem.
 	 * Should be created exactly once and outlive all network operations!
+	 * The memory of ENet is allocated from size-classed freelists, to avoid a malloc/free pair for each
+	 *   sent and received packet.
 	 */
 	class Net_manager {
 	  public:
@@ -17,6 +27,9 @@ namespace mirrage::net {
 		Net_manager(const Net_manager&) = delete;
 		Net_manager& operator=(const Net_manager&) = delete;
 
+		/// thread-safe; e.g. to check that steady-state traffic doesn't hit the system allocator
+		static auto allocation_stats() -> Allocation_stats;
+
 	  private:
 		static std::atomic<std::int32_t> use_count;
 	};
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <mirrage/net/channel.hpp>
+#include <mirrage/net/client.hpp>
+#include <mirrage/net/serialization.hpp>
+#include <mirrage/net/server.hpp>
+
+#include <mirrage/ecs/entity_manager.hpp>
+
+#include <mirrage/utils/flat_map.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace mirrage::net {
+
+	/**
+	 * @brief Opt-in trait for components that should be replicated by the Replication_server.
+	 * Has to be specialized for each replicated component C with:
+	 *  - state: a struct of the replicated fields, that can be written by the Message_bridge
+	 *           (may contain the annotations from serialization.hpp)
+	 *  - static auto save(const C&) -> state
+	 *  - static void load(C&, const state&)
+	 *
+	 * Example:
+	 *  	template <>
+	 *  	struct Replication_traits<Health_comp> {
+	 *  		struct state {
+	 *  			Varint<std::int32_t> health;
+	 *  		};
+	 *  		static auto save(const Health_comp& c) { return state{{c.health}}; }
+	 *  		static void load(Health_comp& c, const state& s) { c.health = s.health; }
+	 *  	};
+	 */
+	template <typename C>
+	struct Replication_traits;
+
+
+	namespace detail {
+		template <typename C, typename = void>
+		constexpr auto is_replicated = false;
+
+		template <typename C>
+		constexpr auto is_replicated<C, std::void_t<typename Replication_traits<C>::state>> = true;
+
+		using Entity_key = ecs::Entity_handle::packed_t;
+
+		/// number of snapshots that are kept as possible baselines
+		constexpr auto max_snapshot_history = std::size_t(32);
+
+		/// the replicated state of all components of one type in a snapshot, sorted by their entity
+		class Component_states_base {
+		  public:
+			virtual ~Component_states_base() = default;
+
+			virtual auto create_empty() const -> std::unique_ptr<Component_states_base> = 0;
+			virtual auto type_hash() const -> type_hash_t                               = 0;
+
+			/// adds all components of the type in the Entity_manager and their owners to entities
+			virtual void capture(ecs::Entity_manager&, std::vector<Entity_key>& entities) = 0;
+			/// writes the state into the component of the entity, creating it if necessary
+			virtual void apply(Entity_key, ecs::Entity_facet) const = 0;
+			virtual void erase(ecs::Entity_facet) const             = 0;
+
+			virtual bool has(Entity_key) const                                = 0;
+			virtual bool equal(Entity_key, const Component_states_base&) const = 0;
+			/// upper bound for the number of bits written by write(), for a full state or a delta
+			virtual auto bits(Entity_key) const -> std::size_t = 0;
+
+			/// appends the state of the entity from other (keys have to be added in ascending order)
+			virtual void copy(Entity_key, const Component_states_base& other) = 0;
+			/// writes the state of the entity as a delta to base, or in full if base doesn't have it
+			virtual void write(Entity_key, const Component_states_base* base, Bit_writer&) const = 0;
+			/// appends the state written by write() (keys have to be read in ascending order)
+			virtual void read(Entity_key, const Component_states_base* base, Bit_reader&) = 0;
+		};
+
+		template <typename C>
+		class Component_states final : public Component_states_base {
+		  public:
+			using traits = Replication_traits<C>;
+			using state  = typename traits::state;
+
+			auto create_empty() const -> std::unique_ptr<Component_states_base> override
+			{
+				return std::make_unique<Component_states>();
+			}
+			auto type_hash() const -> type_hash_t override { return detail::type_hash<state>; }
+
+			void capture(ecs::Entity_manager& ecs, std::vector<Entity_key>& entities) override
+			{
+				for(auto& comp : ecs.list<C>()) {
+					auto key = comp.owner_handle().pack();
+					_states.emplace_back(key, traits::save(comp));
+					entities.emplace_back(key);
+				}
+
+				std::sort(_states.begin(), _states.end(), [](auto& lhs, auto& rhs) {
+					return lhs.first < rhs.first;
+				});
+			}
+			void apply(Entity_key key, ecs::Entity_facet entity) const override
+			{
+				auto& s = *_find(key);
+
+				if(auto comp = entity.get<C>(); comp.is_some())
+					traits::load(comp.get_or_throw(), s);
+				else
+					entity.emplace_init<C>([&](C& new_comp) { traits::load(new_comp, s); });
+			}
+			void erase(ecs::Entity_facet entity) const override
+			{
+				if(entity.has<C>())
+					entity.erase<C>();
+			}
+
+			bool has(Entity_key key) const override { return _find(key) != nullptr; }
+			bool equal(Entity_key key, const Component_states_base& other) const override
+			{
+				return equal_obj(*_find(key), *static_cast<const Component_states&>(other)._find(key));
+			}
+			auto bits(Entity_key key) const -> std::size_t override
+			{
+				// write_delta() adds a changed-bit to each field, but doesn't write the unchanged ones
+				return calculate_bits(*_find(key)) + boost::pfr::tuple_size_v<state>;
+			}
+
+			void copy(Entity_key key, const Component_states_base& other) override
+			{
+				_states.emplace_back(key, *static_cast<const Component_states&>(other)._find(key));
+			}
+			void write(Entity_key key, const Component_states_base* base, Bit_writer& out) const override
+			{
+				auto base_state = base ? static_cast<const Component_states*>(base)->_find(key) : nullptr;
+				if(base_state)
+					write_delta(*_find(key), *base_state, out);
+				else
+					write_obj(*_find(key), out);
+			}
+			void read(Entity_key key, const Component_states_base* base, Bit_reader& in) override
+			{
+				auto base_state = base ? static_cast<const Component_states*>(base)->_find(key) : nullptr;
+				auto& s         = _states.emplace_back(key, state{}).second;
+				if(base_state)
+					read_delta(s, *base_state, in);
+				else
+					read_obj(s, in);
+			}
+
+		  private:
+			std::vector<std::pair<Entity_key, state>> _states;
+
+			auto _find(Entity_key key) const -> const state*
+			{
+				auto iter = std::lower_bound(_states.begin(), _states.end(), key, [](auto& lhs, auto rhs) {
+					return lhs.first < rhs;
+				});
+				return iter != _states.end() && iter->first == key ? &iter->second : nullptr;
+			}
+		};
+
+		enum class Record_kind : std::uint8_t { update = 0, create = 1, destroy = 2 };
+
+		/// an entity in the snapshot sent to a client; unchanged and deferred entities are not sent
+		struct Record {
+			Entity_key  key;
+			Record_kind kind;
+			bool        send;
+		};
+
+		struct Snapshot {
+			std::uint32_t                                       sequence = 0;
+			std::vector<Entity_key>                             entities; //< sorted
+			std::vector<std::unique_ptr<Component_states_base>> components;
+		};
+
+		using Component_types = std::vector<std::unique_ptr<Component_states_base>>;
+
+		template <typename C>
+		void register_replicated_component(Component_types& types)
+		{
+			static_assert(is_replicated<C>, "The component has to specialize net::Replication_traits");
+			static_assert(std::is_base_of_v<ecs::detail::Owned_component_base, C>,
+			              "Only components that know their owner can be replicated");
+
+			types.emplace_back(std::make_unique<Component_states<C>>());
+		}
+	} // namespace detail
+
+
+	/**
+	 * @brief Replicates the state of entities to all connected clients.
+	 * Each update() captures a snapshot of all replicated components and sends each client only the
+	 *   differences to the last snapshot it has acknowledged: created and destroyed entities, added and
+	 *   removed components and the changed fields of the others. The channel should be unreliable,
+	 *   because lost snapshots are simply superseded by the next one.
+	 * A relevance filter can restrict the entities that are sent to each client, e.g. to those near its
+	 *   viewpoint (see Interest_manager). If a byte budget per client and tick is set, changed entities are
+	 *   sent in the order of their accumulated priority and the rest are deferred to the following ticks.
+	 * The same component types have to be registered in the same order on the Replication_client.
+	 *
+	 * Example:
+	 *  	auto replication = Replication_server(server, ecs, "replication"_strid);
+	 *  	replication.register_component<Health_comp>();
+	 *
+	 *  	// in update, after process_queued_actions()
+	 *  	replication.update();
+	 *
+	 *  	// in packet-handler of Connection::poll
+	 *  	server.poll([&](auto&&... packet) {
+	 *  		if(!replication.on_packet(packet...)) {
+	 *  			// my handlers
+	 *  		}
+	 *  	});
+	 */
+	class Replication_server {
+	  public:
+		/// decides if an entity is sent to a client
+		using Relevance_filter = std::function<bool(Client_handle, ecs::Entity_handle)>;
+		/// priority that is added each tick to the accumulator of changed entities, that haven't been sent
+		using Priority_function = std::function<float(Client_handle, ecs::Entity_handle)>;
+
+		Replication_server(Server&, ecs::Entity_manager&, util::Str_id channel);
+
+		template <typename C>
+		void register_component()
+		{
+			detail::register_replicated_component<C>(_component_types);
+		}
+
+		/// all entities are sent to all clients, if no filter is set
+		void relevance_filter(Relevance_filter filter) { _relevance_filter = std::move(filter); }
+		/// all entities have a priority of 1, if no function is set
+		void priority(Priority_function priority) { _priority = std::move(priority); }
+		/// the (approximate) maximum size of the snapshot sent to a single client; 0 = unlimited
+		void bytes_per_tick(std::size_t budget) { _bytes_per_tick = budget; }
+
+		// captures the current state and sends it to all clients; should be called once per tick
+		void update();
+
+		// should be called for each incoming packet
+		// return: true if the packet has been processed
+		bool on_packet(util::Str_id channel, Client_handle, gsl::span<const gsl::byte>);
+
+	  private:
+		struct Client_state {
+			Channel       channel;
+			std::uint32_t acked = 0;
+			/// the state the client has after receiving each sent snapshot, i.e. without deferred changes
+			std::deque<detail::Snapshot> sent;
+			/// accumulated priority of deferred entities
+			util::flat_map<detail::Entity_key, float> priorities;
+		};
+
+		Server&                                           _server;
+		ecs::Entity_manager&                              _ecs;
+		util::Str_id                                      _channel_name;
+		detail::Component_types                           _component_types;
+		Relevance_filter                                  _relevance_filter;
+		Priority_function                                 _priority;
+		std::size_t                                       _bytes_per_tick = 0;
+		std::uint32_t                                     _sequence       = 0;
+		detail::Snapshot                                  _current;
+		std::unordered_map<Client_handle, Client_state>   _clients;
+		std::vector<detail::Record>                       _records;
+		std::vector<std::pair<detail::Entity_key, float>> _pending;
+		std::vector<gsl::byte>                            _buffer;
+
+		void _update_clients();
+		void _capture();
+		void _send(Client_handle, Client_state&);
+		void _select_records(Client_handle, Client_state&);
+	};
+
+	/**
+	 * @brief Receives the snapshots of a Replication_server and applies them to the local Entity_manager.
+	 * Entities of the server are mirrored by local entities, that are created and destroyed as needed.
+	 */
+	class Replication_client {
+	  public:
+		Replication_client(Client&, ecs::Entity_manager&, util::Str_id channel);
+
+		template <typename C>
+		void register_component()
+		{
+			detail::register_replicated_component<C>(_component_types);
+		}
+
+		// applies the newest received snapshot; should be called once per tick
+		void update();
+
+		// should be called for each incoming packet
+		// return: true if the packet has been processed
+		bool on_packet(util::Str_id channel, Client_handle, gsl::span<const gsl::byte>);
+
+		/// the local entity, that mirrors the given entity of the server
+		auto local_entity(ecs::Entity_handle server_entity) const -> ecs::Entity_handle;
+
+	  private:
+		Channel                                                    _channel;
+		ecs::Entity_manager&                                       _ecs;
+		util::Str_id                                               _channel_name;
+		detail::Component_types                                    _component_types;
+		std::deque<detail::Snapshot>                               _history;
+		std::uint32_t                                              _applied = 0;
+		std::unordered_map<detail::Entity_key, ecs::Entity_handle> _entities;
+		std::vector<gsl::byte>                                     _buffer;
+
+		void _send_ack(std::uint32_t sequence);
+		void _apply(const detail::Snapshot* prev, const detail::Snapshot& next);
+	};
+
+} // namespace mirrage::net
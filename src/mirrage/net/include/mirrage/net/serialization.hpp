@@ -0,0 +1,572 @@
+#pragma once
+
+#include <mirrage/utils/log.hpp>
+
+#include <boost/pfr/precise.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec3.hpp>
+#include <gsl/gsl>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mirrage::net {
+
+	/**
+	 * @brief Writes values with an arbitrary number of bits into a preallocated buffer (LSB first).
+	 * flush() has to be called after the last value, to write the remaining partial byte.
+	 * If the final size is not known beforehand, the writer can also append to a vector, which is resized
+	 *   to the written size by flush().
+	 */
+	class Bit_writer {
+	  public:
+		explicit Bit_writer(gsl::span<gsl::byte> out) : _out(out) {}
+		explicit Bit_writer(std::vector<gsl::byte>& out) : _out(out), _growable(&out) {}
+
+		void write(std::uint64_t value, int bits)
+		{
+			if(bits > 32) {
+				write(value & 0xffffffffu, 32);
+				write(value >> 32, bits - 32);
+				return;
+			}
+
+			_scratch |= (value & ((std::uint64_t(1) << bits) - 1)) << _scratch_bits;
+			_scratch_bits += bits;
+			if(_scratch_bits >= 32)
+				_write_bytes(4);
+		}
+
+		/// 7 bits per byte, the highest bit is set if more bytes follow
+		void write_varint(std::uint64_t value)
+		{
+			do {
+				auto group = value & 0x7fu;
+				value >>= 7;
+				write(group | (value != 0 ? 0x80u : 0u), 8);
+			} while(value != 0);
+		}
+
+		void flush()
+		{
+			_write_bytes((_scratch_bits + 7) / 8);
+			_scratch_bits = 0;
+
+			if(_growable)
+				_growable->resize(std::size_t(_position));
+		}
+
+		auto bytes_written() const noexcept { return _position; }
+
+	  private:
+		gsl::span<gsl::byte>    _out;
+		std::vector<gsl::byte>* _growable     = nullptr;
+		std::ptrdiff_t          _position     = 0;
+		std::uint64_t           _scratch      = 0;
+		int                     _scratch_bits = 0;
+
+		void _write_bytes(int count)
+		{
+			if(_growable && _position + count > _out.size()) {
+				_growable->resize(std::max(_growable->size() * 2, std::size_t(64)));
+				_out = *_growable;
+			}
+
+			MIRRAGE_INVARIANT(_position + count <= _out.size(), "Bit_writer overflow (calculate_bits()?)");
+
+			auto out = _out.data() + _position;
+			for(auto i = 0; i < count; i++)
+				out[i] = static_cast<gsl::byte>((_scratch >> (i * 8)) & 0xffu);
+
+			_position += count;
+			_scratch >>= count * 8;
+			_scratch_bits -= count * 8;
+		}
+	};
+
+	/**
+	 * @brief Reads values written by a Bit_writer.
+	 * Reading past the end of the data returns 0 and sets failed(), so the values of a malformed packet
+	 *   only have to be checked once at the end.
+	 */
+	class Bit_reader {
+	  public:
+		explicit Bit_reader(gsl::span<const gsl::byte> in) : _in(in) {}
+
+		auto read(int bits) -> std::uint64_t
+		{
+			if(bits > 32) {
+				auto low = read(32);
+				return low | (read(bits - 32) << 32);
+			}
+
+			if(_scratch_bits < bits && !_refill(bits)) {
+				_failed = true;
+				return 0;
+			}
+
+			auto value = _scratch & ((std::uint64_t(1) << bits) - 1);
+			_scratch >>= bits;
+			_scratch_bits -= bits;
+			return value;
+		}
+
+		auto read_varint() -> std::uint64_t
+		{
+			auto value = std::uint64_t(0);
+			for(auto shift = 0; shift < 64 && !_failed; shift += 7) {
+				auto group = read(8);
+				value |= (group & 0x7fu) << shift;
+				if((group & 0x80u) == 0)
+					return value;
+			}
+
+			_failed = true;
+			return 0;
+		}
+
+		auto bits_left() const noexcept
+		{
+			return std::size_t(_in.size() - _position) * 8 + std::size_t(_scratch_bits);
+		}
+		auto failed() const noexcept { return _failed; }
+		void fail() noexcept { _failed = true; }
+
+	  private:
+		gsl::span<const gsl::byte> _in;
+		std::ptrdiff_t             _position     = 0;
+		std::uint64_t              _scratch      = 0;
+		int                        _scratch_bits = 0;
+		bool                       _failed       = false;
+
+		auto _refill(int bits) -> bool
+		{
+			// 4 bytes at once if possible, so most reads don't have to touch the buffer at all
+			auto count = std::min(std::ptrdiff_t(4), _in.size() - _position);
+			if(_scratch_bits + count * 8 < bits)
+				return false;
+
+			auto in = _in.data() + _position;
+			for(auto i = 0; i < count; i++)
+				_scratch |= std::uint64_t(static_cast<std::uint8_t>(in[i])) << (_scratch_bits + i * 8);
+
+			_position += count;
+			_scratch_bits += int(count) * 8;
+			return true;
+		}
+	};
+
+
+	namespace detail {
+		using type_hash_t = std::uint16_t;
+
+		constexpr type_hash_t combine_type_hash(type_hash_t hash, int value)
+		{
+			return type_hash_t(hash * 31 + value);
+		}
+
+		template <typename T>
+		constexpr auto zigzag_encode(T value) -> std::uint64_t
+		{
+			if constexpr(std::is_signed_v<T>) {
+				auto v = std::int64_t(value);
+				return (std::uint64_t(v) << 1) ^ std::uint64_t(v >> 63);
+			} else {
+				return std::uint64_t(value);
+			}
+		}
+		template <typename T>
+		constexpr auto zigzag_decode(std::uint64_t value) -> T
+		{
+			if constexpr(std::is_signed_v<T>) {
+				return T(std::int64_t(value >> 1) ^ -std::int64_t(value & 1));
+			} else {
+				return T(value);
+			}
+		}
+
+		constexpr auto varint_bits(std::uint64_t value) -> std::size_t
+		{
+			auto bytes = std::size_t(1);
+			while(value >>= 7)
+				bytes++;
+			return bytes * 8;
+		}
+
+		/// maps value from [min, max] to [0, 2^bits-1]; values outside the range (and NaN) are clamped
+		inline auto quantize(double value, double min, double max, int bits) -> std::uint64_t
+		{
+			auto steps = double((std::uint64_t(1) << bits) - 1);
+			auto t     = (value - min) / (max - min);
+			t          = t > 0.0 ? std::min(t, 1.0) : 0.0;
+			return std::uint64_t(t * steps + 0.5);
+		}
+		inline auto dequantize(std::uint64_t value, double min, double max, int bits) -> double
+		{
+			auto steps = double((std::uint64_t(1) << bits) - 1);
+			return min + double(value) / steps * (max - min);
+		}
+	} // namespace detail
+
+
+	// Field annotations for messages sent by the Message_bridge, that replace the native representation
+	//   with a more compact one. They are part of the type-hash, so peers that disagree on the encoding
+	//   of a message reject it.
+
+	/// integer written with one byte per 7 bits of its value (zig-zag encoded if signed)
+	template <typename T>
+	struct Varint {
+		static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "Varint requires an integer type");
+
+		T value = 0;
+
+		constexpr operator T() const noexcept { return value; }
+
+		static constexpr auto net_type_hash =
+		        detail::combine_type_hash(13, int(sizeof(T) * 2 + std::is_signed_v<T>));
+
+		auto bits() const { return detail::varint_bits(detail::zigzag_encode(value)); }
+		void write(Bit_writer& w) const { w.write_varint(detail::zigzag_encode(value)); }
+		void read(Bit_reader& r) { value = detail::zigzag_decode<T>(r.read_varint()); }
+	};
+
+	/// float in [Min, Max] quantized to Bits bits. Values outside the range are clamped.
+	template <int Min, int Max, int Bits = 16>
+	struct Quantized_float {
+		static_assert(Min < Max, "Quantized_float requires a non-empty range");
+		static_assert(Bits > 0 && Bits <= 32, "Quantized_float requires between 1 and 32 bits");
+
+		float value = 0.f;
+
+		constexpr operator float() const noexcept { return value; }
+
+		static constexpr auto net_type_hash = detail::combine_type_hash(
+		        detail::combine_type_hash(detail::combine_type_hash(14, Min), Max), Bits);
+
+		auto bits() const { return std::size_t(Bits); }
+		void write(Bit_writer& w) const { w.write(detail::quantize(value, Min, Max, Bits), Bits); }
+		void read(Bit_reader& r) { value = float(detail::dequantize(r.read(Bits), Min, Max, Bits)); }
+	};
+
+	/// unit quaternion in the smallest-three encoding: the index of its largest component and the other
+	///   three quantized to Bits bits, from which the largest one is reconstructed
+	template <int Bits = 10>
+	struct Quantized_quat {
+		static_assert(Bits > 1 && Bits <= 30, "Quantized_quat requires between 2 and 30 bits per component");
+
+		glm::quat value = glm::quat();
+
+		operator glm::quat() const noexcept { return value; }
+
+		static constexpr auto net_type_hash = detail::combine_type_hash(15, Bits);
+
+		auto bits() const { return std::size_t(2 + Bits * 3); }
+		void write(Bit_writer& w) const
+		{
+			auto largest = 0;
+			for(auto i = 1; i < 4; i++) {
+				if(std::abs(value[i]) > std::abs(value[largest]))
+					largest = i;
+			}
+
+			// q and -q are the same rotation, so the largest component can always be made positive
+			auto sign = value[largest] < 0.f ? -1.0 : 1.0;
+
+			w.write(std::uint64_t(largest), 2);
+			for(auto i = 0; i < 4; i++) {
+				if(i != largest)
+					w.write(detail::quantize(sign * value[i], -max_component, max_component, Bits), Bits);
+			}
+		}
+		void read(Bit_reader& r)
+		{
+			auto largest = int(r.read(2));
+			auto sum     = 0.0;
+			for(auto i = 0; i < 4; i++) {
+				if(i != largest) {
+					auto c   = detail::dequantize(r.read(Bits), -max_component, max_component, Bits);
+					value[i] = float(c);
+					sum += c * c;
+				}
+			}
+			value[largest] = float(std::sqrt(std::max(0.0, 1.0 - sum)));
+		}
+
+	  private:
+		// the other components of a unit quaternion can't be larger than 1/sqrt(2)
+		static constexpr auto max_component = 0.70710678118654752;
+	};
+
+	/// position with each component in [Min, Max] quantized to Bits bits
+	template <int Min, int Max, int Bits = 16>
+	struct Bounded_vec3 {
+		static_assert(Min < Max, "Bounded_vec3 requires a non-empty range");
+		static_assert(Bits > 0 && Bits <= 32, "Bounded_vec3 requires between 1 and 32 bits per component");
+
+		glm::vec3 value = glm::vec3(0, 0, 0);
+
+		operator glm::vec3() const noexcept { return value; }
+
+		static constexpr auto net_type_hash = detail::combine_type_hash(
+		        detail::combine_type_hash(detail::combine_type_hash(16, Min), Max), Bits);
+
+		auto bits() const { return std::size_t(Bits * 3); }
+		void write(Bit_writer& w) const
+		{
+			for(auto i = 0; i < 3; i++)
+				w.write(detail::quantize(value[i], Min, Max, Bits), Bits);
+		}
+		void read(Bit_reader& r)
+		{
+			for(auto i = 0; i < 3; i++)
+				value[i] = float(detail::dequantize(r.read(Bits), Min, Max, Bits));
+		}
+	};
+
+
+	namespace detail {
+		template <typename T, typename = void>
+		constexpr auto is_annotated = false;
+
+		template <typename T>
+		constexpr auto is_annotated<T, std::void_t<decltype(T::net_type_hash)>> = true;
+
+		template <typename T, std::size_t... I, typename F>
+		constexpr void for_each_struct_type(std::index_sequence<I...>, F f)
+		{
+			(void(f(static_cast<boost::pfr::tuple_element_t<I, T>*>(nullptr))), ...);
+		}
+
+		template <typename T>
+		constexpr type_hash_t calc_type_hash()
+		{
+			if constexpr(is_annotated<T>) {
+				return T::net_type_hash;
+			} else {
+				auto hash = type_hash_t(0);
+
+				for_each_struct_type<T>(std::make_index_sequence<boost::pfr::tuple_size_v<T>>{}, [&](auto t) {
+					hash = hash * 31 + calc_type_hash<std::remove_pointer_t<decltype(t)>>();
+				});
+
+				return hash;
+			}
+		}
+		template <>
+		constexpr inline type_hash_t calc_type_hash<bool>()
+		{
+			return 1;
+		}
+		template <>
+		constexpr inline type_hash_t calc_type_hash<float>()
+		{
+			return 2;
+		}
+		template <>
+		constexpr inline type_hash_t calc_type_hash<double>()
+		{
+			return 3;
+		}
+		template <>
+		constexpr inline type_hash_t calc_type_hash<std::int8_t>()
+		{
+			return 4;
+		}
+		template <>
+		constexpr inline type_hash_t calc_type_hash<std::uint8_t>()
+		{
+			return 5;
+		}
+		template <>
+		constexpr inline type_hash_t calc_type_hash<std::int16_t>()
+		{
+			return 6;
+		}
+		template <>
+		constexpr inline type_hash_t calc_type_hash<std::uint16_t>()
+		{
+			return 7;
+		}
+		template <>
+		constexpr inline type_hash_t calc_type_hash<std::int32_t>()
+		{
+			return 8;
+		}
+		template <>
+		constexpr inline type_hash_t calc_type_hash<std::uint32_t>()
+		{
+			return 9;
+		}
+		template <>
+		constexpr inline type_hash_t calc_type_hash<std::int64_t>()
+		{
+			return 10;
+		}
+		template <>
+		constexpr inline type_hash_t calc_type_hash<std::uint64_t>()
+		{
+			return 11;
+		}
+		template <>
+		constexpr inline type_hash_t calc_type_hash<std::string>()
+		{
+			return 12;
+		}
+
+		template <typename T>
+		constexpr type_hash_t type_hash = calc_type_hash<T>();
+
+
+		/// size of the value written by write_obj() in bits
+		template <typename T>
+		auto calculate_bits(const T& val) -> std::size_t
+		{
+			if constexpr(std::is_same_v<T, bool>) {
+				return 1;
+			} else if constexpr(std::is_arithmetic_v<T>) {
+				return sizeof(T) * 8;
+			} else if constexpr(is_annotated<T>) {
+				return val.bits();
+			} else {
+				auto size = std::size_t(0);
+				boost::pfr::for_each_field(val, [&](auto& field) { size += calculate_bits(field); });
+
+				return size;
+			}
+		}
+		template <>
+		inline auto calculate_bits(const std::string& val) -> std::size_t
+		{
+			return varint_bits(val.size()) + val.size() * 8;
+		}
+
+		/// size of a message in bytes
+		template <typename T>
+		auto calculate_size(const T& val) -> std::size_t
+		{
+			return (calculate_bits(val) + 7) / 8;
+		}
+
+		template <typename T>
+		void read_obj(T& val, Bit_reader& in)
+		{
+			if constexpr(std::is_same_v<T, bool>) {
+				val = in.read(1) != 0;
+			} else if constexpr(std::is_integral_v<T>) {
+				val = T(in.read(sizeof(T) * 8));
+			} else if constexpr(std::is_floating_point_v<T>) {
+				using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+				auto bits  = Bits(in.read(sizeof(T) * 8));
+				std::memcpy(&val, &bits, sizeof(T));
+			} else if constexpr(is_annotated<T>) {
+				val.read(in);
+			} else {
+				boost::pfr::for_each_field(val, [&](auto& field) { read_obj(field, in); });
+			}
+		}
+		template <>
+		inline void read_obj(std::string& val, Bit_reader& in)
+		{
+			auto size = in.read_varint();
+			if(size > in.bits_left() / 8) {
+				in.fail();
+				return;
+			}
+
+			val.resize(size);
+			for(auto& c : val)
+				c = char(in.read(8));
+		}
+
+		template <typename T>
+		void write_obj(const T& val, Bit_writer& out)
+		{
+			if constexpr(std::is_same_v<T, bool>) {
+				out.write(val ? 1 : 0, 1);
+			} else if constexpr(std::is_integral_v<T>) {
+				out.write(std::uint64_t(val), sizeof(T) * 8);
+			} else if constexpr(std::is_floating_point_v<T>) {
+				using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+				auto bits  = Bits(0);
+				std::memcpy(&bits, &val, sizeof(T));
+				out.write(bits, sizeof(T) * 8);
+			} else if constexpr(is_annotated<T>) {
+				val.write(out);
+			} else {
+				boost::pfr::for_each_field(val, [&](auto& field) { write_obj(field, out); });
+			}
+		}
+		template <>
+		inline void write_obj(const std::string& val, Bit_writer& out)
+		{
+			out.write_varint(val.size());
+			for(auto c : val)
+				out.write(static_cast<unsigned char>(c), 8);
+		}
+
+		template <typename T, std::size_t... I>
+		bool equal_fields(const T& lhs, const T& rhs, std::index_sequence<I...>);
+
+		/// bitwise equality of the values, that would be written by write_obj()
+		template <typename T>
+		bool equal_obj(const T& lhs, const T& rhs)
+		{
+			if constexpr(std::is_arithmetic_v<T>) {
+				return std::memcmp(&lhs, &rhs, sizeof(T)) == 0;
+			} else if constexpr(is_annotated<T>) {
+				return lhs.value == rhs.value;
+			} else if constexpr(std::is_same_v<T, std::string>) {
+				return lhs == rhs;
+			} else {
+				return equal_fields(lhs, rhs, std::make_index_sequence<boost::pfr::tuple_size_v<T>>{});
+			}
+		}
+		template <typename T, std::size_t... I>
+		bool equal_fields(const T& lhs, const T& rhs, std::index_sequence<I...>)
+		{
+			return (equal_obj(boost::pfr::get<I>(lhs), boost::pfr::get<I>(rhs)) && ...);
+		}
+
+		template <typename T, std::size_t... I>
+		void write_delta_fields(const T& val, const T& base, Bit_writer& out, std::index_sequence<I...>)
+		{
+			auto write_field = [&](auto& field, auto& base_field) {
+				auto changed = !equal_obj(field, base_field);
+				out.write(changed ? 1 : 0, 1);
+				if(changed)
+					write_obj(field, out);
+			};
+			(write_field(boost::pfr::get<I>(val), boost::pfr::get<I>(base)), ...);
+		}
+		template <typename T, std::size_t... I>
+		void read_delta_fields(T& val, const T& base, Bit_reader& in, std::index_sequence<I...>)
+		{
+			auto read_field = [&](auto& field, auto& base_field) {
+				if(in.read(1) != 0)
+					read_obj(field, in);
+				else
+					field = base_field;
+			};
+			(read_field(boost::pfr::get<I>(val), boost::pfr::get<I>(base)), ...);
+		}
+
+		/// writes a bit for each field of val, that is set if the field differs from base and is followed
+		///   by its new value
+		template <typename T>
+		void write_delta(const T& val, const T& base, Bit_writer& out)
+		{
+			write_delta_fields(val, base, out, std::make_index_sequence<boost::pfr::tuple_size_v<T>>{});
+		}
+		template <typename T>
+		void read_delta(T& val, const T& base, Bit_reader& in)
+		{
+			read_delta_fields(val, base, in, std::make_index_sequence<boost::pfr::tuple_size_v<T>>{});
+		}
+	} // namespace detail
+
+} // namespace mirrage::net
@@ -2,6 +2,7 @@
 
 #include <mirrage/net/channel.hpp>
 #include <mirrage/net/common.hpp>
+#include <mirrage/net/loopback.hpp>
 
 #include <mirrage/utils/maybe.hpp>
 #include <mirrage/utils/reflection.hpp>
@@ -19,7 +20,7 @@ namespace mirrage::net {
 
 	class Server_builder {
 	  public:
-		enum class Host_type { named, any, broadcast };
+		enum class Host_type { named, any, broadcast, loopback };
 
 		auto max_clients(int limit) -> auto&
 		{
@@ -32,6 +33,18 @@ namespace mirrage::net {
 			_max_out_bandwidth = out;
 			return *this;
 		}
+		/// services the connection on a background thread with the given rate, instead of in poll()
+		auto io_thread(int updates_per_second) -> auto&
+		{
+			_io_updates_per_second = updates_per_second;
+			return *this;
+		}
+		/// simulates latency, jitter and packet loss for all outgoing packets
+		auto network_conditions(const Network_conditions& conditions) -> auto&
+		{
+			_network_conditions = conditions;
+			return *this;
+		}
 
 		auto on_connect(Connected_callback handler) -> auto&
 		{
@@ -50,16 +63,20 @@ namespace mirrage::net {
 		friend class Server;
 
 		Server_builder(Host_type type, std::string hostname, std::uint16_t port, const Channel_definitions&);
-
-		Host_type             _type;
-		std::string           _hostname;
-		std::uint16_t         _port;
-		Channel_definitions   _channels;
-		int                   _max_clients       = 128;
-		int                   _max_in_bandwidth  = 0;
-		int                   _max_out_bandwidth = 0;
-		Connected_callback    _on_connect;
-		Disconnected_callback _on_disconnect;
+		Server_builder(Loopback_network&, std::uint16_t port, const Channel_definitions&);
+
+		Host_type                       _type;
+		std::string                     _hostname;
+		std::uint16_t                   _port;
+		Channel_definitions             _channels;
+		Loopback_network*               _network               = nullptr;
+		int                             _max_clients           = 128;
+		int                             _max_in_bandwidth      = 0;
+		int                             _max_out_bandwidth     = 0;
+		int                             _io_updates_per_second = 0;
+		util::maybe<Network_conditions> _network_conditions;
+		Connected_callback              _on_connect;
+		Disconnected_callback           _on_disconnect;
 	};
 
 
@@ -94,6 +111,13 @@ namespace mirrage::net {
 		{
 			return {Server_builder::Host_type::broadcast, {}, port, channels};
 		}
+		/// the server is only reachable by clients on the same Loopback_network, which has to outlive it
+		static Server_builder on_loopback(Loopback_network&          network,
+		                                  std::uint16_t              port,
+		                                  const Channel_definitions& channels)
+		{
+			return {network, port, channels};
+		}
 
 
 		auto broadcast_channel(util::Str_id channel) -> Channel;
@@ -110,15 +134,10 @@ namespace mirrage::net {
 
 		std::vector<Client_handle> _clients;
 
-		Server(Server_builder::Host_type  type,
-		       const std::string&         hostname,
-		       std::uint16_t              port,
-		       const Channel_definitions& channels,
-		       int                        max_clients,
-		       int                        max_in_bandwidth,
-		       int                        max_out_bandwidth,
-		       Connected_callback         on_connected,
-		       Disconnected_callback      on_disconnected);
+		Server(std::unique_ptr<detail::Transport> transport,
+		       const Channel_definitions&         channels,
+		       Connected_callback                 on_connected,
+		       Disconnected_callback              on_disconnected);
 	};
 
 } // namespace mirrage::net
@@ -2,6 +2,8 @@
 
 #include <mirrage/net/error.hpp>
 
+#include "transport.hpp"
+
 #include <enet/enet.h>
 
 
@@ -22,12 +24,8 @@ namespace mirrage::net {
 	}
 
 
-	Channel::Channel(ENetPeer* peer, Channel_definition definition)
-	  : _peer(peer), _host(nullptr), _definition(definition)
-	{
-	}
-	Channel::Channel(ENetHost* host, Channel_definition definition)
-	  : _peer(nullptr), _host(host), _definition(definition)
+	Channel::Channel(detail::Transport& transport, ENetPeer* peer, Channel_definition definition)
+	  : _transport(&transport), _peer(peer), _definition(definition)
 	{
 	}
 
@@ -56,22 +54,27 @@ namespace mirrage::net {
 	void Channel::_send_packet(Packet packet)
 	{
 		if(!_peer) {
-			enet_host_broadcast(_host, _definition.id, packet.release());
+			_transport->broadcast(_definition.id, packet.release());
+
+		} else if(!_transport->send(_peer, _definition.id, packet.get())) {
+			constexpr auto msg =
+			        "Couldn't send message, because the connection has not been "
+			        "established yet or packet is much to large.";
+			LOG(plog::warning) << msg;
+			throw std::system_error(Net_error::not_connected, msg);
+
 		} else {
-			auto rc = enet_peer_send(_peer, _definition.id, packet.get());
-
-			if(rc != 0) {
-				constexpr auto msg =
-				        "Couldn't send message, because the connection has not been "
-				        "established yet or packet is much to large.";
-				LOG(plog::warning) << msg;
-				throw std::system_error(Net_error::not_connected, msg);
-			} else {
-				packet.release();
-			}
+			packet.release();
 		}
 	}
 
+	void Channel::_multicast_packet(gsl::span<ENetPeer* const> peers, Packet packet)
+	{
+		MIRRAGE_INVARIANT(!_peer, "Only broadcast channels can send packets to multiple peers");
+
+		_transport->multicast(peers, _definition.id, packet.release());
+	}
+
 	void Channel::send(gsl::span<gsl::byte> data)
 	{
 		auto size   = gsl::narrow<std::size_t>(data.size_bytes());
@@ -81,6 +84,15 @@ namespace mirrage::net {
 
 		_send_packet(std::move(packet));
 	}
+	void Channel::multicast(gsl::span<ENetPeer* const> peers, gsl::span<gsl::byte> data)
+	{
+		auto size   = gsl::narrow<std::size_t>(data.size_bytes());
+		auto packet = _create_empty_packet(size);
+
+		std::memcpy(packet->data, data.data(), size);
+
+		_multicast_packet(peers, std::move(packet));
+	}
 
 
 } // namespace mirrage::net
@@ -2,6 +2,8 @@
 
 #include <mirrage/net/error.hpp>
 
+#include "transport.hpp"
+
 #include <enet/enet.h>
 
 
@@ -13,6 +15,12 @@ namespace mirrage::net {
 	  : _hostname(std::move(hostname)), _port(port), _channels(channels)
 	{
 	}
+	Client_builder::Client_builder(Loopback_network&          network,
+	                               std::uint16_t              port,
+	                               const Channel_definitions& channels)
+	  : _port(port), _channels(channels), _network(&network)
+	{
+	}
 
 	auto Client_builder::on_connect(Connected_callback cb) -> Client_builder&
 	{
@@ -25,9 +33,15 @@ namespace mirrage::net {
 		return *this;
 	}
 
-	auto Client_builder::connect() -> Client
+	auto Client_builder::io_thread(int updates_per_second) -> Client_builder&
 	{
-		return {_hostname, _port, _channels, _on_connected_callback, _on_disconnected_callback};
+		_io_updates_per_second = updates_per_second;
+		return *this;
+	}
+	auto Client_builder::network_conditions(const Network_conditions& conditions) -> Client_builder&
+	{
+		_network_conditions = conditions;
+		return *this;
 	}
 
 	namespace {
@@ -67,22 +81,46 @@ namespace mirrage::net {
 				throw std::system_error(Net_error::connection_error, msg);
 			}
 
-			return std::unique_ptr<ENetPeer, void (*)(ENetPeer*)>(peer,
-			                                                      [](auto p) { enet_peer_disconnect(p, 0); });
+			return peer;
 		}
 	} // namespace
 
-	Client::Client(const std::string&         hostname,
-	               std::uint16_t              port,
-	               const Channel_definitions& channels,
-	               Connected_callback         on_connected,
-	               Disconnected_callback      on_disconnected)
-	  : Connection(open_client_host(channels.size()),
-	               channels,
-	               std::move(on_connected),
-	               std::move(on_disconnected))
-	  , _peer(open_client_connection(*_host, hostname, port, _channels.size()))
+	auto Client_builder::connect() -> Client
+	{
+		auto transport = std::unique_ptr<detail::Transport>();
+		auto peer      = static_cast<ENetPeer*>(nullptr);
+
+		if(_network) {
+			auto loopback = std::make_unique<detail::Loopback_transport>(*_network);
+			peer          = loopback->connect(_port);
+			transport     = std::move(loopback);
+		} else {
+			auto enet = std::make_unique<detail::Enet_transport>(open_client_host(_channels.size()));
+			peer      = open_client_connection(enet->host(), _hostname, _port, _channels.size());
+			transport = std::move(enet);
+		}
+
+		return {detail::decorate_transport(std::move(transport), _network_conditions, _io_updates_per_second),
+		        peer,
+		        _channels,
+		        _on_connected_callback,
+		        _on_disconnected_callback};
+	}
+
+	Client::Client(std::unique_ptr<detail::Transport> transport,
+	               ENetPeer*                          peer,
+	               const Channel_definitions&         channels,
+	               Connected_callback                 on_connected,
+	               Disconnected_callback              on_disconnected)
+	  : Connection(std::move(transport), channels, std::move(on_connected), std::move(on_disconnected))
+	  , _peer(peer)
+	{
+	}
+	Client::~Client()
 	{
+		// moved-from clients don't own a connection
+		if(_transport)
+			_transport->disconnect(_peer, 0);
 	}
 
 	auto Client::channel(util::Str_id channel) -> Channel
@@ -94,9 +132,12 @@ namespace mirrage::net {
 			throw std::system_error(Net_error::unknown_channel, msg);
 		}
 
-		return Channel(_peer.get(), c.get_or_throw());
+		return Channel(*_transport, _peer, c.get_or_throw());
 	}
 
-	void Client::disconnect(std::uint32_t reason) { enet_peer_disconnect(_peer.get(), reason); }
+	void Client::disconnect(std::uint32_t reason)
+	{
+		_transport->disconnect(_peer, reason);
+	}
 
 } // namespace mirrage::net
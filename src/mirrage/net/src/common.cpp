@@ -1,27 +1,32 @@
 #include <mirrage/net/common.hpp>
 
+#include "transport.hpp"
+
 #include <enet/enet.h>
 
 
 namespace mirrage::net::detail {
 
-	Connection::Connection(std::unique_ptr<ENetHost, void (*)(ENetHost*)> host,
-	                       Channel_definitions                            channels,
-	                       Connected_callback                             on_connected,
-	                       Disconnected_callback                          on_disconencted)
-	  : _host(std::move(host))
+	Connection::Connection(std::unique_ptr<Transport> transport,
+	                       Channel_definitions        channels,
+	                       Connected_callback         on_connected,
+	                       Disconnected_callback      on_disconencted)
+	  : _transport(std::move(transport))
 	  , _channels(std::move(channels))
 	  , _on_connected_callback(std::move(on_connected))
 	  , _on_disconnected_callback(std::move(on_disconencted))
 	{
 	}
+	Connection::Connection(Connection&&) noexcept = default;
+	Connection& Connection::operator=(Connection&&) noexcept = default;
+	Connection::~Connection()                                = default;
 
 	auto Connection::_poll_packet() -> util::maybe<Received_packet>
 	{
 		auto event = ENetEvent{};
 		auto ret   = 0;
 
-		while((ret = enet_host_service(_host.get(), &event, 0)) > 0) {
+		while((ret = _next_event(event)) > 0) {
 			switch(event.type) {
 				case ENET_EVENT_TYPE_CONNECT:
 					_connections++;
@@ -50,11 +55,12 @@ namespace mirrage::net::detail {
 		}
 
 		if(ret < 0) {
-			LOG(plog::error) << "An unknown error occured in ENet while receiving incoming packets";
+			LOG(plog::error) << "An unknown error occured while receiving incoming packets";
 		}
 
 		return util::nothing;
 	}
+	auto Connection::_next_event(ENetEvent& event) -> int { return _transport->service(event); }
 	auto Connection::_packet_data(const ENetPacket& packet) -> gsl::span<const gsl::byte>
 	{
 		return {reinterpret_cast<const gsl::byte*>(packet.data),
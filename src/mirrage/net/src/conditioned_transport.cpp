@@ -0,0 +1,165 @@
+#include "transport.hpp"
+
+#include <mirrage/utils/log.hpp>
+
+#include <algorithm>
+
+
+namespace mirrage::net::detail {
+
+	namespace {
+		/// upper limit for the number of simulated retransmissions of a single reliable packet
+		constexpr auto max_retransmissions = 8;
+	} // namespace
+
+	Conditioned_transport::Conditioned_transport(std::unique_ptr<Transport> transport,
+	                                             const Network_conditions&  conditions,
+	                                             Time_source                now)
+	  : _transport(std::move(transport))
+	  , _conditions(conditions)
+	  , _now(std::move(now))
+	  , _random(conditions.seed)
+	{
+	}
+	Conditioned_transport::~Conditioned_transport()
+	{
+		// disconnects are still passed on, so the peers don't have to wait for a timeout
+		while(!_pending.empty()) {
+			auto& p = _pending.top();
+			if(p.type == Pending_type::disconnect)
+				_transport->disconnect(p.peer, p.data);
+			else if(--p.packet->referenceCount == 0)
+				enet_packet_destroy(p.packet);
+
+			_pending.pop();
+		}
+	}
+
+	auto Conditioned_transport::service(ENetEvent& event) -> int
+	{
+		_forward_due(_now());
+		return _transport->service(event);
+	}
+	void Conditioned_transport::flush()
+	{
+		_forward_due(_now());
+		_transport->flush();
+	}
+
+	auto Conditioned_transport::send(ENetPeer* peer, std::uint8_t channel, ENetPacket* packet) -> bool
+	{
+		_queue(Pending_type::send, peer, channel, packet);
+
+		// dropped packets are owned by the conditioner, like the ones that have been sent successfully
+		if(packet->referenceCount == 0)
+			enet_packet_destroy(packet);
+
+		return true;
+	}
+	void Conditioned_transport::broadcast(std::uint8_t channel, ENetPacket* packet)
+	{
+		_queue(Pending_type::broadcast, nullptr, channel, packet);
+
+		if(packet->referenceCount == 0)
+			enet_packet_destroy(packet);
+	}
+	void Conditioned_transport::disconnect(ENetPeer* peer, std::uint32_t reason)
+	{
+		// sent after all packets that have already been queued for the peer
+		_pending.push(
+		        Pending{_last_due, _next_sequence++, Pending_type::disconnect, peer, 0, nullptr, reason});
+	}
+
+	void Conditioned_transport::_queue(Pending_type type,
+	                                   ENetPeer*    peer,
+	                                   std::uint8_t channel,
+	                                   ENetPacket*  packet)
+	{
+		auto now = _now();
+
+		// the time the packet leaves the local host, if the bandwidth is limited
+		auto sent = now;
+		if(_conditions.bytes_per_second > 0) {
+			auto transmission = std::chrono::duration_cast<Clock::duration>(
+			        std::chrono::duration<double>(double(packet->dataLength)
+			                                      / double(_conditions.bytes_per_second)));
+			_link_free_at = std::max(_link_free_at, now) + transmission;
+			sent          = _link_free_at;
+		}
+
+		auto delay = [&] {
+			auto jitter = _random() % std::uint64_t(_conditions.jitter.count() + 1);
+			return _conditions.latency + std::chrono::microseconds(jitter);
+		};
+
+		auto queue = [&](Clock::time_point due) {
+			packet->referenceCount++;
+			_pending.push(Pending{due, _next_sequence++, type, peer, channel, packet, 0});
+			_last_due = std::max(_last_due, due);
+		};
+
+		if(packet->flags & ENET_PACKET_FLAG_RELIABLE) {
+			auto due = sent + delay();
+
+			// each lost transmission is detected and resent by the sender after about one round trip
+			for(auto i = 0; i < max_retransmissions && _chance(_conditions.loss); i++)
+				due += 2 * delay();
+
+			// reliable packets are never reordered
+			auto& last_due = _last_reliable_due[peer];
+			due            = std::max(due, last_due);
+			last_due       = due;
+
+			queue(due);
+			return;
+		}
+
+		if(!_chance(_conditions.loss))
+			queue(sent + delay());
+
+		if(_chance(_conditions.duplication))
+			queue(sent + delay());
+	}
+
+	auto Conditioned_transport::_chance(float probability) -> bool
+	{
+		return probability > 0.f && util::detail::uniform_float(_random) < probability;
+	}
+
+	void Conditioned_transport::_forward_due(Clock::time_point now)
+	{
+		while(!_pending.empty() && _pending.top().due <= now) {
+			auto p = _pending.top();
+			_pending.pop();
+			_forward(p);
+		}
+	}
+	void Conditioned_transport::_forward(const Pending& p)
+	{
+		// the reference of the conditioner is passed on with the packet, so the transport doesn't have to
+		//   copy it if it was the last one
+		switch(p.type) {
+			case Pending_type::send:
+				p.packet->referenceCount--;
+				if(!_transport->send(p.peer, p.channel, p.packet)) {
+					LOG(plog::warning) << "Couldn't send delayed message, because the connection has been "
+					                      "closed or packet is much to large.";
+
+					if(p.packet->referenceCount == 0)
+						enet_packet_destroy(p.packet);
+				}
+				break;
+
+			case Pending_type::broadcast:
+				p.packet->referenceCount--;
+				_transport->broadcast(p.channel, p.packet);
+				break;
+
+			case Pending_type::disconnect:
+				_transport->disconnect(p.peer, p.data);
+				_last_reliable_due.erase(p.peer);
+				break;
+		}
+	}
+
+} // namespace mirrage::net::detail
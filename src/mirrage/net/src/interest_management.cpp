@@ -0,0 +1,181 @@
+#include <mirrage/net/interest_management.hpp>
+
+#include <mirrage/ecs/components/transform_comp.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace mirrage::net {
+
+	using ecs::components::Transform_comp;
+
+	namespace {
+		constexpr auto cell_bits   = 21;
+		constexpr auto cell_offset = std::int32_t(1) << (cell_bits - 1);
+		constexpr auto cell_mask   = (std::uint64_t(1) << cell_bits) - 1;
+
+		/// keys are ordered by x, y and then z
+		auto cell_key(glm::ivec3 cell)
+		{
+			auto key = [](std::int32_t c) { return std::uint64_t(c + cell_offset) & cell_mask; };
+			return key(cell.x) << (2 * cell_bits) | key(cell.y) << cell_bits | key(cell.z);
+		}
+	} // namespace
+
+
+	Interest_manager::Interest_manager(
+	        Server& server, ecs::Entity_manager& ecs, float view_distance, float hysteresis, float cell_size)
+	  : _server(server)
+	  , _ecs(ecs)
+	  , _view_distance(view_distance)
+	  , _hysteresis(hysteresis)
+	  , _cell_size(cell_size)
+	{
+		MIRRAGE_INVARIANT(cell_size > 0.f && view_distance > 0.f && hysteresis >= 0.f,
+		                  "Invalid area of interest: view_distance=" << view_distance
+		                                                             << ", hysteresis=" << hysteresis
+		                                                             << ", cell_size=" << cell_size);
+	}
+
+	void Interest_manager::viewer(Client_handle client, ecs::Entity_handle entity)
+	{
+		_clients[client].viewer = entity;
+	}
+	void Interest_manager::remove_viewer(Client_handle client) { _clients.erase(client); }
+
+	void Interest_manager::importance(ecs::Entity_handle entity, float importance)
+	{
+		if(importance == 1.f)
+			_importance.erase(entity.pack());
+		else
+			_importance[entity.pack()] = importance;
+	}
+	void Interest_manager::global(ecs::Entity_handle entity, bool global)
+	{
+		if(global)
+			_global.insert(entity.pack());
+		else
+			_global.erase(entity.pack());
+	}
+
+	void Interest_manager::update()
+	{
+		auto& connected = _server.clients();
+		for(auto iter = _clients.begin(); iter != _clients.end();) {
+			if(std::find(connected.begin(), connected.end(), iter->first) == connected.end())
+				iter = _clients.erase(iter);
+			else
+				iter++;
+		}
+
+		// forget entities that have been deleted
+		for(auto i = _global.size(); i > 0; i--) {
+			auto key = _global[std::int64_t(i - 1)];
+			if(!_ecs.validate(ecs::Entity_handle::unpack(key)))
+				_global.erase(key);
+		}
+		for(auto i = _importance.size(); i > 0; i--) {
+			auto key = _importance.keys()[i - 1];
+			if(!_ecs.validate(ecs::Entity_handle::unpack(key)))
+				_importance.erase(key);
+		}
+
+		_update_grid();
+
+		for(auto& [handle, client] : _clients)
+			_update_client(client);
+	}
+
+	auto Interest_manager::relevant(Client_handle handle, ecs::Entity_handle entity) const -> bool
+	{
+		auto client = _clients.find(handle);
+		return client != _clients.end() ? client->second.relevant.contains(entity.pack())
+		                                : _global.contains(entity.pack());
+	}
+
+	auto Interest_manager::priority(Client_handle handle, ecs::Entity_handle entity) const -> float
+	{
+		auto client = _clients.find(handle);
+		if(client != _clients.end())
+			return client->second.relevant.find(entity.pack()).get_or(0.f);
+
+		return _global.contains(entity.pack()) ? _importance.find(entity.pack()).get_or(1.f) : 0.f;
+	}
+
+	void Interest_manager::attach(Replication_server& replication)
+	{
+		replication.relevance_filter([this](auto client, auto entity) { return relevant(client, entity); });
+		replication.priority([this](auto client, auto entity) { return priority(client, entity); });
+	}
+
+	auto Interest_manager::_cell(glm::vec3 position) const -> glm::ivec3
+	{
+		return glm::ivec3(glm::floor(position / _cell_size));
+	}
+
+	void Interest_manager::_update_grid()
+	{
+		_grid.clear();
+		for(auto& transform : _ecs.list<Transform_comp>()) {
+			auto position = transform.position;
+			_grid.push_back({cell_key(_cell(position)), transform.owner_handle().pack(), position});
+		}
+
+		std::sort(_grid.begin(), _grid.end(), [](auto& lhs, auto& rhs) {
+			return std::tie(lhs.cell, lhs.entity) < std::tie(rhs.cell, rhs.entity);
+		});
+	}
+
+	void Interest_manager::_update_client(Client_interest& client)
+	{
+		_relevant.clear();
+
+		// global entities are added first, so their entries are kept if they are also in range
+		for(auto key : _global)
+			_relevant.emplace_back(key, _importance.find(key).get_or(1.f));
+
+		auto viewer_position = [](ecs::Entity_facet& entity) {
+			return entity.get<Transform_comp>().process([](auto& transform) { return transform.position; });
+		};
+		auto viewer = _ecs.get(client.viewer).process(util::maybe<glm::vec3>(), viewer_position);
+
+		if(viewer.is_some()) {
+			auto origin       = viewer.get_or_throw();
+			auto max_dist     = _view_distance + _hysteresis;
+			auto min_cell     = _cell(origin - max_dist);
+			auto max_cell     = _cell(origin + max_dist);
+			auto cell_less    = [](auto& entry, auto cell) { return entry.cell < cell; };
+			auto cell_greater = [](auto cell, auto& entry) { return cell < entry.cell; };
+
+			for(auto x = min_cell.x; x <= max_cell.x; x++) {
+				for(auto y = min_cell.y; y <= max_cell.y; y++) {
+					// the cells of a column along z are contiguous in the grid
+					auto first_key = cell_key({x, y, min_cell.z});
+					auto last_key  = cell_key({x, y, max_cell.z});
+					auto first     = std::lower_bound(_grid.begin(), _grid.end(), first_key, cell_less);
+					auto last      = std::upper_bound(first, _grid.end(), last_key, cell_greater);
+
+					for(auto entry = first; entry != last; entry++) {
+						auto dist = glm::distance(origin, entry->position);
+
+						// entities that are already relevant are only dropped after they left the hysteresis
+						auto was_relevant = client.relevant.contains(entry->entity);
+						if(dist > (was_relevant ? max_dist : _view_distance))
+							continue;
+
+						auto importance = _importance.find(entry->entity).get_or(1.f);
+						auto falloff    = _view_distance / (_view_distance + dist);
+						_relevant.emplace_back(entry->entity, importance * falloff);
+					}
+				}
+			}
+		}
+
+		client.relevant.clear();
+		client.relevant.insert(_relevant.begin(), _relevant.end());
+	}
+
+} // namespace mirrage::net
@@ -0,0 +1,139 @@
+#include "io_thread.hpp"
+
+#include <mirrage/utils/log.hpp>
+
+
+namespace mirrage::net::detail {
+
+	Io_thread::Io_thread(std::unique_ptr<Transport> transport,
+	                     int                        updates_per_second,
+	                     std::size_t                queue_capacity)
+	  : _transport(std::move(transport))
+	  , _interval(std::chrono::microseconds(1'000'000 / std::max(1, updates_per_second)))
+	  , _commands(queue_capacity)
+	  , _events(queue_capacity)
+	  , _thread([this] { _run(); })
+	{
+	}
+	Io_thread::~Io_thread()
+	{
+		{
+			auto lock = std::scoped_lock{_mutex};
+			_shutdown = true;
+		}
+		_wakeup.notify_one();
+		_thread.join();
+
+		// free the packets of events that have never been polled
+		auto destroy_event = [](ENetEvent& event) {
+			if(event.type == ENET_EVENT_TYPE_RECEIVE)
+				enet_packet_destroy(event.packet);
+		};
+
+		auto event = ENetEvent{};
+		while(_events.try_pop(event))
+			destroy_event(event);
+		for(auto& e : _overflow)
+			destroy_event(e);
+	}
+
+	auto Io_thread::send(ENetPeer* peer, std::uint8_t channel, ENetPacket* packet) -> bool
+	{
+		_push(Command{Command_type::send, peer, packet, channel, 0});
+		return true;
+	}
+	void Io_thread::broadcast(std::uint8_t channel, ENetPacket* packet)
+	{
+		_push(Command{Command_type::broadcast, nullptr, packet, channel, 0});
+	}
+	void Io_thread::multicast(gsl::span<ENetPeer* const> peers, std::uint8_t channel, ENetPacket* packet)
+	{
+		// the packet is pinned until all sends have been executed, because it might otherwise already be
+		//   sent to the first peers and freed, before the I/O thread has popped the remaining commands
+		packet->referenceCount++;
+
+		for(auto peer : peers)
+			_push(Command{Command_type::send, peer, packet, channel, 0});
+
+		_push(Command{Command_type::release, nullptr, packet, channel, 0});
+	}
+	void Io_thread::disconnect(ENetPeer* peer, std::uint32_t reason)
+	{
+		_push(Command{Command_type::disconnect, peer, nullptr, 0, reason});
+	}
+
+	void Io_thread::_push(const Command& command)
+	{
+		// commands are never dropped, so the caller waits if the I/O thread can't keep up
+		while(!_commands.try_push(command)) {
+			_wakeup.notify_one();
+			std::this_thread::yield();
+		}
+
+		_wakeup.notify_one();
+	}
+
+	void Io_thread::_run()
+	{
+		auto next_update = std::chrono::steady_clock::now();
+
+		while(true) {
+			auto command = Command{};
+			while(_commands.try_pop(command))
+				_execute(command);
+
+			// events that didn't fit into the queue before are passed on first, to preserve their order
+			while(!_overflow.empty() && _events.try_push(_overflow.front()))
+				_overflow.pop_front();
+
+			auto event = ENetEvent{};
+			auto ret   = 0;
+			while((ret = _transport->service(event)) > 0) {
+				if(!_overflow.empty() || !_events.try_push(event))
+					_overflow.push_back(event);
+			}
+
+			if(ret < 0) {
+				LOG(plog::error) << "An unknown error occured while receiving incoming packets";
+			}
+
+			_transport->flush();
+
+			auto lock = std::unique_lock{_mutex};
+			if(_shutdown && _commands.empty())
+				return;
+
+			// sleeps until the next update or until a packet is sent, but never falls more than one
+			//   update behind, e.g. after the system has been suspended
+			auto now    = std::chrono::steady_clock::now();
+			next_update = std::max(next_update + _interval, now);
+			_wakeup.wait_until(lock, next_update, [&] { return _shutdown || !_commands.empty(); });
+		}
+	}
+
+	void Io_thread::_execute(const Command& command)
+	{
+		switch(command.type) {
+			case Command_type::send:
+				if(!_transport->send(command.peer, command.channel, command.packet)) {
+					LOG(plog::warning) << "Couldn't send message, because the connection has not been "
+					                      "established yet or packet is much to large.";
+
+					// shared packets are only destroyed when their last reference is released
+					if(command.packet->referenceCount == 0)
+						enet_packet_destroy(command.packet);
+				}
+				break;
+
+			case Command_type::broadcast: _transport->broadcast(command.channel, command.packet); break;
+
+			case Command_type::release:
+				if(--command.packet->referenceCount == 0)
+					enet_packet_destroy(command.packet);
+				break;
+
+			case Command_type::disconnect: _transport->disconnect(command.peer, command.data); break;
+		}
+	}
+
+} // namespace mirrage::net::detail
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "transport.hpp"
+
+#include <mirrage/utils/ring_buffer.hpp>
+
+#include <enet/enet.h>
+#include <gsl/gsl>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+
+namespace mirrage::net::detail {
+
+	/**
+	 * @brief Services another transport on a background thread at a fixed rate, independent of the game loop.
+	 * Outgoing packets are passed to the thread through a lock-free queue and are sent immediately, and
+	 *   the received events are passed back through a second queue, that is consumed by service().
+	 * While the thread is running, the wrapped transport and its peers must not be accessed by any other
+	 *   thread. Because packets are sent asynchronously, failed sends can only be logged.
+	 */
+	class Io_thread final : public Transport {
+	  public:
+		Io_thread(std::unique_ptr<Transport>, int updates_per_second, std::size_t queue_capacity = 4096);
+		Io_thread(const Io_thread&) = delete;
+		auto operator=(const Io_thread&) -> Io_thread& = delete;
+		/// executes all queued commands and stops the thread
+		~Io_thread() override;
+
+		/// only one thread at a time
+		auto service(ENetEvent& event) -> int override { return _events.try_pop(event) ? 1 : 0; }
+		/// packets are flushed by the I/O thread
+		void flush() override {}
+
+		/// thread-safe; always takes ownership of the packet
+		auto send(ENetPeer*, std::uint8_t channel, ENetPacket*) -> bool override;
+		/// thread-safe
+		void broadcast(std::uint8_t channel, ENetPacket*) override;
+		/// thread-safe
+		void multicast(gsl::span<ENetPeer* const> peers, std::uint8_t channel, ENetPacket*) override;
+		/// thread-safe
+		void disconnect(ENetPeer*, std::uint32_t reason) override;
+
+	  private:
+		enum class Command_type : std::uint8_t { send, broadcast, release, disconnect };
+		struct Command {
+			Command_type  type;
+			ENetPeer*     peer;
+			ENetPacket*   packet;
+			std::uint8_t  channel;
+			std::uint32_t data;
+		};
+
+		std::unique_ptr<Transport>        _transport;
+		const std::chrono::microseconds   _interval;
+		util::mpmc_ring_buffer<Command>   _commands;
+		util::spsc_ring_buffer<ENetEvent> _events;
+		std::deque<ENetEvent>             _overflow; //< received events that didn't fit into _events
+
+		std::mutex              _mutex;
+		std::condition_variable _wakeup;
+		bool                    _shutdown = false;
+		std::thread             _thread;
+
+		void _push(const Command&);
+		void _run();
+		void _execute(const Command&);
+	};
+
+} // namespace mirrage::net::detail
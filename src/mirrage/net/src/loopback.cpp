@@ -0,0 +1,186 @@
+#include <mirrage/net/loopback.hpp>
+
+#include <mirrage/net/error.hpp>
+
+#include "transport.hpp"
+
+#include <mirrage/utils/log.hpp>
+
+#include <string>
+
+
+namespace mirrage::net {
+
+	Loopback_network::Loopback_network() : _state(std::make_unique<detail::Loopback_state>()) {}
+	Loopback_network::~Loopback_network()
+	{
+		MIRRAGE_INVARIANT(_state->listeners.empty(), "Loopback_network destroyed before its servers");
+	}
+
+} // namespace mirrage::net
+
+namespace mirrage::net::detail {
+
+	namespace {
+		auto make_event(ENetEventType type, ENetPeer* peer, std::uint8_t channel, std::uint32_t data)
+		{
+			auto event      = ENetEvent{};
+			event.type      = type;
+			event.peer      = peer;
+			event.channelID = channel;
+			event.data      = data;
+			event.packet    = nullptr;
+			return event;
+		}
+	} // namespace
+
+	Loopback_transport::Loopback_transport(Loopback_network& network,
+	                                       std::uint16_t     port,
+	                                       std::size_t       max_peers)
+	  : _state(*network._state), _listening(true), _port(port), _max_peers(max_peers)
+	{
+		auto lock = std::scoped_lock{_state.mutex};
+
+		if(!_state.listeners.emplace(port, this).second) {
+			const auto msg = "Loopback port " + std::to_string(port) + " is already in use.";
+			LOG(plog::warning) << msg;
+			throw std::system_error(Net_error::unspecified_network_error, msg);
+		}
+	}
+	Loopback_transport::Loopback_transport(Loopback_network& network) : _state(*network._state) {}
+
+	Loopback_transport::~Loopback_transport()
+	{
+		auto lock = std::scoped_lock{_state.mutex};
+
+		if(_listening)
+			_state.listeners.erase(_port);
+
+		for(auto& link : _state.links) {
+			for(auto side : {0, 1}) {
+				if(link->ends[side] != this)
+					continue;
+
+				if(link->connected)
+					_disconnect(*link, side, 0);
+
+				link->ends[side] = nullptr;
+			}
+		}
+
+		for(auto& event : _events) {
+			if(event.type == ENET_EVENT_TYPE_RECEIVE)
+				enet_packet_destroy(event.packet);
+		}
+	}
+
+	auto Loopback_transport::connect(std::uint16_t port) -> ENetPeer*
+	{
+		auto lock = std::scoped_lock{_state.mutex};
+
+		auto& link = *_state.links.emplace_back(std::make_unique<Loopback_link>());
+		link.peers[0].data = &link;
+		link.peers[1].data = &link;
+		link.ends[1]       = this;
+
+		auto server = _state.listeners.find(port);
+		if(server == _state.listeners.end() || server->second->_peers >= server->second->_max_peers) {
+			// the same as a connection attempt that timed out
+			_events.emplace_back(make_event(ENET_EVENT_TYPE_DISCONNECT, &link.peers[1], 0, 0));
+			return &link.peers[1];
+		}
+
+		link.ends[0]   = server->second;
+		link.connected = true;
+		server->second->_peers++;
+		server->second->_events.emplace_back(make_event(ENET_EVENT_TYPE_CONNECT, &link.peers[0], 0, 0));
+		_events.emplace_back(make_event(ENET_EVENT_TYPE_CONNECT, &link.peers[1], 0, 0));
+
+		return &link.peers[1];
+	}
+
+	auto Loopback_transport::service(ENetEvent& event) -> int
+	{
+		auto lock = std::scoped_lock{_state.mutex};
+		if(_events.empty())
+			return 0;
+
+		event = _events.front();
+		_events.pop_front();
+		return 1;
+	}
+
+	auto Loopback_transport::send(ENetPeer* peer, std::uint8_t channel, ENetPacket* packet) -> bool
+	{
+		auto& link = *static_cast<Loopback_link*>(peer->data);
+
+		auto lock = std::scoped_lock{_state.mutex};
+		return _deliver(link, _side(peer), channel, packet);
+	}
+	void Loopback_transport::broadcast(std::uint8_t channel, ENetPacket* packet)
+	{
+		packet->referenceCount++;
+		{
+			auto lock = std::scoped_lock{_state.mutex};
+			for(auto& link : _state.links) {
+				if(link->connected && link->ends[0] == this)
+					_deliver(*link, 0, channel, packet);
+			}
+		}
+
+		if(--packet->referenceCount == 0)
+			enet_packet_destroy(packet);
+	}
+	void Loopback_transport::disconnect(ENetPeer* peer, std::uint32_t reason)
+	{
+		auto& link = *static_cast<Loopback_link*>(peer->data);
+
+		auto lock = std::scoped_lock{_state.mutex};
+		if(link.connected) {
+			_disconnect(link, _side(peer), reason);
+
+			// ENet also notifies the side that initiated the disconnect
+			_events.emplace_back(make_event(ENET_EVENT_TYPE_DISCONNECT, peer, 0, 0));
+		}
+	}
+
+	auto Loopback_transport::_side(const ENetPeer* peer) const -> int
+	{
+		auto& link = *static_cast<const Loopback_link*>(peer->data);
+		return peer == &link.peers[0] ? 0 : 1;
+	}
+	auto Loopback_transport::_deliver(Loopback_link& link,
+	                                  int            from_side,
+	                                  std::uint8_t   channel,
+	                                  ENetPacket*    packet) -> bool
+	{
+		auto receiver = link.ends[1 - from_side];
+		if(!link.connected || !receiver)
+			return false;
+
+		// the packet itself is passed on, if nobody else holds a reference to it
+		if(packet->referenceCount > 0) {
+			auto flags = packet->flags & ~enet_uint32(ENET_PACKET_FLAG_NO_ALLOCATE | ENET_PACKET_FLAG_SENT);
+			packet     = enet_packet_create(packet->data, packet->dataLength, flags);
+			if(!packet)
+				return false;
+		}
+
+		auto event   = make_event(ENET_EVENT_TYPE_RECEIVE, &link.peers[1 - from_side], channel, 0);
+		event.packet = packet;
+		receiver->_events.emplace_back(event);
+		return true;
+	}
+	void Loopback_transport::_disconnect(Loopback_link& link, int from_side, std::uint32_t reason)
+	{
+		link.connected = false;
+
+		if(auto server = link.ends[0])
+			server->_peers--;
+
+		if(auto receiver = link.ends[1 - from_side])
+			receiver->_events.emplace_back(
+			        make_event(ENET_EVENT_TYPE_DISCONNECT, &link.peers[1 - from_side], 0, reason));
+	}
+
+} // namespace mirrage::net::detail
@@ -1,16 +1,72 @@
 #include <mirrage/net/message_bridge.hpp>
 
+#include <mirrage/utils/template_utils.hpp>
+
+#include <algorithm>
+
 
 namespace mirrage::net {
 
 	Message_bridge::Message_bridge(util::Message_bus& bus, Server& server, util::Str_id channel)
-	  : _mailbox(bus), _channel(server.broadcast_channel(channel)), _channel_name(channel)
+	  : _mailbox(bus), _channel(server.broadcast_channel(channel)), _channel_name(channel), _server(&server)
 	{
 	}
 
 	Message_bridge::Message_bridge(util::Message_bus& bus, Client& client, util::Str_id channel)
-	  : _mailbox(bus), _channel(client.channel(channel)), _channel_name(channel)
+	  : _mailbox(bus), _channel(client.channel(channel)), _channel_name(channel), _client(&client)
+	{
+	}
+
+	void Message_bridge::flush()
+	{
+		if(_outgoing.empty())
+			return;
+
+		// also cleared if the packet couldn't be sent, so the failed messages are dropped
+		auto data = gsl::span<gsl::byte>(_outgoing);
+		ON_EXIT { _outgoing.clear(); };
+
+		_channel.send(data);
+	}
+
+	bool Message_bridge::_report_once(Client_handle peer, std::uint16_t msg_id)
 	{
+		return _reported_msg_ids[peer].insert(msg_id).second;
+	}
+
+	void Message_bridge::_forget_disconnected_peers()
+	{
+		// the handles of disconnected peers are reused for new connections, whose errors should be reported
+		if(_reported_msg_ids.empty())
+			return;
+
+		if(_client) {
+			if(!_client->connected())
+				_reported_msg_ids.clear();
+			return;
+		}
+
+		auto& connected = _server->clients();
+		for(auto iter = _reported_msg_ids.begin(); iter != _reported_msg_ids.end();) {
+			if(std::find(connected.begin(), connected.end(), iter->first) == connected.end())
+				iter = _reported_msg_ids.erase(iter);
+			else
+				iter++;
+		}
+	}
+
+	auto Message_bridge::_reserve(std::size_t size) -> gsl::span<gsl::byte>
+	{
+		// messages that are larger than a packet are sent on their own and fragmented by ENet
+		if(!_outgoing.empty() && _outgoing.size() + size > max_packet_size)
+			flush();
+
+		if(_outgoing.capacity() < max_packet_size)
+			_outgoing.reserve(max_packet_size);
+
+		auto offset = _outgoing.size();
+		_outgoing.resize(offset + size);
+		return gsl::span<gsl::byte>(_outgoing).subspan(gsl::narrow<gsl::span<gsl::byte>::index_type>(offset));
 	}
 
 } // namespace mirrage::net
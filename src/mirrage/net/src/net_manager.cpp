@@ -2,6 +2,8 @@
 
 #include <mirrage/utils/log.hpp>
 
+#include "packet_pool.hpp"
+
 #include <enet/enet.h>
 
 namespace mirrage::net {
@@ -11,7 +13,11 @@ namespace mirrage::net {
 	Net_manager::Net_manager()
 	{
 		if((use_count++) == 0) {
-			if(enet_initialize() != 0) {
+			auto callbacks = ENetCallbacks{};
+			callbacks.malloc = &detail::Packet_pool::allocate;
+			callbacks.free   = &detail::Packet_pool::free;
+
+			if(enet_initialize_with_callbacks(ENET_VERSION, &callbacks) != 0) {
 				MIRRAGE_FAIL("An error occurred while initializing ENet.");
 			}
 		} else {
@@ -25,8 +31,11 @@ namespace mirrage::net {
 	{
 		if(--use_count == 0) {
 			enet_deinitialize();
+			detail::Packet_pool::trim();
 		}
 		MIRRAGE_INVARIANT(use_count == 0, "Race for Net_manager construction/destruction");
 	}
 
+	auto Net_manager::allocation_stats() -> Allocation_stats { return detail::Packet_pool::stats(); }
+
 } // namespace mirrage::net
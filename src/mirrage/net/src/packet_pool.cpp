@@ -0,0 +1,259 @@
+#include "packet_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+
+namespace mirrage::net::detail {
+
+	namespace {
+		constexpr auto no_size_class = std::uint32_t(0xffffffff);
+
+		/// stored in front of each block, so free() knows where the memory came from
+		struct alignas(std::max_align_t) Block_header {
+			std::uint32_t size_class;
+		};
+
+		/// placed in the payload of free blocks, behind their (still intact) header
+		struct Free_block {
+			Free_block* next;
+		};
+
+		struct Free_list {
+			Free_block* head  = nullptr;
+			std::size_t count = 0;
+
+			void push(Free_block* block)
+			{
+				block->next = head;
+				head        = block;
+				count++;
+			}
+			auto pop() -> Free_block*
+			{
+				auto block = head;
+				if(block) {
+					head = block->next;
+					count--;
+				}
+				return block;
+			}
+			void move_to(Free_list& other, std::size_t n)
+			{
+				for(; n > 0 && head; n--)
+					other.push(pop());
+			}
+		};
+
+		/// only written by the owning thread, so they don't need atomic read-modify-write operations
+		struct Counters {
+			std::atomic<std::int64_t> allocations{0};
+			std::atomic<std::int64_t> system_allocations{0};
+			std::atomic<std::int64_t> live{0};
+			std::atomic<std::int64_t> cached_bytes{0};
+		};
+		void add(std::atomic<std::int64_t>& counter, std::int64_t value)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		auto block_size(std::size_t size_class) -> std::size_t
+		{
+			return std::size_t(1) << (size_class + Packet_pool::min_class_shift);
+		}
+		auto size_class_of(std::size_t size) -> std::uint32_t
+		{
+			auto shift = Packet_pool::min_class_shift;
+			while((std::size_t(1) << shift) < size)
+				shift++;
+
+			return static_cast<std::uint32_t>(shift - Packet_pool::min_class_shift);
+		}
+		auto max_thread_cached(std::size_t size_class)
+		{
+			return std::max(Packet_pool::min_cached_blocks,
+			                Packet_pool::thread_cached_bytes_per_class / block_size(size_class));
+		}
+		auto max_shared_cached(std::size_t size_class)
+		{
+			return std::max(Packet_pool::min_cached_blocks,
+			                Packet_pool::shared_cached_bytes_per_class / block_size(size_class));
+		}
+		/// number of blocks that are exchanged between the thread caches and the shared freelists at once
+		auto batch_size(std::size_t size_class) { return max_thread_cached(size_class) / 2; }
+
+		void free_all(Free_list& list)
+		{
+			while(auto block = list.pop())
+				std::free(reinterpret_cast<Block_header*>(block) - 1);
+		}
+
+		struct Thread_cache;
+
+		struct Shared_state {
+			std::mutex                 class_mutex[Packet_pool::class_count];
+			Free_list                  classes[Packet_pool::class_count];
+			std::mutex                 thread_mutex;
+			std::vector<Thread_cache*> threads;
+			Counters                   exited_threads;
+		};
+		auto shared_state() -> Shared_state&
+		{
+			// never destroyed, because ENet memory might still be freed by the destructors of other
+			//   static or thread_local objects
+			static auto state = new Shared_state();
+			return *state;
+		}
+
+		struct Thread_cache {
+			Free_list classes[Packet_pool::class_count];
+			Counters  counters;
+
+			Thread_cache()
+			{
+				auto& shared = shared_state();
+				auto  lock   = std::scoped_lock{shared.thread_mutex};
+				shared.threads.emplace_back(this);
+			}
+			~Thread_cache()
+			{
+				auto& shared = shared_state();
+
+				for(auto i = std::size_t(0); i < Packet_pool::class_count; i++)
+					flush(i, classes[i].count);
+
+				auto lock = std::scoped_lock{shared.thread_mutex};
+				add(shared.exited_threads.allocations, counters.allocations);
+				add(shared.exited_threads.system_allocations, counters.system_allocations);
+				add(shared.exited_threads.live, counters.live);
+				add(shared.exited_threads.cached_bytes, counters.cached_bytes);
+				shared.threads.erase(std::find(shared.threads.begin(), shared.threads.end(), this));
+			}
+
+			void refill(std::size_t size_class)
+			{
+				auto& shared = shared_state();
+				auto  lock   = std::scoped_lock{shared.class_mutex[size_class]};
+				shared.classes[size_class].move_to(classes[size_class], batch_size(size_class));
+			}
+			void flush(std::size_t size_class, std::size_t count)
+			{
+				auto& shared = shared_state();
+				auto  excess = Free_list{};
+				{
+					auto  lock = std::scoped_lock{shared.class_mutex[size_class]};
+					auto& list = shared.classes[size_class];
+					classes[size_class].move_to(list, count);
+
+					auto max_cached = max_shared_cached(size_class);
+					if(list.count > max_cached)
+						list.move_to(excess, list.count - max_cached);
+				}
+
+				add(counters.cached_bytes, -std::int64_t(excess.count * block_size(size_class)));
+				free_all(excess);
+			}
+		};
+
+		thread_local auto thread_cache = Thread_cache();
+	} // namespace
+
+
+	auto Packet_pool::allocate(std::size_t size) -> void*
+	{
+		auto& cache = thread_cache;
+		add(cache.counters.allocations, 1);
+		add(cache.counters.live, 1);
+
+		auto total_size = size + sizeof(Block_header);
+		auto size_class = no_size_class;
+
+		if(total_size <= max_pooled_size) {
+			size_class = size_class_of(total_size);
+			total_size = block_size(size_class);
+
+			auto& list = cache.classes[size_class];
+			if(!list.head)
+				cache.refill(size_class);
+
+			if(auto block = list.pop()) {
+				add(cache.counters.cached_bytes, -std::int64_t(total_size));
+				return block;
+			}
+		}
+
+		add(cache.counters.system_allocations, 1);
+
+		auto memory = std::malloc(total_size);
+		if(!memory) {
+			add(cache.counters.live, -1);
+			return nullptr;
+		}
+
+		return new(memory) Block_header{size_class} + 1;
+	}
+
+	void Packet_pool::free(void* memory)
+	{
+		if(!memory)
+			return;
+
+		auto& cache = thread_cache;
+		add(cache.counters.live, -1);
+
+		auto header     = static_cast<Block_header*>(memory) - 1;
+		auto size_class = header->size_class;
+
+		if(size_class == no_size_class) {
+			std::free(header);
+			return;
+		}
+
+		auto& list = cache.classes[size_class];
+		list.push(new(memory) Free_block{nullptr});
+		add(cache.counters.cached_bytes, std::int64_t(block_size(size_class)));
+
+		if(list.count > max_thread_cached(size_class))
+			cache.flush(size_class, batch_size(size_class));
+	}
+
+	void Packet_pool::trim()
+	{
+		auto& cache  = thread_cache;
+		auto& shared = shared_state();
+
+		for(auto i = std::size_t(0); i < class_count; i++) {
+			auto lock = std::scoped_lock{shared.class_mutex[i]};
+			cache.classes[i].move_to(shared.classes[i], cache.classes[i].count);
+
+			add(cache.counters.cached_bytes, -std::int64_t(shared.classes[i].count * block_size(i)));
+			free_all(shared.classes[i]);
+		}
+	}
+
+	auto Packet_pool::stats() -> Allocation_stats
+	{
+		auto& shared = shared_state();
+		auto  lock   = std::scoped_lock{shared.thread_mutex};
+
+		auto sum = [&](std::atomic<std::int64_t> Counters::*counter) {
+			auto value = (shared.exited_threads.*counter).load(std::memory_order_relaxed);
+			for(auto thread : shared.threads)
+				value += (thread->counters.*counter).load(std::memory_order_relaxed);
+
+			// the counters of a single thread can be negative, e.g. if it frees memory allocated by another
+			return static_cast<std::uint64_t>(std::max(value, std::int64_t(0)));
+		};
+
+		return {sum(&Counters::allocations),
+		        sum(&Counters::system_allocations),
+		        sum(&Counters::live),
+		        sum(&Counters::cached_bytes)};
+	}
+
+} // namespace mirrage::net::detail
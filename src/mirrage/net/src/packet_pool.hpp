@@ -0,0 +1,54 @@
+#pragma once
+
+#include <mirrage/net/net_manager.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+
+namespace mirrage::net::detail {
+
+	/**
+	 * @brief Thread-safe allocator for ENet (packets, their data and the internal structures of hosts).
+	 * Allocations up to max_pooled_size are rounded up to the next power of two and freed blocks are kept
+	 *   in a freelist per size class, so the packets created for each send and received message are
+	 *   recycled instead of being returned to the system allocator.
+	 * Each thread has its own small freelists, that exchange blocks in batches with the shared ones, so
+	 *   packets can be created by the game thread and freed by the I/O thread (and vice versa) without
+	 *   locking on each allocation. Larger allocations are passed through to malloc.
+	 * All members are static, because ENet only accepts plain function pointers as callbacks.
+	 */
+	class Packet_pool {
+	  public:
+		static constexpr auto min_class_shift = std::size_t(6);  //< 64 byte
+		static constexpr auto max_class_shift = std::size_t(16); //< 64 KiB
+		static constexpr auto max_pooled_size = std::size_t(1) << max_class_shift;
+		static constexpr auto class_count     = max_class_shift - min_class_shift + 1;
+
+		/// the freelist of each size class keeps up to this memory per thread and shared, but at least
+		///   min_cached_blocks blocks, so large blocks can still be exchanged in batches
+		static constexpr auto thread_cached_bytes_per_class = std::size_t(64) * 1024;
+		static constexpr auto shared_cached_bytes_per_class = std::size_t(256) * 1024;
+		static constexpr auto min_cached_blocks             = std::size_t(8);
+
+		/// upper limit for the memory kept in the freelists of all size classes, i.e. about 1.4 MiB per
+		///   thread (thread_cached_bytes_per_class) and 3 MiB shared (shared_cached_bytes_per_class)
+		static constexpr auto max_cached_bytes(std::size_t bytes_per_class) -> std::size_t
+		{
+			auto bytes = std::size_t(0);
+			for(auto shift = min_class_shift; shift <= max_class_shift; shift++)
+				bytes += std::max(min_cached_blocks << shift, bytes_per_class);
+
+			return bytes;
+		}
+
+		static auto allocate(std::size_t size) -> void*;
+		static void free(void*);
+
+		/// returns the blocks cached by the calling thread and the shared freelists to the system allocator
+		static void trim();
+
+		static auto stats() -> Allocation_stats;
+	};
+
+} // namespace mirrage::net::detail
@@ -0,0 +1,498 @@
+#include <mirrage/net/replication.hpp>
+
+#include <mirrage/utils/log.hpp>
+
+
+namespace mirrage::net {
+
+	namespace {
+		using detail::Record_kind;
+
+		constexpr auto record_kind_bits = 2;
+
+		/// bits of the "more" flag and the kind of a record, without the key
+		constexpr auto record_header_bits = std::size_t(1 + record_kind_bits);
+
+		auto layout_hash(const detail::Component_types& types)
+		{
+			auto hash = detail::type_hash_t(17);
+			for(auto& type : types)
+				hash = detail::combine_type_hash(hash, type->type_hash());
+
+			return hash;
+		}
+
+		auto find_snapshot(std::deque<detail::Snapshot>& history, std::uint32_t sequence)
+		        -> detail::Snapshot*
+		{
+			auto iter = std::find_if(history.begin(), history.end(), [&](auto& snapshot) {
+				return snapshot.sequence == sequence;
+			});
+			return iter != history.end() ? &*iter : nullptr;
+		}
+
+		void write_record_header(Bit_writer&         out,
+		                         detail::Entity_key& last_key,
+		                         detail::Entity_key  key,
+		                         Record_kind         kind)
+		{
+			out.write(1, 1);
+			out.write_varint(key - last_key);
+			out.write(std::uint64_t(kind), record_kind_bits);
+			last_key = key;
+		}
+
+		/// true if any replicated component of the entity has been added, removed or modified
+		bool entity_changed(detail::Entity_key      key,
+		                    const detail::Snapshot& snapshot,
+		                    const detail::Snapshot& base)
+		{
+			for(auto i = std::size_t(0); i < snapshot.components.size(); i++) {
+				auto& comp      = *snapshot.components[i];
+				auto& base_comp = *base.components[i];
+
+				auto has = comp.has(key);
+				if(has != base_comp.has(key) || (has && !comp.equal(key, base_comp)))
+					return true;
+			}
+
+			return false;
+		}
+
+		/// upper bound for the size of the record of an entity in bits
+		auto record_bits(detail::Entity_key key, const detail::Snapshot& snapshot)
+		{
+			auto bits = record_header_bits + detail::varint_bits(key);
+			for(auto& comp : snapshot.components)
+				bits += comp->has(key) ? 2 + comp->bits(key) : 1;
+
+			return bits;
+		}
+
+		/// copies the state of the entity into the snapshot
+		void copy_entity(detail::Entity_key key, detail::Snapshot& dst, const detail::Snapshot& src)
+		{
+			dst.entities.emplace_back(key);
+			for(auto i = std::size_t(0); i < dst.components.size(); i++) {
+				if(src.components[i]->has(key))
+					dst.components[i]->copy(key, *src.components[i]);
+			}
+		}
+
+		auto create_empty_snapshot(const detail::Component_types& types, std::uint32_t sequence)
+		{
+			auto snapshot     = detail::Snapshot();
+			snapshot.sequence = sequence;
+			snapshot.components.reserve(types.size());
+			for(auto& type : types)
+				snapshot.components.emplace_back(type->create_empty());
+
+			return snapshot;
+		}
+	} // namespace
+
+
+	Replication_server::Replication_server(Server& server, ecs::Entity_manager& ecs, util::Str_id channel)
+	  : _server(server), _ecs(ecs), _channel_name(channel)
+	{
+	}
+
+	void Replication_server::update()
+	{
+		_update_clients();
+		_capture();
+
+		for(auto& [handle, client] : _clients)
+			_send(handle, client);
+	}
+
+	bool Replication_server::on_packet(util::Str_id               channel,
+	                                   Client_handle              handle,
+	                                   gsl::span<const gsl::byte> data)
+	{
+		if(channel != _channel_name)
+			return false;
+
+		auto client = _clients.find(handle);
+		if(client == _clients.end())
+			return true;
+
+		auto in       = Bit_reader(data);
+		auto sequence = std::uint32_t(in.read(32));
+		if(in.failed()) {
+			LOG(plog::warning) << "Replication ack dropped, because it is truncated.";
+			return true;
+		}
+
+		// 0 = the client lost its baseline and requests a full snapshot
+		if(sequence == 0 || sequence > client->second.acked)
+			client->second.acked = sequence;
+
+		return true;
+	}
+
+	void Replication_server::_update_clients()
+	{
+		auto& connected = _server.clients();
+
+		for(auto iter = _clients.begin(); iter != _clients.end();) {
+			if(std::find(connected.begin(), connected.end(), iter->first) == connected.end())
+				iter = _clients.erase(iter);
+			else
+				iter++;
+		}
+
+		for(auto handle : connected) {
+			if(_clients.find(handle) == _clients.end())
+				_clients.emplace(handle,
+				                 Client_state{_server.client_channel(_channel_name, handle), 0, {}, {}});
+		}
+	}
+
+	void Replication_server::_capture()
+	{
+		// 0 is reserved for "no baseline"
+		if(++_sequence == 0)
+			++_sequence;
+
+		_current = create_empty_snapshot(_component_types, _sequence);
+
+		for(auto& comp : _current.components)
+			comp->capture(_ecs, _current.entities);
+
+		auto& entities = _current.entities;
+		std::sort(entities.begin(), entities.end());
+		entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+	}
+
+	void Replication_server::_send(Client_handle handle, Client_state& client)
+	{
+		_select_records(handle, client);
+
+		auto base = client.acked != 0 ? find_snapshot(client.sent, client.acked) : nullptr;
+		auto view = create_empty_snapshot(_component_types, _current.sequence);
+
+		auto out = Bit_writer(_buffer);
+		out.write(layout_hash(_component_types), 16);
+		out.write(_current.sequence, 32);
+		out.write(base ? base->sequence : 0, 32);
+
+		auto last_key = detail::Entity_key(0);
+
+		auto write_components = [&](detail::Entity_key key, const detail::Snapshot* delta_base) {
+			for(auto i = std::size_t(0); i < _current.components.size(); i++) {
+				auto& comp = *_current.components[i];
+				if(!comp.has(key)) {
+					out.write(0, 1);
+					continue;
+				}
+
+				out.write(1, 1);
+
+				auto base_comp = delta_base ? delta_base->components[i].get() : nullptr;
+				if(base_comp && base_comp->has(key)) {
+					auto changed = !comp.equal(key, *base_comp);
+					out.write(changed ? 1 : 0, 1);
+					if(changed)
+						comp.write(key, base_comp, out);
+				} else {
+					comp.write(key, nullptr, out);
+				}
+			}
+		};
+
+		for(auto& record : _records) {
+			if(!record.send) {
+				// unchanged or deferred: the client keeps the state of the baseline
+				if(record.kind == Record_kind::update)
+					copy_entity(record.key, view, *base);
+
+				continue;
+			}
+
+			write_record_header(out, last_key, record.key, record.kind);
+
+			switch(record.kind) {
+				case Record_kind::create:
+					write_components(record.key, nullptr);
+					copy_entity(record.key, view, _current);
+					break;
+				case Record_kind::update:
+					write_components(record.key, base);
+					copy_entity(record.key, view, _current);
+					break;
+				case Record_kind::destroy: break;
+			}
+		}
+
+		out.write(0, 1);
+		out.flush();
+
+		client.channel.send(_buffer);
+
+		client.sent.emplace_back(std::move(view));
+		if(client.sent.size() > detail::max_snapshot_history)
+			client.sent.pop_front();
+	}
+
+	void Replication_server::_select_records(Client_handle handle, Client_state& client)
+	{
+		_records.clear();
+
+		auto visible = [&](detail::Entity_key key) {
+			return !_relevance_filter || _relevance_filter(handle, ecs::Entity_handle::unpack(key));
+		};
+
+		// the baseline is the state of the client after the last snapshot it acknowledged
+		auto base = client.acked != 0 ? find_snapshot(client.sent, client.acked) : nullptr;
+
+		static const auto no_entities  = std::vector<detail::Entity_key>();
+		auto&             new_entities = _current.entities;
+		auto&             old_entities = base ? base->entities : no_entities;
+
+		// both lists are sorted, so entities that only exist in one of them have been created/destroyed
+		auto new_iter = new_entities.begin();
+		auto old_iter = old_entities.begin();
+		while(new_iter != new_entities.end() || old_iter != old_entities.end()) {
+			if(old_iter == old_entities.end() || (new_iter != new_entities.end() && *new_iter < *old_iter)) {
+				if(visible(*new_iter))
+					_records.push_back({*new_iter, Record_kind::create, true});
+				new_iter++;
+
+			} else if(new_iter == new_entities.end() || *old_iter < *new_iter) {
+				_records.push_back({*old_iter, Record_kind::destroy, true});
+				old_iter++;
+
+			} else {
+				if(!visible(*new_iter)) {
+					_records.push_back({*new_iter, Record_kind::destroy, true});
+				} else {
+					auto changed = entity_changed(*new_iter, _current, *base);
+					_records.push_back({*new_iter, Record_kind::update, changed});
+				}
+
+				new_iter++;
+				old_iter++;
+			}
+		}
+
+		if(_bytes_per_tick == 0)
+			return;
+
+		// accumulate the priority of all pending entities and send them in descending order, until the
+		//   budget is exhausted. Destructions are always sent, because they are small and free resources
+		//   on the client
+		_pending.clear();
+		auto budget = _bytes_per_tick * 8;
+		auto used   = std::size_t(16 + 32 + 32 + 1);
+
+		for(auto& record : _records) {
+			if(!record.send)
+				continue;
+
+			if(record.kind == Record_kind::destroy) {
+				used += record_header_bits + detail::varint_bits(record.key);
+				continue;
+			}
+
+			auto priority = _priority ? _priority(handle, ecs::Entity_handle::unpack(record.key)) : 1.f;
+			_pending.emplace_back(record.key, client.priorities.find(record.key).get_or(0.f) + priority);
+		}
+
+		auto by_priority = _pending;
+		std::sort(by_priority.begin(), by_priority.end(), [](auto& lhs, auto& rhs) {
+			return lhs.second > rhs.second;
+		});
+
+		// the first entity is always sent, so it can't be starved by an entity that exceeds the budget
+		auto selected = std::vector<detail::Entity_key>();
+		for(auto& [key, priority] : by_priority) {
+			auto bits = record_bits(key, _current);
+			if(used + bits > budget && !selected.empty())
+				continue;
+
+			used += bits;
+			selected.emplace_back(key);
+		}
+		std::sort(selected.begin(), selected.end());
+
+		client.priorities.clear();
+		for(auto& record : _records) {
+			if(!record.send || record.kind == Record_kind::destroy)
+				continue;
+
+			if(!std::binary_search(selected.begin(), selected.end(), record.key))
+				record.send = false;
+		}
+
+		// deferred entities keep their accumulated priority
+		auto deferred_end = std::remove_if(_pending.begin(), _pending.end(), [&](auto& entry) {
+			return std::binary_search(selected.begin(), selected.end(), entry.first);
+		});
+		client.priorities.insert(_pending.begin(), deferred_end);
+	}
+
+
+	Replication_client::Replication_client(Client& client, ecs::Entity_manager& ecs, util::Str_id channel)
+	  : _channel(client.channel(channel)), _ecs(ecs), _channel_name(channel)
+	{
+	}
+
+	bool Replication_client::on_packet(util::Str_id channel, Client_handle, gsl::span<const gsl::byte> data)
+	{
+		if(channel != _channel_name)
+			return false;
+
+		auto in       = Bit_reader(data);
+		auto hash     = detail::type_hash_t(in.read(16));
+		auto sequence = std::uint32_t(in.read(32));
+		auto baseline = std::uint32_t(in.read(32));
+
+		if(in.failed())
+			return true;
+
+		if(hash != layout_hash(_component_types)) {
+			LOG(plog::warning) << "Replication snapshot dropped, because the registered components don't "
+			                      "match the server (different app version?).";
+			return true;
+		}
+
+		// unreliable packets may arrive out of order
+		if(!_history.empty() && sequence <= _history.back().sequence)
+			return true;
+
+		auto base = baseline != 0 ? find_snapshot(_history, baseline) : nullptr;
+		if(baseline != 0 && !base) {
+			LOG(plog::info) << "Replication baseline " << baseline
+			                << " is no longer known. Requesting the full state.";
+			_send_ack(0);
+			return true;
+		}
+
+		auto snapshot = create_empty_snapshot(_component_types, sequence);
+
+		auto read_components = [&](detail::Entity_key key, const detail::Snapshot* delta_base) {
+			snapshot.entities.emplace_back(key);
+			for(auto i = std::size_t(0); i < snapshot.components.size(); i++) {
+				if(in.read(1) == 0)
+					continue;
+
+				auto& comp      = *snapshot.components[i];
+				auto  base_comp = delta_base ? delta_base->components[i].get() : nullptr;
+				if(base_comp && base_comp->has(key)) {
+					if(in.read(1) != 0)
+						comp.read(key, base_comp, in);
+					else
+						comp.copy(key, *base_comp);
+				} else {
+					comp.read(key, nullptr, in);
+				}
+			}
+		};
+
+		// entities that are not part of the packet are unchanged since the baseline
+		auto base_iter = base ? base->entities.begin() : std::vector<detail::Entity_key>::iterator();
+		auto base_end  = base ? base->entities.end() : std::vector<detail::Entity_key>::iterator();
+		auto key       = detail::Entity_key(0);
+
+		while(in.read(1) != 0 && !in.failed()) {
+			key += detail::Entity_key(in.read_varint());
+			auto kind = Record_kind(in.read(record_kind_bits));
+
+			for(; base_iter != base_end && *base_iter < key; base_iter++)
+				copy_entity(*base_iter, snapshot, *base);
+
+			auto in_base = base_iter != base_end && *base_iter == key;
+			if(in_base)
+				base_iter++;
+
+			switch(kind) {
+				case Record_kind::create: read_components(key, nullptr); break;
+				case Record_kind::update: read_components(key, in_base ? base : nullptr); break;
+				case Record_kind::destroy: break;
+				default: in.fail(); break;
+			}
+		}
+
+		for(; base_iter != base_end; base_iter++)
+			copy_entity(*base_iter, snapshot, *base);
+
+		if(in.failed()) {
+			LOG(plog::warning) << "Replication snapshot " << sequence << " dropped, because it is truncated.";
+			return true;
+		}
+
+		_history.emplace_back(std::move(snapshot));
+		if(_history.size() > detail::max_snapshot_history)
+			_history.pop_front();
+
+		_send_ack(sequence);
+		return true;
+	}
+
+	void Replication_client::update()
+	{
+		if(_history.empty() || _history.back().sequence == _applied)
+			return;
+
+		auto& next = _history.back();
+		_apply(find_snapshot(_history, _applied), next);
+		_applied = next.sequence;
+	}
+
+	auto Replication_client::local_entity(ecs::Entity_handle server_entity) const -> ecs::Entity_handle
+	{
+		auto iter = _entities.find(server_entity.pack());
+		return iter != _entities.end() ? iter->second : ecs::invalid_entity;
+	}
+
+	void Replication_client::_send_ack(std::uint32_t sequence)
+	{
+		_buffer.resize(sizeof(std::uint32_t));
+
+		auto out = Bit_writer(gsl::span<gsl::byte>(_buffer));
+		out.write(sequence, 32);
+		out.flush();
+
+		_channel.send(_buffer);
+	}
+
+	void Replication_client::_apply(const detail::Snapshot* prev, const detail::Snapshot& next)
+	{
+		// destroy the mirrors of all entities that are no longer replicated
+		for(auto iter = _entities.begin(); iter != _entities.end();) {
+			if(std::binary_search(next.entities.begin(), next.entities.end(), iter->first)) {
+				iter++;
+				continue;
+			}
+
+			if(_ecs.validate(iter->second))
+				_ecs.erase(iter->second);
+
+			iter = _entities.erase(iter);
+		}
+
+		for(auto key : next.entities) {
+			auto& local   = _entities[key];
+			auto  created = !_ecs.validate(local);
+			if(created)
+				local = _ecs.emplace_empty();
+
+			auto entity = _ecs.get(local).get_or_throw();
+
+			for(auto i = std::size_t(0); i < next.components.size(); i++) {
+				auto& comp      = *next.components[i];
+				auto  prev_comp = prev && !created ? prev->components[i].get() : nullptr;
+
+				if(comp.has(key)) {
+					if(!prev_comp || !prev_comp->has(key) || !comp.equal(key, *prev_comp))
+						comp.apply(key, entity);
+
+				} else if(!created && (!prev_comp || prev_comp->has(key))) {
+					comp.erase(entity);
+				}
+			}
+		}
+	}
+
+} // namespace mirrage::net
@@ -4,6 +4,8 @@
 
 #include <mirrage/utils/container_utils.hpp>
 
+#include "transport.hpp"
+
 #include <enet/enet.h>
 
 
@@ -16,18 +18,11 @@ namespace mirrage::net {
 	  : _type(type), _hostname(std::move(hostname)), _port(port), _channels(channels)
 	{
 	}
-
-	auto Server_builder::create() -> Server
+	Server_builder::Server_builder(Loopback_network&          network,
+	                               std::uint16_t              port,
+	                               const Channel_definitions& channels)
+	  : _type(Host_type::loopback), _port(port), _channels(channels), _network(&network)
 	{
-		return {_type,
-		        _hostname,
-		        _port,
-		        _channels,
-		        _max_clients,
-		        _max_in_bandwidth,
-		        _max_out_bandwidth,
-		        _on_connect,
-		        _on_disconnect};
 	}
 
 
@@ -54,6 +49,9 @@ namespace mirrage::net {
 #endif
 					break;
 
+				case Server_builder::Host_type::loopback:
+					MIRRAGE_FAIL("Loopback servers don't have an ENet host");
+
 				case Server_builder::Host_type::named:
 					auto ec = enet_address_set_host(&address, hostname.c_str());
 					if(ec != 0) {
@@ -81,21 +79,34 @@ namespace mirrage::net {
 
 	} // namespace
 
-	Server::Server(Server_builder::Host_type  type,
-	               const std::string&         hostname,
-	               std::uint16_t              port,
-	               const Channel_definitions& channels,
-	               int                        max_clients,
-	               int                        max_in_bandwidth,
-	               int                        max_out_bandwidth,
-	               Connected_callback         on_connected,
-	               Disconnected_callback      on_disconnected)
-	  : Connection(
-	          open_server_host(
-	                  type, hostname, port, channels.size(), max_clients, max_in_bandwidth, max_out_bandwidth),
-	          channels,
-	          std::move(on_connected),
-	          std::move(on_disconnected))
+	auto Server_builder::create() -> Server
+	{
+		auto transport = std::unique_ptr<detail::Transport>();
+		if(_type == Host_type::loopback) {
+			transport = std::make_unique<detail::Loopback_transport>(
+			        *_network, _port, gsl::narrow<std::size_t>(_max_clients));
+		} else {
+			transport = std::make_unique<detail::Enet_transport>(open_server_host(_type,
+			                                                                      _hostname,
+			                                                                      _port,
+			                                                                      _channels.size(),
+			                                                                      _max_clients,
+			                                                                      _max_in_bandwidth,
+			                                                                      _max_out_bandwidth));
+		}
+
+		return {detail::decorate_transport(std::move(transport), _network_conditions, _io_updates_per_second),
+		        _channels,
+		        _on_connect,
+		        _on_disconnect};
+	}
+
+
+	Server::Server(std::unique_ptr<detail::Transport> transport,
+	               const Channel_definitions&         channels,
+	               Connected_callback                 on_connected,
+	               Disconnected_callback              on_disconnected)
+	  : Connection(std::move(transport), channels, std::move(on_connected), std::move(on_disconnected))
 	{
 	}
 
@@ -108,7 +119,7 @@ namespace mirrage::net {
 			throw std::system_error(Net_error::unknown_channel, msg);
 		}
 
-		return Channel(_host.get(), c.get_or_throw());
+		return Channel(*_transport, nullptr, c.get_or_throw());
 	}
 	auto Server::client_channel(util::Str_id channel, Client_handle client) -> Channel
 	{
@@ -119,7 +130,7 @@ namespace mirrage::net {
 			throw std::system_error(Net_error::unknown_channel, msg);
 		}
 
-		return Channel(client, c.get_or_throw());
+		return Channel(*_transport, client, c.get_or_throw());
 	}
 
 	void Server::_on_connected(Client_handle client) { _clients.emplace_back(client); }
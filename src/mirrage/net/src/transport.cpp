@@ -0,0 +1,68 @@
+#include "transport.hpp"
+
+#include "io_thread.hpp"
+
+#include <mirrage/utils/log.hpp>
+
+
+namespace mirrage::net::detail {
+
+	void Transport::multicast(gsl::span<ENetPeer* const> peers, std::uint8_t channel, ENetPacket* packet)
+	{
+		// the additional reference keeps the packet alive, until it has been passed to all peers
+		packet->referenceCount++;
+
+		for(auto peer : peers) {
+			if(!send(peer, channel, packet)) {
+				LOG(plog::warning) << "Couldn't send message to one of the peers, because the connection has "
+				                      "not been established yet or packet is much to large.";
+			}
+		}
+
+		// released to the peers it has been queued for, or destroyed if all sends failed
+		if(--packet->referenceCount == 0)
+			enet_packet_destroy(packet);
+	}
+
+	auto decorate_transport(std::unique_ptr<Transport>              transport,
+	                        const util::maybe<Network_conditions>& conditions,
+	                        int                                    io_updates_per_second)
+	        -> std::unique_ptr<Transport>
+	{
+		conditions.process([&](auto& c) {
+			transport = std::make_unique<Conditioned_transport>(std::move(transport), c);
+		});
+
+		// the conditioner is serviced by the I/O thread, so delayed packets are sent at a steady rate
+		if(io_updates_per_second > 0)
+			transport = std::make_unique<Io_thread>(std::move(transport), io_updates_per_second);
+
+		return transport;
+	}
+
+
+	Enet_transport::Enet_transport(std::unique_ptr<ENetHost, void (*)(ENetHost*)> host)
+	  : _host(std::move(host))
+	{
+	}
+
+	auto Enet_transport::service(ENetEvent& event) -> int
+	{
+		return enet_host_service(_host.get(), &event, 0);
+	}
+	void Enet_transport::flush() { enet_host_flush(_host.get()); }
+
+	auto Enet_transport::send(ENetPeer* peer, std::uint8_t channel, ENetPacket* packet) -> bool
+	{
+		return enet_peer_send(peer, channel, packet) == 0;
+	}
+	void Enet_transport::broadcast(std::uint8_t channel, ENetPacket* packet)
+	{
+		enet_host_broadcast(_host.get(), channel, packet);
+	}
+	void Enet_transport::disconnect(ENetPeer* peer, std::uint32_t reason)
+	{
+		enet_peer_disconnect(peer, reason);
+	}
+
+} // namespace mirrage::net::detail
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <mirrage/net/loopback.hpp>
+
+#include <mirrage/utils/maybe.hpp>
+#include <mirrage/utils/random.hpp>
+
+#include <enet/enet.h>
+#include <gsl/gsl>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+
+namespace mirrage::net::detail {
+
+	/**
+	 * @brief Moves packets between a Connection and its peers (ENet over UDP by default).
+	 * Transports use the ENet structures for events, packets and peers, so the rest of the module doesn't
+	 *   depend on the implementation. Peers are opaque handles, that are only dereferenced by the transport
+	 *   that created them. Packets follow the reference counting of ENet: a transport that keeps a packet
+	 *   beyond a call increments its referenceCount and destroys it when the last reference is released.
+	 * Except where noted, transports are not thread-safe.
+	 */
+	class Transport {
+	  public:
+		virtual ~Transport() = default;
+
+		/// same semantics as enet_host_service() with a timeout of 0: 1 if an event has been written to the
+		///   argument, 0 if there are no more events and <0 on errors
+		virtual auto service(ENetEvent&) -> int = 0;
+		/// sends all queued packets
+		virtual void flush() = 0;
+
+		/// returns false if the packet couldn't be queued, in which case the caller still owns it
+		virtual auto send(ENetPeer*, std::uint8_t channel, ENetPacket*) -> bool = 0;
+		/// takes ownership of the packet
+		virtual void broadcast(std::uint8_t channel, ENetPacket*) = 0;
+		/// takes ownership of the packet, that is shared between all peers; failed sends are only logged
+		virtual void multicast(gsl::span<ENetPeer* const>, std::uint8_t channel, ENetPacket*);
+		virtual void disconnect(ENetPeer*, std::uint32_t reason) = 0;
+	};
+
+	/// decorates the transport with a Conditioned_transport and/or an Io_thread, if they are enabled
+	extern auto decorate_transport(std::unique_ptr<Transport>,
+	                               const util::maybe<Network_conditions>& conditions,
+	                               int io_updates_per_second) -> std::unique_ptr<Transport>;
+
+
+	class Enet_transport final : public Transport {
+	  public:
+		explicit Enet_transport(std::unique_ptr<ENetHost, void (*)(ENetHost*)> host);
+
+		auto host() -> ENetHost& { return *_host; }
+
+		auto service(ENetEvent&) -> int override;
+		void flush() override;
+
+		auto send(ENetPeer*, std::uint8_t channel, ENetPacket*) -> bool override;
+		void broadcast(std::uint8_t channel, ENetPacket*) override;
+		void disconnect(ENetPeer*, std::uint32_t reason) override;
+
+	  private:
+		std::unique_ptr<ENetHost, void (*)(ENetHost*)> _host;
+	};
+
+
+	/// the connection between two Loopback_transports
+	struct Loopback_link {
+		/// [0] is the handle of the client on the server and [1] the handle of the server on the client
+		ENetPeer peers[2] = {};
+		/// [0] is the server and [1] the client; reset to nullptr when they are destroyed
+		Loopback_transport* ends[2] = {nullptr, nullptr};
+		bool                connected = false;
+	};
+
+	struct Loopback_state {
+		std::mutex                                             mutex;
+		std::unordered_map<std::uint16_t, Loopback_transport*> listeners;
+		/// never freed before the network itself, so peer handles stay valid after their disconnect
+		std::vector<std::unique_ptr<Loopback_link>> links;
+	};
+
+	/**
+	 * @brief Transport that passes packets directly to the event queue of a peer in the same process.
+	 * Packets are delivered in order and without loss, when the receiver calls service() the next time.
+	 * The transports of both ends may be used from different threads.
+	 */
+	class Loopback_transport final : public Transport {
+	  public:
+		/// creates a server, that accepts connections on the port
+		Loopback_transport(Loopback_network&, std::uint16_t port, std::size_t max_peers);
+		/// creates a client, that can connect() to servers on the network
+		explicit Loopback_transport(Loopback_network&);
+		~Loopback_transport() override;
+
+		/// the connection is established when both ends receive their connect event
+		auto connect(std::uint16_t port) -> ENetPeer*;
+
+		auto service(ENetEvent&) -> int override;
+		void flush() override {}
+
+		auto send(ENetPeer*, std::uint8_t channel, ENetPacket*) -> bool override;
+		void broadcast(std::uint8_t channel, ENetPacket*) override;
+		void disconnect(ENetPeer*, std::uint32_t reason) override;
+
+	  private:
+		Loopback_state&       _state;
+		bool                  _listening = false;
+		std::uint16_t         _port      = 0;
+		std::size_t           _max_peers = 0;
+		std::size_t           _peers     = 0; //< guarded by _state.mutex
+		std::deque<ENetEvent> _events;        //< guarded by _state.mutex
+
+		auto _side(const ENetPeer*) const -> int;
+		auto _deliver(Loopback_link&, int from_side, std::uint8_t channel, ENetPacket*) -> bool;
+		void _disconnect(Loopback_link&, int from_side, std::uint32_t reason);
+	};
+
+
+	/**
+	 * @brief Delays, drops and duplicates the outgoing packets of another transport, based on the
+	 *   Network_conditions.
+	 * Reliable packets are never dropped or duplicated, but delayed by a simulated retransmission and
+	 *   kept in order, like ENet would. Delayed packets are passed on by service() and flush(), so their
+	 *   timing is only as accurate as the rate these are called with.
+	 * The affected packets only depend on the seed of the Network_conditions and the sequence of packets.
+	 */
+	class Conditioned_transport final : public Transport {
+	  public:
+		using Clock = std::chrono::steady_clock;
+		/// returns the current time; can be replaced to simulate the passage of time in tests
+		using Time_source = std::function<Clock::time_point()>;
+
+		Conditioned_transport(std::unique_ptr<Transport>,
+		                      const Network_conditions&,
+		                      Time_source now = [] { return Clock::now(); });
+		~Conditioned_transport() override;
+
+		auto service(ENetEvent&) -> int override;
+		void flush() override;
+
+		auto send(ENetPeer*, std::uint8_t channel, ENetPacket*) -> bool override;
+		void broadcast(std::uint8_t channel, ENetPacket*) override;
+		void disconnect(ENetPeer*, std::uint32_t reason) override;
+
+	  private:
+		enum class Pending_type : std::uint8_t { send, broadcast, disconnect };
+		struct Pending {
+			Clock::time_point due;
+			std::uint64_t     sequence; //< keeps the order of packets that are due at the same time
+			Pending_type      type;
+			ENetPeer*         peer;
+			std::uint8_t      channel;
+			ENetPacket*       packet;
+			std::uint32_t     data;
+
+			friend bool operator>(const Pending& lhs, const Pending& rhs)
+			{
+				return lhs.due != rhs.due ? lhs.due > rhs.due : lhs.sequence > rhs.sequence;
+			}
+		};
+
+		std::unique_ptr<Transport>                                         _transport;
+		Network_conditions                                                 _conditions;
+		Time_source                                                        _now;
+		util::default_rand                                                 _random;
+		std::priority_queue<Pending, std::vector<Pending>, std::greater<>> _pending;
+		std::uint64_t                                                      _next_sequence = 0;
+		Clock::time_point                                                  _link_free_at;
+		Clock::time_point                                                  _last_due;
+		std::unordered_map<ENetPeer*, Clock::time_point>                   _last_reliable_due;
+
+		void _queue(Pending_type, ENetPeer*, std::uint8_t channel, ENetPacket*);
+		auto _chance(float probability) -> bool;
+		void _forward_due(Clock::time_point now);
+		void _forward(const Pending&);
+	};
+
+} // namespace mirrage::net::detail
@@ -0,0 +1,194 @@
+#include "transport.hpp"
+
+#include <doctest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace mirrage::net;
+using namespace std::chrono_literals;
+
+namespace {
+	/// records the packets, that are passed on by the Conditioned_transport
+	class Recording_transport final : public detail::Transport {
+	  public:
+		explicit Recording_transport(std::vector<std::string>& received) : _received(received) {}
+
+		auto service(ENetEvent&) -> int override { return 0; }
+		void flush() override {}
+
+		auto send(ENetPeer*, std::uint8_t, ENetPacket* packet) -> bool override
+		{
+			_record(packet);
+			return true;
+		}
+		void broadcast(std::uint8_t, ENetPacket* packet) override { _record(packet); }
+		void disconnect(ENetPeer*, std::uint32_t reason) override
+		{
+			_received.emplace_back("disconnect " + std::to_string(reason));
+		}
+
+	  private:
+		std::vector<std::string>& _received;
+
+		void _record(ENetPacket* packet)
+		{
+			_received.emplace_back(reinterpret_cast<const char*>(packet->data), packet->dataLength);
+			if(packet->referenceCount == 0)
+				enet_packet_destroy(packet);
+		}
+	};
+
+	/// a Conditioned_transport with a manually advanced clock
+	struct Conditioned {
+		std::vector<std::string>                         received;
+		detail::Conditioned_transport::Clock::time_point now;
+		detail::Conditioned_transport                    transport;
+		ENetPeer                                         peer = {};
+
+		explicit Conditioned(const Network_conditions& conditions)
+		  : transport(std::make_unique<Recording_transport>(received), conditions, [this] { return now; })
+		{
+		}
+
+		void send(int count, enet_uint32 flags = 0)
+		{
+			for(auto i = 0; i < count; i++) {
+				auto data = std::to_string(i);
+				transport.send(&peer, 0, enet_packet_create(data.data(), data.size(), flags));
+			}
+		}
+		void advance(std::chrono::microseconds time)
+		{
+			now += time;
+			transport.flush();
+		}
+	};
+
+	auto numbers(int count)
+	{
+		auto result = std::vector<std::string>();
+		for(auto i = 0; i < count; i++)
+			result.emplace_back(std::to_string(i));
+		return result;
+	}
+	auto sorted(std::vector<std::string> v)
+	{
+		std::sort(v.begin(), v.end(), [](auto& lhs, auto& rhs) { return std::stoi(lhs) < std::stoi(rhs); });
+		return v;
+	}
+} // namespace
+
+TEST_CASE("Conditioned_transport delays packets by the latency.")
+{
+	auto conditions    = Network_conditions{};
+	conditions.latency = 10ms;
+	auto c             = Conditioned(conditions);
+
+	c.send(3);
+	c.advance(9ms);
+	CHECK(c.received.empty());
+
+	c.advance(1ms);
+	CHECK(c.received == numbers(3));
+}
+
+TEST_CASE("Conditioned_transport drops unreliable packets with the configured probability.")
+{
+	auto conditions = Network_conditions{};
+	conditions.loss = 0.25f;
+	auto c          = Conditioned(conditions);
+
+	c.send(1000);
+	c.advance(1ms);
+	CHECK(c.received.size() > 650);
+	CHECK(c.received.size() < 850);
+}
+
+TEST_CASE("Conditioned_transport delivers all reliable packets in order, despite losses.")
+{
+	auto conditions    = Network_conditions{};
+	conditions.latency = 10ms;
+	conditions.jitter  = 5ms;
+	conditions.loss    = 0.5f;
+	auto c             = Conditioned(conditions);
+
+	c.send(100, ENET_PACKET_FLAG_RELIABLE);
+	c.advance(20ms);
+	CHECK(c.received.size() < 100); // some have been retransmitted
+
+	c.advance(1s);
+	CHECK(c.received == numbers(100));
+}
+
+TEST_CASE("Conditioned_transport drops the same packets for the same seed.")
+{
+	auto conditions = Network_conditions{};
+	conditions.loss = 0.5f;
+	conditions.seed = 7;
+	auto a          = Conditioned(conditions);
+	auto b          = Conditioned(conditions);
+	conditions.seed = 8;
+	auto other      = Conditioned(conditions);
+
+	for(auto c : {&a, &b, &other}) {
+		c->send(100);
+		c->advance(1ms);
+	}
+	CHECK(a.received == b.received);
+	CHECK(a.received != other.received);
+}
+
+TEST_CASE("Conditioned_transport reorders unreliable packets by the jitter, but not reliable ones.")
+{
+	auto conditions   = Network_conditions{};
+	conditions.jitter = 50ms;
+	auto unreliable   = Conditioned(conditions);
+	auto reliable     = Conditioned(conditions);
+
+	unreliable.send(200);
+	reliable.send(200, ENET_PACKET_FLAG_RELIABLE);
+	unreliable.advance(50ms);
+	reliable.advance(50ms);
+
+	CHECK(unreliable.received != numbers(200));
+	CHECK(sorted(unreliable.received) == numbers(200));
+	CHECK(reliable.received == numbers(200));
+}
+
+TEST_CASE("Conditioned_transport duplicates unreliable packets with the configured probability.")
+{
+	auto conditions        = Network_conditions{};
+	conditions.duplication = 1.f;
+	auto always            = Conditioned(conditions);
+	conditions.duplication = 0.5f;
+	auto sometimes         = Conditioned(conditions);
+
+	always.send(100);
+	always.advance(1ms);
+	auto expected = numbers(100);
+	auto twice    = numbers(100);
+	expected.insert(expected.end(), twice.begin(), twice.end());
+	CHECK(sorted(always.received) == sorted(expected));
+
+	sometimes.send(1000);
+	sometimes.advance(1ms);
+	CHECK(sometimes.received.size() > 1400);
+	CHECK(sometimes.received.size() < 1600);
+}
+
+TEST_CASE("Conditioned_transport passes disconnects on after the packets that have been queued before.")
+{
+	auto conditions    = Network_conditions{};
+	conditions.latency = 10ms;
+	conditions.jitter  = 10ms;
+	auto c             = Conditioned(conditions);
+
+	c.send(10, ENET_PACKET_FLAG_RELIABLE);
+	c.transport.disconnect(&c.peer, 7);
+	c.advance(1s);
+
+	REQUIRE(c.received.size() == 11);
+	CHECK(c.received.back() == "disconnect 7");
+}
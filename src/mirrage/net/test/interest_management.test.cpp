@@ -0,0 +1,194 @@
+#include <mirrage/net/interest_management.hpp>
+
+#include <mirrage/net/client.hpp>
+#include <mirrage/net/server.hpp>
+
+#include <mirrage/asset/asset_manager.hpp>
+#include <mirrage/ecs/components/transform_comp.hpp>
+#include <mirrage/utils/job_system.hpp>
+
+#include <doctest.h>
+
+#include <cstdint>
+#include <string>
+
+using namespace mirrage;
+using namespace mirrage::net;
+using ecs::components::Transform_comp;
+
+namespace {
+	constexpr auto port = std::uint16_t(4242);
+
+	/// the Entity_manager requires an Asset_manager, that is set up with the assets of the engine
+	constexpr auto test_assets = MIRRAGE_NET_TEST_ASSETS;
+
+	constexpr auto view_distance = 128.f;
+	constexpr auto hysteresis    = 16.f;
+
+	auto channels()
+	{
+		return Channel_def_builder{}.channel("replication"_strid, Channel_type::unreliable).build();
+	}
+
+	/// a server with two connected clients; only the first one has a viewer, that is placed at the origin
+	struct Interest {
+		util::job_system     jobs{0};
+		asset::Asset_manager assets{jobs, "", "mirrage", "net_tests", std::string(test_assets)};
+		ecs::Entity_manager  ecs{assets};
+		Loopback_network     network;
+		Server               server = Server::on_loopback(network, port, channels()).create();
+		Client               first  = Client_builder(network, port, channels()).connect();
+		Client               second = Client_builder(network, port, channels()).connect();
+		Interest_manager     interest{server, ecs, view_distance, hysteresis, 32.f};
+		Client_handle        client   = nullptr;
+		Client_handle        observer = nullptr;
+		ecs::Entity_handle   viewer;
+
+		Interest()
+		{
+			while(server.clients().size() < 2 || !first.connected() || !second.connected()) {
+				server.poll([](auto&&...) {});
+				first.poll([](auto&&...) {});
+				second.poll([](auto&&...) {});
+			}
+
+			client   = server.clients()[0];
+			observer = server.clients()[1];
+			viewer   = create({0, 0, 0});
+			interest.viewer(client, viewer);
+		}
+
+		auto create(glm::vec3 position) -> ecs::Entity_handle
+		{
+			auto entity = ecs.emplace_empty();
+			entity.emplace_init<Transform_comp>([&](Transform_comp& t) { t.position = position; });
+			ecs.process_queued_actions();
+			return entity.handle();
+		}
+		void move(ecs::Entity_handle entity, glm::vec3 position)
+		{
+			ecs.get(entity).get_or_throw().get<Transform_comp>().get_or_throw().position = position;
+		}
+	};
+} // namespace
+
+TEST_CASE("Interest_manager marks entities within the view distance of the viewer as relevant.")
+{
+	auto i     = Interest();
+	auto near  = i.create({50, 0, 0});
+	auto below = i.create({0, -100, -60});
+	auto edge  = i.create({view_distance + 1, 0, 0});
+	auto far   = i.create({1000, 0, 0});
+	i.interest.update();
+
+	CHECK(i.interest.relevant(i.client, i.viewer));
+	CHECK(i.interest.relevant(i.client, near));
+	CHECK(i.interest.relevant(i.client, below));
+	CHECK_FALSE(i.interest.relevant(i.client, edge));
+	CHECK_FALSE(i.interest.relevant(i.client, far));
+	CHECK(i.interest.priority(i.client, far) == 0.f);
+
+	// entering the view distance
+	i.move(far, {100, 0, 0});
+	i.interest.update();
+	CHECK(i.interest.relevant(i.client, far));
+
+	// the client without a viewer doesn't see any of them
+	CHECK_FALSE(i.interest.relevant(i.observer, near));
+	CHECK_FALSE(i.interest.relevant(i.observer, far));
+	CHECK(i.interest.priority(i.observer, near) == 0.f);
+}
+
+TEST_CASE("Interest_manager keeps relevant entities until they leave the hysteresis band.")
+{
+	auto i      = Interest();
+	auto entity = i.create({100, 0, 0});
+	i.interest.update();
+	REQUIRE(i.interest.relevant(i.client, entity));
+
+	// inside the band, the entity stays relevant
+	i.move(entity, {view_distance + hysteresis / 2, 0, 0});
+	i.interest.update();
+	CHECK(i.interest.relevant(i.client, entity));
+	i.interest.update();
+	CHECK(i.interest.relevant(i.client, entity));
+
+	// beyond the band, it is dropped
+	i.move(entity, {view_distance + hysteresis * 2, 0, 0});
+	i.interest.update();
+	CHECK_FALSE(i.interest.relevant(i.client, entity));
+
+	// and has to come within the view distance again, before it is relevant again
+	i.move(entity, {view_distance + hysteresis / 2, 0, 0});
+	i.interest.update();
+	CHECK_FALSE(i.interest.relevant(i.client, entity));
+
+	i.move(entity, {view_distance - 1, 0, 0});
+	i.interest.update();
+	CHECK(i.interest.relevant(i.client, entity));
+
+	// the viewer moving away has the same effect
+	i.move(i.viewer, {-hysteresis / 2, 0, 0});
+	i.interest.update();
+	CHECK(i.interest.relevant(i.client, entity));
+
+	i.move(i.viewer, {-hysteresis * 2, 0, 0});
+	i.interest.update();
+	CHECK_FALSE(i.interest.relevant(i.client, entity));
+}
+
+TEST_CASE("Interest_manager makes global entities relevant for all clients.")
+{
+	auto i      = Interest();
+	auto entity = i.create({10'000, 0, 0});
+	i.interest.global(entity, true);
+	i.interest.update();
+
+	CHECK(i.interest.relevant(i.client, entity));
+	CHECK(i.interest.relevant(i.observer, entity));
+	CHECK(i.interest.priority(i.client, entity) == 1.f);
+	CHECK(i.interest.priority(i.observer, entity) == 1.f);
+
+	// entities that are global and in range are only listed once, with the priority of a global entity
+	i.move(entity, {10, 0, 0});
+	i.interest.update();
+	CHECK(i.interest.priority(i.client, entity) == 1.f);
+
+	i.interest.global(entity, false);
+	i.move(entity, {10'000, 0, 0});
+	i.interest.update();
+	CHECK_FALSE(i.interest.relevant(i.client, entity));
+	CHECK_FALSE(i.interest.relevant(i.observer, entity));
+
+	// deleted entities are forgotten
+	i.interest.global(entity, true);
+	i.ecs.erase(entity);
+	i.ecs.process_queued_actions();
+	i.interest.update();
+	CHECK_FALSE(i.interest.relevant(i.observer, entity));
+}
+
+TEST_CASE("Interest_manager prioritizes near and important entities.")
+{
+	auto i         = Interest();
+	auto near      = i.create({10, 0, 0});
+	auto middle    = i.create({60, 0, 0});
+	auto far       = i.create({120, 0, 0});
+	auto important = i.create({120, 0, 0});
+	i.interest.importance(important, 4.f);
+	i.interest.update();
+
+	auto priority = [&](auto entity) { return i.interest.priority(i.client, entity); };
+	CHECK(priority(i.viewer) == 1.f);
+	CHECK(priority(i.viewer) > priority(near));
+	CHECK(priority(near) > priority(middle));
+	CHECK(priority(middle) > priority(far));
+	CHECK(priority(far) > 0.f);
+	CHECK(priority(important) == 4.f * priority(far));
+	CHECK(priority(important) > priority(near));
+
+	// resetting the importance to 1 restores the priority based on the distance alone
+	i.interest.importance(important, 1.f);
+	i.interest.update();
+	CHECK(priority(important) == priority(far));
+}
@@ -0,0 +1,138 @@
+#include "transport.hpp"
+
+#include <doctest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+using namespace mirrage::net;
+using namespace std::chrono_literals;
+
+namespace {
+	auto make_packet(std::string_view data, enet_uint32 flags = ENET_PACKET_FLAG_RELIABLE)
+	{
+		return enet_packet_create(data.data(), data.size(), flags);
+	}
+
+	/// returns the next event, after checking its type
+	auto next_event(detail::Transport& transport, ENetEventType type)
+	{
+		auto event = ENetEvent{};
+		REQUIRE(transport.service(event) == 1);
+		CHECK(event.type == type);
+		return event;
+	}
+
+	/// returns the data of all received packets and checks that there are no other events
+	auto received(detail::Transport& transport)
+	{
+		auto result = std::vector<std::string>();
+		auto event  = ENetEvent{};
+		while(transport.service(event) == 1) {
+			REQUIRE(event.type == ENET_EVENT_TYPE_RECEIVE);
+			result.emplace_back(reinterpret_cast<const char*>(event.packet->data), event.packet->dataLength);
+			enet_packet_destroy(event.packet);
+		}
+		return result;
+	}
+} // namespace
+
+TEST_CASE("Loopback_transports connect, exchange packets in order and disconnect.")
+{
+	auto network = Loopback_network();
+	auto server  = detail::Loopback_transport(network, 4242, 4);
+	auto client  = detail::Loopback_transport(network);
+
+	auto server_peer = client.connect(4242);
+	auto client_peer = next_event(server, ENET_EVENT_TYPE_CONNECT).peer;
+	CHECK(next_event(client, ENET_EVENT_TYPE_CONNECT).peer == server_peer);
+
+	for(auto data : {"a", "b", "c"})
+		CHECK(client.send(server_peer, 1, make_packet(data)));
+	CHECK(server.send(client_peer, 0, make_packet("reply")));
+
+	CHECK(received(server) == std::vector<std::string>{"a", "b", "c"});
+	CHECK(received(client) == std::vector<std::string>{"reply"});
+
+	client.disconnect(server_peer, 7);
+	CHECK(next_event(server, ENET_EVENT_TYPE_DISCONNECT).data == 7);
+	CHECK(next_event(client, ENET_EVENT_TYPE_DISCONNECT).peer == server_peer);
+
+	auto lost = make_packet("lost");
+	CHECK_FALSE(server.send(client_peer, 0, lost));
+	enet_packet_destroy(lost);
+}
+
+TEST_CASE("Loopback_transport broadcasts packets to all connected clients.")
+{
+	auto network = Loopback_network();
+	auto server  = detail::Loopback_transport(network, 4242, 4);
+	auto clients = std::vector<std::unique_ptr<detail::Loopback_transport>>();
+	for(auto i = 0; i < 3; i++) {
+		auto& client = clients.emplace_back(std::make_unique<detail::Loopback_transport>(network));
+		client->connect(4242);
+		next_event(*client, ENET_EVENT_TYPE_CONNECT);
+		next_event(server, ENET_EVENT_TYPE_CONNECT);
+	}
+
+	server.broadcast(0, make_packet("all"));
+	for(auto& client : clients)
+		CHECK(received(*client) == std::vector<std::string>{"all"});
+}
+
+TEST_CASE("Loopback_transport rejects connections to unknown or full ports.")
+{
+	auto network = Loopback_network();
+	auto server  = detail::Loopback_transport(network, 4242, 1);
+	CHECK_THROWS_AS(detail::Loopback_transport(network, 4242, 1), std::system_error);
+
+	auto unknown = detail::Loopback_transport(network);
+	unknown.connect(1234);
+	next_event(unknown, ENET_EVENT_TYPE_DISCONNECT);
+
+	auto first  = detail::Loopback_transport(network);
+	auto second = detail::Loopback_transport(network);
+	first.connect(4242);
+	second.connect(4242);
+	next_event(first, ENET_EVENT_TYPE_CONNECT);
+	next_event(second, ENET_EVENT_TYPE_DISCONNECT);
+}
+
+TEST_CASE("Conditioned Loopback_transports lose, duplicate and reorder unreliable packets.")
+{
+	auto network = Loopback_network();
+	auto server  = detail::Loopback_transport(network, 4242, 1);
+	auto client  = std::make_unique<detail::Loopback_transport>(network);
+
+	auto server_peer = client->connect(4242);
+	next_event(server, ENET_EVENT_TYPE_CONNECT);
+
+	auto now               = detail::Conditioned_transport::Clock::time_point();
+	auto conditions        = Network_conditions{};
+	conditions.jitter      = 10ms;
+	conditions.loss        = 0.2f;
+	conditions.duplication = 0.2f;
+	auto conditioned = detail::Conditioned_transport(std::move(client), conditions, [&] { return now; });
+	next_event(conditioned, ENET_EVENT_TYPE_CONNECT);
+
+	for(auto i = 0; i < 1000; i++)
+		conditioned.send(server_peer, 0, make_packet(std::to_string(i), 0));
+	now += 10ms;
+	conditioned.flush();
+
+	auto packets = received(server);
+	auto counts  = std::vector<int>(1000);
+	auto ordered = true;
+	for(auto i = std::size_t(0); i < packets.size(); i++) {
+		counts[std::size_t(std::stoi(packets[i]))]++;
+		ordered &= i == 0 || std::stoi(packets[i - 1]) <= std::stoi(packets[i]);
+	}
+
+	CHECK_FALSE(ordered);
+	CHECK(std::count(counts.begin(), counts.end(), 0) > 100);
+	CHECK(std::count(counts.begin(), counts.end(), 2) > 100);
+}
@@ -0,0 +1,124 @@
+#include "packet_pool.hpp"
+#include "transport.hpp"
+
+#include <doctest.h>
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace mirrage::net;
+using detail::Packet_pool;
+
+namespace {
+	/// keeps a reference to each sent packet, like the queues of ENet, until release() is called
+	class Queueing_transport final : public detail::Transport {
+	  public:
+		std::vector<std::pair<ENetPeer*, ENetPacket*>> queued;
+		ENetPeer*                                      unreachable = nullptr;
+
+		auto service(ENetEvent&) -> int override { return 0; }
+		void flush() override {}
+
+		auto send(ENetPeer* peer, std::uint8_t, ENetPacket* packet) -> bool override
+		{
+			if(peer == unreachable)
+				return false;
+
+			packet->referenceCount++;
+			queued.emplace_back(peer, packet);
+			return true;
+		}
+		void broadcast(std::uint8_t, ENetPacket* packet) override { enet_packet_destroy(packet); }
+		void disconnect(ENetPeer*, std::uint32_t) override {}
+
+		void release()
+		{
+			for(auto& [peer, packet] : queued) {
+				if(--packet->referenceCount == 0)
+					enet_packet_destroy(packet);
+			}
+			queued.clear();
+		}
+	};
+} // namespace
+
+TEST_CASE("Packet_pool serves repeated packet allocations from its freelists.")
+{
+	auto manager = Net_manager();
+	auto before  = Net_manager::allocation_stats();
+
+	for(auto i = 0; i < 100; i++)
+		enet_packet_destroy(enet_packet_create("data", 4, ENET_PACKET_FLAG_RELIABLE));
+
+	// the packet and its data
+	auto after = Net_manager::allocation_stats();
+	CHECK(after.allocations - before.allocations == 200);
+	CHECK(after.system_allocations - before.system_allocations <= 2);
+	CHECK(after.live == before.live);
+
+	// larger allocations are passed through to the system allocator
+	for(auto i = 0; i < 2; i++)
+		Packet_pool::free(Packet_pool::allocate(Packet_pool::max_pooled_size));
+
+	CHECK(Net_manager::allocation_stats().system_allocations - after.system_allocations == 2);
+}
+
+TEST_CASE("Packet_pool caches at most max_cached_bytes per thread and shared.")
+{
+	Packet_pool::trim();
+	auto before = Packet_pool::stats();
+
+	auto blocks = std::vector<void*>();
+	auto bytes  = std::size_t(0);
+	for(auto shift = Packet_pool::min_class_shift; shift <= Packet_pool::max_class_shift; shift++) {
+		for(auto i = 0; i < 64; i++) {
+			// rounded up to the next power of two, including the header of the block
+			blocks.emplace_back(Packet_pool::allocate((std::size_t(1) << shift) / 2 + 1));
+			bytes += std::size_t(1) << shift;
+		}
+	}
+	for(auto block : blocks)
+		Packet_pool::free(block);
+
+	auto max_cached = Packet_pool::max_cached_bytes(Packet_pool::thread_cached_bytes_per_class)
+	                  + Packet_pool::max_cached_bytes(Packet_pool::shared_cached_bytes_per_class);
+	REQUIRE(bytes > max_cached);
+
+	auto after = Packet_pool::stats();
+	CHECK(after.live == before.live);
+	CHECK(after.cached_bytes > before.cached_bytes);
+	CHECK(after.cached_bytes - before.cached_bytes <= max_cached);
+
+	Packet_pool::trim();
+	CHECK(Packet_pool::stats().cached_bytes == before.cached_bytes);
+}
+
+TEST_CASE("Transport::multicast shares a single packet between all peers.")
+{
+	auto manager   = Net_manager();
+	auto transport = Queueing_transport();
+	auto peers     = std::array<ENetPeer, 3>();
+	auto receivers = std::array<ENetPeer*, 3>{&peers[0], &peers[1], &peers[2]};
+	auto before    = Net_manager::allocation_stats();
+
+	transport.multicast(receivers, 0, enet_packet_create("data", 4, ENET_PACKET_FLAG_RELIABLE));
+	CHECK(Net_manager::allocation_stats().allocations - before.allocations == 2);
+
+	REQUIRE(transport.queued.size() == 3);
+	auto packet = transport.queued[0].second;
+	for(auto& [peer, queued_packet] : transport.queued)
+		CHECK(queued_packet == packet);
+	CHECK(packet->referenceCount == 3);
+
+	// freed by the last peer, that releases it
+	transport.release();
+	CHECK(Net_manager::allocation_stats().live == before.live);
+
+	// and immediately, if it couldn't be queued for any peer
+	transport.unreachable = receivers[0];
+	transport.multicast({receivers.data(), 1}, 0, enet_packet_create("data", 4, ENET_PACKET_FLAG_RELIABLE));
+	CHECK(transport.queued.empty());
+	CHECK(Net_manager::allocation_stats().live == before.live);
+}
@@ -0,0 +1,225 @@
+#include <mirrage/net/replication.hpp>
+
+#include <mirrage/net/client.hpp>
+#include <mirrage/net/server.hpp>
+
+#include <mirrage/asset/asset_manager.hpp>
+#include <mirrage/ecs/component.hpp>
+#include <mirrage/utils/job_system.hpp>
+
+#include <doctest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace mirrage;
+using namespace mirrage::net;
+
+namespace {
+	struct Health_comp : public ecs::Component<Health_comp> {
+		static constexpr const char* name() { return "Health"; }
+		using Component::Component;
+
+		std::int32_t health = 0;
+	};
+} // namespace
+
+namespace mirrage::net {
+	template <>
+	struct Replication_traits<Health_comp> {
+		struct state {
+			Varint<std::int32_t> health;
+		};
+		static auto save(const Health_comp& c) { return state{{c.health}}; }
+		static void load(Health_comp& c, const state& s) { c.health = s.health; }
+	};
+} // namespace mirrage::net
+
+namespace {
+	using Packet = std::vector<gsl::byte>;
+
+	constexpr auto port = std::uint16_t(4242);
+
+	/// the Entity_manager requires an Asset_manager, that is set up with the assets of the engine
+	constexpr auto test_assets = MIRRAGE_NET_TEST_ASSETS;
+
+	auto channels()
+	{
+		return Channel_def_builder{}.channel("replication"_strid, Channel_type::unreliable).build();
+	}
+
+	auto sequence(const Packet& snapshot)
+	{
+		auto in = Bit_reader(gsl::span<const gsl::byte>(snapshot));
+		in.read(16);
+		return std::uint32_t(in.read(32));
+	}
+	/// the sequence number of the snapshot, that the snapshot is a delta to; 0 = full snapshot
+	auto baseline(const Packet& snapshot)
+	{
+		auto in = Bit_reader(gsl::span<const gsl::byte>(snapshot));
+		in.read(16);
+		in.read(32);
+		return std::uint32_t(in.read(32));
+	}
+
+	/// a server and a client replicating Health_comp over the loopback
+	struct Replication {
+		util::job_system     jobs{0};
+		asset::Asset_manager assets{jobs, "", "mirrage", "net_tests", std::string(test_assets)};
+		ecs::Entity_manager  server_ecs{assets};
+		ecs::Entity_manager  client_ecs{assets};
+		Loopback_network     network;
+		Server               server = Server::on_loopback(network, port, channels()).create();
+		Client               client = Client_builder(network, port, channels()).connect();
+		Replication_server   replication_server{server, server_ecs, "replication"_strid};
+		Replication_client   replication_client{client, client_ecs, "replication"_strid};
+
+		Replication()
+		{
+			replication_server.register_component<Health_comp>();
+			replication_client.register_component<Health_comp>();
+
+			while(server.clients().empty() || !client.connected()) {
+				server.poll([](auto&&...) {});
+				client.poll([](auto&&...) {});
+			}
+		}
+
+		auto create(std::int32_t health)
+		{
+			auto entity = server_ecs.emplace_empty();
+			entity.emplace_init<Health_comp>([&](Health_comp& c) { c.health = health; });
+			server_ecs.process_queued_actions();
+			return entity.handle();
+		}
+
+		/// captures a snapshot on the server and returns the packets, that are sent to the client
+		auto send() -> std::vector<Packet>
+		{
+			server_ecs.process_queued_actions();
+			replication_server.update();
+
+			auto packets = std::vector<Packet>();
+			client.poll([&](auto, auto, auto data) { packets.emplace_back(data.begin(), data.end()); });
+			return packets;
+		}
+		/// passes the packets to the client and applies the newest snapshot
+		void receive(const std::vector<Packet>& packets)
+		{
+			for(auto& packet : packets)
+				CHECK(replication_client.on_packet("replication"_strid, nullptr, packet));
+
+			replication_client.update();
+			client_ecs.process_queued_actions();
+		}
+		/// passes the acks of the client to the server or drops them
+		void acks(bool deliver)
+		{
+			server.poll([&](auto channel, auto handle, auto data) {
+				if(deliver)
+					CHECK(replication_server.on_packet(channel, handle, data));
+			});
+		}
+		auto tick(bool deliver_acks = true)
+		{
+			auto packets = send();
+			receive(packets);
+			acks(deliver_acks);
+			return packets;
+		}
+
+		auto health(ecs::Entity_handle server_entity)
+		{
+			auto local = replication_client.local_entity(server_entity);
+			return client_ecs.get(local).get_or_throw().get<Health_comp>().get_or_throw().health;
+		}
+		void health(ecs::Entity_handle server_entity, std::int32_t health)
+		{
+			server_ecs.get(server_entity).get_or_throw().get<Health_comp>().get_or_throw().health = health;
+		}
+	};
+} // namespace
+
+TEST_CASE("Replication mirrors created, modified and destroyed entities on the client.")
+{
+	auto r      = Replication();
+	auto entity = r.create(10);
+
+	auto packets = r.tick();
+	REQUIRE(packets.size() == 1);
+	CHECK(baseline(packets[0]) == 0);
+	REQUIRE(r.client_ecs.validate(r.replication_client.local_entity(entity)));
+	CHECK(r.health(entity) == 10);
+
+	// the next snapshot is a delta to the acknowledged one
+	r.health(entity, 20);
+	packets = r.tick();
+	REQUIRE(packets.size() == 1);
+	CHECK(baseline(packets[0]) != 0);
+	CHECK(r.health(entity) == 20);
+
+	auto local = r.replication_client.local_entity(entity);
+	r.server_ecs.erase(entity);
+	r.tick();
+	CHECK_FALSE(r.client_ecs.validate(local));
+	CHECK(r.replication_client.local_entity(entity) == ecs::invalid_entity);
+}
+
+TEST_CASE("Replication falls back to a full snapshot, if the acknowledged baseline has been lost.")
+{
+	auto r      = Replication();
+	auto entity = r.create(10);
+	r.tick();
+	auto local = r.replication_client.local_entity(entity);
+
+	// the server keeps the acknowledged snapshot until it is pushed out of its history
+	auto packets = std::vector<Packet>();
+	for(auto i = std::size_t(0); i < detail::max_snapshot_history; i++) {
+		r.health(entity, std::int32_t(i));
+		packets = r.tick(false);
+		REQUIRE(packets.size() == 1);
+		CHECK(baseline(packets[0]) != 0);
+	}
+
+	r.health(entity, 42);
+	packets = r.tick();
+	REQUIRE(packets.size() == 1);
+	CHECK(baseline(packets[0]) == 0);
+	CHECK(r.health(entity) == 42);
+	CHECK(r.replication_client.local_entity(entity) == local);
+
+	// and continues with deltas, after the full snapshot has been acknowledged
+	r.health(entity, 43);
+	packets = r.tick();
+	REQUIRE(packets.size() == 1);
+	CHECK(baseline(packets[0]) != 0);
+	CHECK(r.health(entity) == 43);
+}
+
+TEST_CASE("Replication drops snapshots that arrive out of order.")
+{
+	auto r      = Replication();
+	auto entity = r.create(10);
+	r.tick();
+
+	r.health(entity, 20);
+	auto older = r.send();
+	r.health(entity, 30);
+	auto newer = r.send();
+
+	r.receive(newer);
+	CHECK(r.health(entity) == 30);
+
+	r.receive(older);
+	CHECK(r.health(entity) == 30);
+
+	// only the newer snapshot has been acknowledged and is used as the next baseline
+	r.acks(true);
+	r.health(entity, 40);
+	auto packets = r.tick();
+	REQUIRE(packets.size() == 1);
+	CHECK(baseline(packets[0]) == sequence(newer[0]));
+	CHECK(r.health(entity) == 40);
+}
@@ -11,6 +11,8 @@
 #include <mirrage/graphic/profiler.hpp>
 #include <mirrage/graphic/thread_local_command_buffer_pool.hpp>
 
+#include <mirrage/utils/frame_arena.hpp>
+#include <mirrage/utils/job_system.hpp>
 #include <mirrage/utils/min_max.hpp>
 #include <mirrage/utils/small_vector.hpp>
 
@@ -167,8 +169,9 @@ namespace mirrage::renderer {
 		auto compute_storage_buffer_layout() const { return *_compute_storage_buffer_layout; }
 		auto compute_uniform_buffer_layout() const { return *_compute_uniform_buffer_layout; }
 
-		auto scheduler() -> auto& { return _scheduler; }
-		auto scheduler_threads() const -> auto& { return _scheduler_threads; }
+		/// the engine-wide job system, with the priority of frame-critical work
+		auto scheduler() -> auto& { return _jobs.scheduler(util::Job_priority::high); }
+		auto scheduler_threads() const -> auto& { return _jobs.worker_thread_ids(); }
 
 	  private:
 		friend class Deferred_renderer;
@@ -177,6 +180,7 @@ namespace mirrage::renderer {
 		using Settings_ptr   = asset::Ptr<Renderer_settings>;
 
 		Engine&                         _engine;
+		util::job_system&               _jobs;
 		asset::Asset_manager&           _assets;
 		Settings_ptr                    _settings;
 		Pass_factories                  _pass_factories;
@@ -203,9 +207,6 @@ namespace mirrage::renderer {
 		vk::UniqueDescriptorSetLayout   _compute_uniform_buffer_layout;
 		std::unique_ptr<Asset_loaders>  _asset_loaders;
 		Render_pass_mask                _all_passes_mask;
-		std::mutex                      _scheduler_mutex;
-		std::vector<std::thread::id>    _scheduler_threads;
-		async::threadpool_scheduler     _scheduler;
 
 		class Profiler_menu;
 		class Settings_menu;
@@ -325,6 +326,10 @@ namespace mirrage::renderer {
 		auto profiler() const noexcept -> auto& { return _profiler; }
 		auto profiler() noexcept -> auto& { return _profiler; }
 
+		/// allocator for temporary data that is only valid until the end of the next draw() call
+		auto frame_arena() noexcept -> auto& { return _frame_arena; }
+		auto frame_arena() const noexcept -> auto& { return _frame_arena; }
+
 		auto picking() const noexcept -> auto& { return *_picking; }
 
 	  private:
@@ -340,6 +345,7 @@ namespace mirrage::renderer {
 		std::unique_ptr<GBuffer> _gbuffer;
 		Global_uniforms          _global_uniforms;
 		graphic::Profiler        _profiler;
+		util::frame_arena        _frame_arena;
 		float                    _time_acc      = 0.f;
 		float                    _delta_time    = 0.f;
 		std::uint32_t            _frame_counter = 0;
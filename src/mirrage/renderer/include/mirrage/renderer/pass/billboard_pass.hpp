@@ -33,7 +33,7 @@ namespace mirrage::renderer {
 		graphic::Framebuffer _framebuffer;
 		graphic::Render_pass _render_pass;
 
-		std::vector<Billboard> _queue;
+		util::frame_vector<Billboard> _queue;
 	};
 
 	class Billboard_pass_factory : public Render_pass_factory {
@@ -186,9 +186,11 @@ namespace mirrage::renderer {
 			});
 		};
 
-		auto model_view = _ecs.list<ecs::Entity_facet, Model_comp, Transform_comp>();
+		// the main thread helps with the iteration, while it waits for the workers
+		auto model_view   = _ecs.list<ecs::Entity_facet, Model_comp, Transform_comp>();
+		auto thread_count = _renderer.scheduler_threads().size() + 1;
 		async::parallel_for(_renderer.scheduler(),
-		                    ecs::entity_set_partitioner(model_view, _renderer.scheduler_threads().size()),
+		                    ecs::entity_set_partitioner(model_view, thread_count),
 		                    model_handler);
 	}
 
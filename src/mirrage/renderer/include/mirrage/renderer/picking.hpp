@@ -5,6 +5,7 @@
 
 #include <mirrage/ecs/components/transform_comp.hpp>
 #include <mirrage/ecs/entity_set_view.hpp>
+#include <mirrage/utils/frame_arena.hpp>
 #include <mirrage/utils/maybe.hpp>
 
 #include <vector>
@@ -34,11 +35,16 @@ namespace mirrage::renderer {
 
 	class Picking {
 	  public:
-		Picking(util::maybe<ecs::Entity_manager&>, util::maybe<Camera_state>& active_camera);
+		Picking(util::maybe<ecs::Entity_manager&>,
+		        util::maybe<Camera_state>& active_camera,
+		        util::frame_arena&         frame_arena);
 
-		template <typename... TagComponents>
-		std::vector<Pick_result> pick(glm::vec2                        screen_position,
-		                              util::maybe<const Camera_state&> camera = {}) const;
+		/// the result can be allocated in the frame_arena, by passing frame_allocator(), if it's
+		///   only needed until the end of the current frame
+		template <typename... TagComponents, typename Allocator = std::allocator<Pick_result>>
+		std::vector<Pick_result, Allocator> pick(glm::vec2                        screen_position,
+		                                         util::maybe<const Camera_state&> camera = {},
+		                                         const Allocator&                 allocator = {}) const;
 
 		template <typename... TagComponents>
 		util::maybe<Pick_result> pick_closest(glm::vec2                        screen_position,
@@ -46,9 +52,12 @@ namespace mirrage::renderer {
 		                                      bool                             loop   = true,
 		                                      util::maybe<const Camera_state&> camera = {}) const;
 
+		auto frame_allocator() const noexcept { return util::frame_allocator<Pick_result>(_frame_arena); }
+
 	  private:
 		util::maybe<ecs::Entity_manager&> _ecs;
 		util::maybe<Camera_state>&        _active_camera;
+		util::frame_arena&                _frame_arena;
 
 		template <typename... TagComponents, typename F>
 		void ray_march(glm::vec2 screen_position, util::maybe<const Camera_state&> camera, F&& on_hit) const;
@@ -153,11 +162,12 @@ namespace mirrage::renderer {
 		}
 	}
 
-	template <typename... TagComponents>
-	std::vector<Pick_result> Picking::pick(glm::vec2                        screen_position,
-	                                       util::maybe<const Camera_state&> camera) const
+	template <typename... TagComponents, typename Allocator>
+	std::vector<Pick_result, Allocator> Picking::pick(glm::vec2                        screen_position,
+	                                                  util::maybe<const Camera_state&> camera,
+	                                                  const Allocator&                 allocator) const
 	{
-		auto result = std::vector<Pick_result>();
+		auto result = std::vector<Pick_result, Allocator>(allocator);
 		ray_march<TagComponents...>(
 		        screen_position, camera, [&](auto hit) { result.emplace_back(std::move(hit)); });
 
@@ -175,7 +185,7 @@ namespace mirrage::renderer {
 		constexpr auto tmp_buffer_size = 16;
 
 		if(nth >= tmp_buffer_size) {
-			auto tmp_buffer = pick<TagComponents...>(screen_position, camera);
+			auto tmp_buffer = pick<TagComponents...>(screen_position, camera, frame_allocator());
 			if(tmp_buffer.size() <= std::size_t(nth))
 				return util::nothing;
 
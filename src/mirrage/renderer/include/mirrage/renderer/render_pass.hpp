@@ -8,6 +8,7 @@
 #include <mirrage/ecs/entity_handle.hpp>
 #include <mirrage/graphic/context.hpp>
 #include <mirrage/graphic/profiler.hpp>
+#include <mirrage/utils/frame_arena.hpp>
 #include <mirrage/utils/maybe.hpp>
 #include <mirrage/utils/ranges.hpp>
 #include <mirrage/utils/reflection.hpp>
@@ -65,13 +66,16 @@ namespace mirrage::renderer {
 
 	class Frame_data {
 	  public:
-		vk::CommandBuffer main_command_buffer;
-		vk::DescriptorSet global_uniform_set;
-		std::size_t       swapchain_image;
-		Camera_state*     camera;
-		Culling_mask      camera_culling_mask;
+		explicit Frame_data(util::frame_arena& arena) : arena(arena), debug_geometry_queue(arena) {}
 
-		std::vector<Debug_geometry> debug_geometry_queue;
+		util::frame_arena& arena; //< memory for temporary data, that is reset at the end of the frame
+		vk::CommandBuffer  main_command_buffer;
+		vk::DescriptorSet  global_uniform_set;
+		std::size_t        swapchain_image;
+		Camera_state*      camera;
+		Culling_mask       camera_culling_mask;
+
+		util::frame_vector<Debug_geometry> debug_geometry_queue;
 	};
 
 	class Render_pass {
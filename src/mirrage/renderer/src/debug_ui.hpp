@@ -4,6 +4,7 @@
 
 #include <mirrage/gui/debug_ui.hpp>
 #include <mirrage/gui/gui.hpp>
+#include <mirrage/utils/cpu_profiler.hpp>
 
 #include <imgui.h>
 
@@ -88,6 +89,8 @@ namespace mirrage::renderer {
 				if(ImGui::Button("Reset")) {
 					for(auto& r : _renderer_instances)
 						r->profiler().reset();
+
+					util::cpu_profiler::reset_results();
 				}
 
 #if 0
@@ -136,6 +139,37 @@ namespace mirrage::renderer {
 
 				for(auto& r : _renderer_instances)
 					print_entry(print_entry, r->profiler().results());
+
+				ImGui::Columns(1);
+				ImGui::BeginTable("cpu_perf",
+				                  {"CPU Zone", "Calls", "Curr (ms)", "Min (ms)", "Avg (ms)", "Max (ms)"},
+				                  _first_frame);
+
+				for(auto& zone : util::cpu_profiler::results()) {
+					ImGui::TextUnformatted(zone.name.data(), zone.name.data() + zone.name.size());
+					ImGui::NextColumn();
+					ImGui::Text("%zu", zone.calls);
+					ImGui::NextColumn();
+					ImGui::TextUnformatted(detail::to_fixed_str(zone.time_ms, 2).c_str());
+					ImGui::NextColumn();
+					ImGui::TextUnformatted(detail::to_fixed_str(zone.time_min_ms, 2).c_str());
+					ImGui::NextColumn();
+					ImGui::TextUnformatted(detail::to_fixed_str(zone.time_avg_ms, 2).c_str());
+					ImGui::NextColumn();
+					ImGui::TextUnformatted(detail::to_fixed_str(zone.time_max_ms, 2).c_str());
+					ImGui::NextColumn();
+				}
+
+				ImGui::Columns(1);
+				ImGui::Separator();
+				for(auto& r : _renderer_instances) {
+					auto& stats = r->frame_arena().last_frame_stats();
+					ImGui::Text("Frame arena: %zu allocations, %s/%s KiB, %zu heap allocations",
+					            stats.allocations,
+					            detail::to_fixed_str(stats.bytes / 1024.0, 1).c_str(),
+					            detail::to_fixed_str(stats.capacity / 1024.0, 1).c_str(),
+					            stats.heap_allocations);
+				}
 			}
 
 			ImGui::End();
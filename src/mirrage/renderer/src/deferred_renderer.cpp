@@ -14,6 +14,7 @@
 #include <mirrage/graphic/window.hpp>
 #include <mirrage/gui/debug_ui.hpp>
 #include <mirrage/gui/gui.hpp>
+#include <mirrage/utils/cpu_profiler.hpp>
 
 #include <glm/glm.hpp>
 #include <gsl/gsl>
@@ -111,7 +112,8 @@ namespace mirrage::renderer {
 	                      }))
 	  , _router(_router_factory(_passes))
 	  , _cameras(ecs.is_some() ? util::justPtr(&ecs.get_or_throw().list<Camera_comp>()) : util::nothing)
-	  , _picking(std::make_unique<Picking>(ecs, _active_camera))
+	  , _frame_data(_frame_arena)
+	  , _picking(std::make_unique<Picking>(ecs, _active_camera, _frame_arena))
 	{
 		if(ecs.is_some()) {
 			ecs.get_or_throw().register_component_type<Material_property_comp>();
@@ -121,9 +123,13 @@ namespace mirrage::renderer {
 		ref_embedded_assets_mirrage_renderer();
 
 		_secondary_command_buffer_pool.register_thread();
-		for(auto& thread : _factory->_scheduler_threads)
+		for(auto& thread : _factory->scheduler_threads())
 			_secondary_command_buffer_pool.register_thread(thread);
 
+		_frame_arena.register_thread();
+		for(auto& thread : _factory->scheduler_threads())
+			_frame_arena.register_thread(thread);
+
 		_write_global_uniform_descriptor_set();
 
 		factory._renderer_instances.emplace_back(this);
@@ -199,6 +205,8 @@ namespace mirrage::renderer {
 
 	void Deferred_renderer::update(util::Time dt)
 	{
+		MIRRAGE_PROFILE_ZONE("Deferred_renderer::update");
+
 		_time_acc += dt.value();
 		_delta_time    = dt.value();
 		_frame_counter = (_frame_counter + 1) % 10;
@@ -210,6 +218,8 @@ namespace mirrage::renderer {
 	}
 	void Deferred_renderer::draw()
 	{
+		MIRRAGE_PROFILE_ZONE("Deferred_renderer::draw");
+
 		if(!_noise_descriptor_set) {
 			if(_blue_noise.ready()) {
 				LOG(plog::debug) << "Noise texture loaded";
@@ -249,7 +259,9 @@ namespace mirrage::renderer {
 		_router->on_draw(_frame_data);
 		_router->post_draw(_frame_data);
 
-		_frame_data.debug_geometry_queue.clear();
+		// all containers that use the frame_arena have to be released before it's reset
+		_frame_data.debug_geometry_queue = util::frame_vector<Debug_geometry>(_frame_arena);
+		_frame_arena.reset();
 	}
 
 	void Deferred_renderer::shrink_to_fit()
@@ -500,24 +512,13 @@ namespace mirrage::renderer {
 		}
 	};
 
-	namespace {
-		auto calc_renderer_thread_count()
-		{
-#ifdef _NDEBUG
-			auto c = async::hardware_concurrency();
-			return util::max(c, c - 1u);
-#else
-			return std::size_t(1);
-#endif
-		}
-	} // namespace
-
 	Deferred_renderer_factory::Deferred_renderer_factory(
 	        Engine&                                           engine,
 	        graphic::Window&                                  window,
 	        std::vector<std::unique_ptr<Render_pass_factory>> passes,
 	        Object_router_factory                             router_factory)
 	  : _engine(engine)
+	  , _jobs(engine.jobs())
 	  , _assets(engine.assets())
 	  , _pass_factories(std::move(passes))
 	  , _router_factory(std::move(router_factory))
@@ -563,29 +564,9 @@ namespace mirrage::renderer {
 	                                                   compute_storage_buffer_layout(),
 	                                                   compute_uniform_buffer_layout()))
 	  , _all_passes_mask(util::map(_pass_factories, [&](auto& f) { return f->id(); }))
-	  , _scheduler(
-	            calc_renderer_thread_count(),
-	            [&] {
-		            auto _ = std::scoped_lock(_scheduler_mutex);
-		            _scheduler_threads.emplace_back(std::this_thread::get_id());
-	            },
-	            [&] {})
 	  , _profiler_menu(std::make_unique<Profiler_menu>(_renderer_instances))
 	  , _settings_menu(std::make_unique<Settings_menu>(*this, _window))
 	{
-		using namespace std::chrono_literals;
-
-		const auto thread_count = calc_renderer_thread_count();
-
-		while(true) {
-			{
-				auto _ = std::scoped_lock(_scheduler_mutex);
-				if(thread_count == _scheduler_threads.size())
-					break;
-			}
-			std::this_thread::sleep_for(0.1s);
-		}
-
 		auto maybe_settings = _assets.load_maybe<Renderer_settings>("cfg:renderer"_aid);
 		if(maybe_settings.is_nothing()) {
 			_settings = asset::make_ready_asset("cfg:renderer"_aid, Renderer_settings{});
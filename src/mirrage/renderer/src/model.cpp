@@ -145,6 +145,9 @@ namespace mirrage::renderer {
 
 namespace mirrage::asset {
 
+	// the material definitions are loaded through the generic (cached) Loader<Material_data>
+	static_assert(detail::is_binary_cacheable<renderer::Material_data>());
+
 	Loader<renderer::Material>::Loader(graphic::Device&        device,
 	                                   asset::Asset_manager&   assets,
 	                                   vk::Sampler             sampler,
@@ -172,6 +172,10 @@ namespace mirrage::renderer {
 
 namespace mirrage::asset {
 
+	// the handles are not cached and are resolved again from the *_id members by the loaders below
+	static_assert(detail::is_binary_cacheable<renderer::Particle_type_config>());
+	static_assert(detail::is_binary_cacheable<renderer::Particle_system_config>());
+
 	Loader<renderer::Particle_script>::Loader(graphic::Device&        device,
 	                                          vk::DescriptorSetLayout storage_buffer,
 	                                          vk::DescriptorSetLayout uniform_buffer)
@@ -205,14 +209,7 @@ namespace mirrage::asset {
 	        -> async::task<renderer::Particle_system_config>
 	{
 		auto r = renderer::Particle_system_config();
-
-		sf2::deserialize_json(
-		        in,
-		        [&](auto& msg, uint32_t row, uint32_t column) {
-			        LOG(plog::error) << "Error parsing JSON from " << in.aid().str() << " at " << row << ":"
-			                         << column << ": " << msg;
-		        },
-		        r);
+		load_cached(in, r, [](istream& s, auto& value) { return read_json(s, value); });
 
 		auto loads = std::vector<async::task<void>>();
 		loads.reserve(r.emitters.size() * 2u);
@@ -234,14 +231,7 @@ namespace mirrage::asset {
 	        -> async::task<renderer::Particle_type_config>
 	{
 		auto r = renderer::Particle_type_config();
-
-		sf2::deserialize_json(
-		        in,
-		        [&](auto& msg, uint32_t row, uint32_t column) {
-			        LOG(plog::error) << "Error parsing JSON from " << in.aid().str() << " at " << row << ":"
-			                         << column << ": " << msg;
-		        },
-		        r);
+		load_cached(in, r, [](istream& s, auto& value) { return read_json(s, value); });
 
 		auto script     = in.manager().load<renderer::Particle_script>(r.update_script_id);
 		r.update_script = script;
@@ -72,6 +72,7 @@ namespace mirrage::renderer {
 	  : Render_pass(renderer)
 	  , _entities(entities)
 	  , _render_pass(build_render_pass(renderer, src, _framebuffer))
+	  , _queue(renderer.frame_arena())
 	{
 	}
 
@@ -94,6 +95,11 @@ namespace mirrage::renderer {
 	void Billboard_pass::post_draw(Frame_data& frame)
 	{
 		auto _ = _mark_subpass(frame);
+		ON_EXIT
+		{
+			// release the memory before the frame_arena is reset
+			_queue = util::frame_vector<Billboard>(frame.arena);
+		};
 
 		if(_queue.empty())
 			return;
@@ -2,8 +2,10 @@
 
 namespace mirrage::renderer {
 
-	Picking::Picking(util::maybe<ecs::Entity_manager&> ecs, util::maybe<Camera_state>& active_camera)
-	  : _ecs(ecs), _active_camera(active_camera)
+	Picking::Picking(util::maybe<ecs::Entity_manager&> ecs,
+	                 util::maybe<Camera_state>&        active_camera,
+	                 util::frame_arena&                frame_arena)
+	  : _ecs(ecs), _active_camera(active_camera), _frame_arena(frame_arena)
 	{
 		ecs.process([](ecs::Entity_manager& e) { e.register_component_type<Pickable_radius_comp>(); });
 	}
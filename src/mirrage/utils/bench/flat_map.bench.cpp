@@ -0,0 +1,160 @@
+#include <mirrage/utils/benchmark.hpp>
+#include <mirrage/utils/flat_map.hpp>
+#include <mirrage/utils/sorted_vector.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mirrage::util;
+
+namespace {
+	using Key = std::int64_t; // the default index type of util::pool
+
+	constexpr std::size_t sizes[]    = {1000, 16000, 256000, 1000000};
+	constexpr auto        batch_size = std::size_t(1024);
+	constexpr auto        query_mask = std::size_t(4096 - 1);
+
+	/// the even numbers in [0, 2*size), so that lookups of odd numbers miss
+	auto make_keys(std::size_t size)
+	{
+		auto keys = std::vector<Key>(size);
+		for(auto i = std::size_t(0); i < size; i++)
+			keys[i] = Key(i * 2);
+
+		return keys;
+	}
+
+	auto make_queries(std::size_t size, std::size_t count)
+	{
+		auto rng     = std::mt19937_64(42);
+		auto dist    = std::uniform_int_distribution<Key>(0, Key(size * 2));
+		auto queries = std::vector<Key>(count);
+		for(auto& q : queries)
+			q = dist(rng);
+
+		return queries;
+	}
+
+	auto make_sorted_vector(const std::vector<Key>& keys)
+	{
+		auto v = sorted_vector<Key>();
+		v.reserve(keys.size());
+		for(auto k : keys)
+			v.insert(Key(k));
+
+		return v;
+	}
+
+	auto label(const char* name, std::size_t size)
+	{
+		return std::string(name) + " n=" + std::to_string(size);
+	}
+} // namespace
+
+MIRRAGE_BENCHMARK(flat_set_lookup)
+{
+	for(auto size : sizes) {
+		auto keys    = make_keys(size);
+		auto queries = make_queries(size, query_mask + 1);
+		auto vector  = make_sorted_vector(keys);
+		auto set     = flat_set<Key>(keys);
+
+		auto vector_ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				auto query = queries[i & query_mask];
+				benchmark::do_not_optimize(*std::lower_bound(vector.begin(), vector.end(), query));
+			}
+		});
+		benchmark::report(label("sorted_vector lower_bound", size), vector_ns);
+
+		auto set_ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++)
+				benchmark::do_not_optimize(*set.lower_bound(queries[i & query_mask]));
+		});
+		benchmark::report(label("flat_set lower_bound", size), set_ns);
+	}
+}
+
+MIRRAGE_BENCHMARK(flat_set_modify)
+{
+	for(auto size : sizes) {
+		auto keys    = make_keys(size);
+		auto queries = make_queries(size, query_mask + 1);
+		auto vector  = make_sorted_vector(keys);
+		auto set     = flat_set<Key>(keys);
+
+		// odd keys, so the size stays constant
+		auto vector_ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				auto key = queries[i & query_mask] | 1;
+				vector.insert(Key(key));
+				vector.erase(key);
+			}
+		});
+		benchmark::report(label("sorted_vector insert+erase", size), vector_ns);
+
+		auto set_ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				auto key = queries[i & query_mask] | 1;
+				set.insert(key);
+				set.erase(key);
+			}
+		});
+		benchmark::report(label("flat_set insert+erase", size), set_ns);
+
+		// usage pattern of the pool free list, where most changes are near the end
+		auto pool_vector_ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				auto key = Key(size * 2 - 1 - (i & 63) * 2);
+				vector.insert(Key(key));
+				vector.erase(key);
+			}
+		});
+		benchmark::report(label("sorted_vector free list", size), pool_vector_ns);
+
+		auto pool_set_ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				auto key = Key(size * 2 - 1 - (i & 63) * 2);
+				set.insert(Key(key));
+				set.erase(key);
+			}
+		});
+		benchmark::report(label("flat_set free list", size), pool_set_ns);
+	}
+}
+
+MIRRAGE_BENCHMARK(flat_set_batch_insert)
+{
+	for(auto size : sizes) {
+		auto keys  = make_keys(size);
+		auto batch = make_queries(size, batch_size);
+		for(auto& k : batch)
+			k |= 1;
+
+		auto base_vector = make_sorted_vector(keys);
+		auto base_set    = flat_set<Key>(keys);
+
+		// both include copying the initial container, so the batch doesn't accumulate
+		auto vector_ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				auto vector = base_vector;
+				for(auto k : batch)
+					vector.insert(Key(k));
+				benchmark::do_not_optimize(vector.size());
+			}
+		});
+		benchmark::report(label("sorted_vector insert x1024", size), vector_ns);
+
+		auto set_ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				auto set = base_set;
+				set.insert(batch.begin(), batch.end());
+				benchmark::do_not_optimize(set.size());
+			}
+		});
+		benchmark::report(label("flat_set batch insert x1024", size), set_ns);
+	}
+}
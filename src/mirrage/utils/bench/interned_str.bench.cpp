@@ -0,0 +1,81 @@
+#include <mirrage/utils/benchmark.hpp>
+#include <mirrage/utils/interned_str.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace mirrage::util;
+
+namespace {
+	constexpr auto key_count = std::size_t(4096);
+
+	/// similar to the resolved paths used as keys by the asset manager
+	auto make_keys()
+	{
+		auto keys = std::vector<std::string>();
+		keys.reserve(key_count);
+		for(auto i = std::size_t(0); i < key_count; i++)
+			keys.push_back("assets/models/environment/material_" + std::to_string(i) + ".msf");
+
+		return keys;
+	}
+} // namespace
+
+MIRRAGE_BENCHMARK(interned_str_lookup)
+{
+	auto keys = make_keys();
+
+	auto string_map   = std::unordered_map<std::string, std::size_t>();
+	auto interned_map = std::unordered_map<Interned_str, std::size_t>();
+	auto handles      = std::vector<Interned_str>();
+	for(auto i = std::size_t(0); i < key_count; i++) {
+		string_map.emplace(keys[i], i);
+		interned_map.emplace(Interned_str(keys[i]), i);
+		handles.push_back(Interned_str(keys[i]));
+	}
+
+	auto string_ns = benchmark::measure([&](std::size_t n) {
+		for(auto i = std::size_t(0); i < n; i++)
+			benchmark::do_not_optimize(string_map.find(keys[i % key_count]));
+	});
+	benchmark::report("std::string key", string_ns);
+
+	auto hashed_ns = benchmark::measure([&](std::size_t n) {
+		for(auto i = std::size_t(0); i < n; i++)
+			benchmark::do_not_optimize(interned_map.find(Interned_str::hashed(keys[i % key_count])));
+	});
+	benchmark::report("Interned_str key, hashed per lookup", hashed_ns);
+
+	auto handle_ns = benchmark::measure([&](std::size_t n) {
+		for(auto i = std::size_t(0); i < n; i++)
+			benchmark::do_not_optimize(interned_map.find(handles[i % key_count]));
+	});
+	benchmark::report("Interned_str key, existing handle", handle_ns);
+}
+
+MIRRAGE_BENCHMARK(interned_str_intern)
+{
+	auto keys = make_keys();
+	for(auto& k : keys)
+		benchmark::do_not_optimize(Interned_str(k));
+
+	auto ns = benchmark::measure([&](std::size_t n) {
+		for(auto i = std::size_t(0); i < n; i++)
+			benchmark::do_not_optimize(Interned_str(keys[i % key_count]));
+	});
+	benchmark::report("intern existing string", ns, "lock-free");
+
+	auto threads_ns = benchmark::measure_parallel(4, [&](int, std::size_t n) {
+		for(auto i = std::size_t(0); i < n; i++)
+			benchmark::do_not_optimize(Interned_str(keys[i % key_count]));
+	});
+	benchmark::report("intern existing string threads=4", threads_ns, "lock-free");
+
+	auto str_ns = benchmark::measure([&](std::size_t n) {
+		auto handle = Interned_str(keys.front());
+		for(auto i = std::size_t(0); i < n; i++)
+			benchmark::do_not_optimize(handle.str());
+	});
+	benchmark::report("str()", str_ns);
+}
@@ -0,0 +1,110 @@
+#include <mirrage/utils/benchmark.hpp>
+#include <mirrage/utils/job_system.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mirrage::util;
+
+namespace {
+	constexpr auto tree_depth       = 12; // 2^12 leaf jobs
+	constexpr auto parallel_for_end = std::size_t(1) << 18;
+
+	/// simulates a small amount of actual work per job
+	auto work(std::size_t i) -> float
+	{
+		auto x = float(i);
+		for(auto j = 0; j < 64; j++)
+			x = std::sqrt(x * 1.0001f + 1.f);
+		return x;
+	}
+
+	/// 1, 2, 4, ... up to the number of hardware threads (the calling thread is always one of them)
+	auto thread_counts()
+	{
+		auto counts = std::vector<std::size_t>();
+		auto max    = std::max(std::thread::hardware_concurrency(), 1u);
+		for(auto c = 1u; c < max; c *= 2)
+			counts.push_back(c);
+		counts.push_back(max);
+		return counts;
+	}
+
+	auto speedup(double serial_ns, double ns)
+	{
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "%.2fx speedup", serial_ns / ns);
+		return std::string(buffer);
+	}
+
+	/// parent jobs that spawn two children each and wait for them, like a recursive divide-and-conquer
+	void spawn_tree(job_system& jobs, int depth, std::size_t index)
+	{
+		if(depth == 0) {
+			benchmark::do_not_optimize(work(index));
+			return;
+		}
+
+		auto children = job_counter();
+		jobs.spawn(children, [&jobs, depth, index] { spawn_tree(jobs, depth - 1, index * 2); });
+		spawn_tree(jobs, depth - 1, index * 2 + 1);
+		jobs.wait(children);
+	}
+} // namespace
+
+MIRRAGE_BENCHMARK(job_system_overhead)
+{
+	for(auto threads : thread_counts()) {
+		auto jobs = job_system(threads - 1);
+
+		auto ns = benchmark::measure([&](std::size_t n) {
+			auto counter = job_counter();
+			for(auto i = std::size_t(0); i < n; i++)
+				jobs.spawn(counter, [] {});
+			jobs.wait(counter);
+		});
+
+		benchmark::report("job_system empty jobs threads=" + std::to_string(threads), ns, "per job");
+	}
+}
+
+MIRRAGE_BENCHMARK(job_system_scaling)
+{
+	auto serial_tree_ns = benchmark::measure([&](std::size_t n) {
+		for(auto i = std::size_t(0); i < n; i++)
+			for(auto leaf = std::size_t(0); leaf < (std::size_t(1) << tree_depth); leaf++)
+				benchmark::do_not_optimize(work(leaf));
+	});
+	benchmark::report("serial tree", serial_tree_ns);
+
+	auto serial_for_ns = benchmark::measure([&](std::size_t n) {
+		for(auto i = std::size_t(0); i < n; i++)
+			for(auto j = std::size_t(0); j < parallel_for_end; j++)
+				benchmark::do_not_optimize(work(j));
+	});
+	benchmark::report("serial for", serial_for_ns);
+
+	for(auto threads : thread_counts()) {
+		auto jobs  = job_system(threads - 1);
+		auto label = " threads=" + std::to_string(threads);
+
+		auto tree_ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++)
+				spawn_tree(jobs, tree_depth, 0);
+		});
+		benchmark::report("job_system tree" + label, tree_ns, speedup(serial_tree_ns, tree_ns));
+
+		auto for_ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				jobs.parallel_for(0, parallel_for_end, 1024, [](std::size_t begin, std::size_t end) {
+					for(auto j = begin; j < end; j++)
+						benchmark::do_not_optimize(work(j));
+				});
+			}
+		});
+		benchmark::report("job_system parallel_for" + label, for_ns, speedup(serial_for_ns, for_ns));
+	}
+}
@@ -0,0 +1,175 @@
+#include <mirrage/utils/benchmark.hpp>
+#include <mirrage/utils/messagebus.hpp>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mirrage::util;
+
+namespace {
+	constexpr auto max_latency_samples = std::size_t(1) << 20;
+
+	template <std::size_t PayloadSize>
+	struct Message {
+		std::int64_t                  sent_ns = 0;
+		std::array<char, PayloadSize> payload = {};
+	};
+
+	struct Response {
+		Request_id   request_id;
+		std::int64_t sent_ns = 0;
+	};
+	struct Request {
+		using response_type = Response;
+
+		Request_id   request_id;
+		std::int64_t sent_ns = 0;
+	};
+
+	auto now_ns() -> std::int64_t
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(benchmark::Clock::now().time_since_epoch())
+		        .count();
+	}
+
+	/// collects delivery latencies and formats their percentiles
+	struct Latencies {
+		std::vector<double> samples;
+
+		Latencies() { samples.reserve(max_latency_samples); }
+
+		void add(std::int64_t sent_ns)
+		{
+			if(samples.size() < max_latency_samples)
+				samples.push_back(double(now_ns() - sent_ns));
+		}
+
+		auto str() -> std::string
+		{
+			auto p50 = benchmark::percentile(samples, 0.5) / 1000.0;
+			auto p99 = benchmark::percentile(samples, 0.99) / 1000.0;
+			return "p50=" + std::to_string(p50) + "us p99=" + std::to_string(p99) + "us";
+		}
+	};
+
+	/// producers send messages, while a single consumer thread dispatches them to all subscribers
+	template <std::size_t PayloadSize>
+	void run_send_benchmark(int producers, int subscribers)
+	{
+		using Msg = Message<PayloadSize>;
+
+		auto bus       = Message_bus();
+		auto latencies = Latencies();
+		auto received  = std::size_t(0);
+
+		auto mailboxes = std::vector<std::unique_ptr<Mailbox_collection>>();
+		for(auto i = 0; i < subscribers; i++) {
+			auto& mailbox = *mailboxes.emplace_back(std::make_unique<Mailbox_collection>(bus));
+			mailbox.subscribe<Msg, 1024>([&](Msg& msg) {
+				received++;
+				latencies.add(msg.sent_ns);
+			});
+		}
+
+		auto done     = std::atomic<bool>(false);
+		auto consumer = std::thread([&] {
+			while(!done.load()) {
+				for(auto& mailbox : mailboxes)
+					mailbox->update_subscriptions();
+			}
+		});
+
+		auto ns = benchmark::measure_parallel(producers, [&](int, std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				auto msg    = Msg{};
+				msg.sent_ns = now_ns();
+				bus.send_msg(msg);
+			}
+		});
+
+		done.store(true);
+		consumer.join();
+		for(auto& mailbox : mailboxes)
+			mailbox->update_subscriptions();
+
+		benchmark::report("send size=" + std::to_string(sizeof(Msg)) + " producers="
+		                          + std::to_string(producers) + " subscribers=" + std::to_string(subscribers),
+		                  ns,
+		                  latencies.str() + " delivered=" + std::to_string(received));
+	}
+
+	template <std::size_t PayloadSize>
+	void run_send_benchmarks()
+	{
+		for(auto producers : {1, 4}) {
+			for(auto subscribers : {1, 8, 64}) {
+				run_send_benchmark<PayloadSize>(producers, subscribers);
+			}
+		}
+	}
+} // namespace
+
+
+MIRRAGE_BENCHMARK(messagebus_send_small)
+{
+	run_send_benchmarks<8>();
+}
+
+MIRRAGE_BENCHMARK(messagebus_send_large)
+{
+	run_send_benchmarks<1024>();
+}
+
+MIRRAGE_BENCHMARK(messagebus_send_bulk)
+{
+	using Msg = Message<8>;
+
+	constexpr auto batch_size = std::size_t(1024);
+
+	auto bus       = Message_bus();
+	auto mailbox   = Mailbox_collection(bus);
+	auto latencies = Latencies();
+	mailbox.subscribe_batched<Msg, batch_size>(batch_size, [&](gsl::span<const Msg> msgs) {
+		for(auto& msg : msgs)
+			latencies.add(msg.sent_ns);
+	});
+
+	auto batch = std::vector<Msg>(batch_size);
+
+	auto ns = benchmark::measure([&](std::size_t n) {
+		for(auto i = std::size_t(0); i < n; i += batch_size) {
+			auto sent_ns = now_ns();
+			for(auto& msg : batch)
+				msg.sent_ns = sent_ns;
+
+			bus.send_bulk(gsl::span<const Msg>(batch));
+			mailbox.update_subscriptions();
+		}
+	});
+
+	benchmark::report("send_bulk+drain batch=" + std::to_string(batch_size), ns, latencies.str());
+}
+
+MIRRAGE_BENCHMARK(messagebus_request_response)
+{
+	auto bus       = Message_bus();
+	auto server    = Mailbox_collection(bus);
+	auto client    = Mailbox_collection(bus);
+	auto latencies = Latencies();
+
+	server.subscribe_to([](Request& request) { return Response{request.request_id, request.sent_ns}; });
+
+	auto ns = benchmark::measure([&](std::size_t n) {
+		for(auto i = std::size_t(0); i < n; i++) {
+			auto response = client.send<Request>(create_request_id(), now_ns());
+			server.update_subscriptions();
+			client.update_subscriptions();
+			latencies.add(response.get().sent_ns);
+		}
+	});
+
+	benchmark::report("request/response round trip", ns, latencies.str());
+}
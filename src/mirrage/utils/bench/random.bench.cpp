@@ -0,0 +1,126 @@
+#include <mirrage/utils/benchmark.hpp>
+#include <mirrage/utils/random.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mirrage::util;
+
+namespace {
+	constexpr auto batch_size = std::ptrdiff_t(1024);
+
+	template <class Rng>
+	void run_bits_benchmark(const char* name, Rng rng)
+	{
+		auto ns = benchmark::measure([&](std::size_t n) {
+			auto sum = typename Rng::result_type(0);
+			for(auto i = std::size_t(0); i < n; i++)
+				sum += rng();
+			benchmark::do_not_optimize(sum);
+		});
+
+		benchmark::report(name, ns, std::to_string(sizeof(Rng)) + " bytes state");
+	}
+
+	/// the way the engine sampled random values before: a std distribution per value
+	template <class Rng, class Distribution>
+	void run_distribution_benchmark(const char* name, Rng rng, Distribution dist)
+	{
+		auto values = std::vector<float>(batch_size);
+
+		auto ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				for(auto& v : values)
+					v = dist(rng);
+				benchmark::do_not_optimize(values.data());
+			}
+		});
+
+		benchmark::report(name, ns / batch_size, "per value");
+	}
+
+	template <class Rng, class F>
+	void run_batch_benchmark(const char* name, Rng& rng, F&& generate)
+	{
+		auto values = std::vector<float>(batch_size);
+
+		auto ns = benchmark::measure([&](std::size_t n) {
+			for(auto i = std::size_t(0); i < n; i++) {
+				generate(rng, values);
+				benchmark::do_not_optimize(values.data());
+			}
+		});
+
+		benchmark::report(name, ns / batch_size, "per value");
+	}
+} // namespace
+
+MIRRAGE_BENCHMARK(random_bits)
+{
+	run_bits_benchmark("std::mt19937_64", std::mt19937_64(42));
+	run_bits_benchmark("xoshiro256ss", xoshiro256ss(42));
+	run_bits_benchmark("pcg32", pcg32(42));
+}
+
+MIRRAGE_BENCHMARK(random_seeding)
+{
+	auto ns = benchmark::measure([&](std::size_t n) {
+		for(auto i = std::size_t(0); i < n; i++) {
+			auto rng = std::mt19937_64(random_seed_seq::get_instance());
+			benchmark::do_not_optimize(rng);
+		}
+	});
+	benchmark::report("std::mt19937_64", ns);
+
+	ns = benchmark::measure([&](std::size_t n) {
+		for(auto i = std::size_t(0); i < n; i++) {
+			auto rng = xoshiro256ss(random_seed_seq::get_instance());
+			benchmark::do_not_optimize(rng);
+		}
+	});
+	benchmark::report("xoshiro256ss", ns);
+
+	auto source = xoshiro256ss(42);
+
+	ns = benchmark::measure([&](std::size_t n) {
+		for(auto i = std::size_t(0); i < n; i++) {
+			auto rng = source.fork();
+			benchmark::do_not_optimize(rng);
+		}
+    });
+	benchmark::report("xoshiro256ss::fork", ns);
+}
+
+MIRRAGE_BENCHMARK(random_uniform_float)
+{
+	run_distribution_benchmark(
+	        "std::mt19937_64", std::mt19937_64(42), std::uniform_real_distribution<float>(0.f, 1.f));
+	run_distribution_benchmark(
+	        "xoshiro256ss", xoshiro256ss(42), std::uniform_real_distribution<float>(0.f, 1.f));
+
+	auto rng    = xoshiro256ss(42);
+	auto rng_x4 = xoshiro256ss_x4(rng);
+	run_batch_benchmark("generate_uniform xoshiro256ss", rng, [](auto& r, auto& v) {
+		generate_uniform(r, v);
+	});
+	run_batch_benchmark("generate_uniform xoshiro256ss_x4", rng_x4, [](auto& r, auto& v) {
+		generate_uniform(r, v);
+	});
+}
+
+MIRRAGE_BENCHMARK(random_normal_float)
+{
+	run_distribution_benchmark(
+	        "std::mt19937_64", std::mt19937_64(42), std::normal_distribution<float>(0.f, 1.f));
+	run_distribution_benchmark("xoshiro256ss", xoshiro256ss(42), std::normal_distribution<float>(0.f, 1.f));
+
+	auto rng    = xoshiro256ss(42);
+	auto rng_x4 = xoshiro256ss_x4(rng);
+	run_batch_benchmark("generate_normal xoshiro256ss", rng, [](auto& r, auto& v) {
+		generate_normal(r, v);
+	});
+	run_batch_benchmark("generate_normal xoshiro256ss_x4", rng_x4, [](auto& r, auto& v) {
+		generate_normal(r, v);
+	});
+}
@@ -0,0 +1,106 @@
+#include <mirrage/utils/benchmark.hpp>
+#include <mirrage/utils/ring_buffer.hpp>
+
+#include <concurrentqueue.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+using namespace mirrage::util;
+
+namespace {
+	constexpr auto capacity   = std::size_t(1024);
+	constexpr auto batch_size = std::size_t(32);
+
+	using Item = std::uint64_t;
+
+	template <class Queue>
+	struct Ring_buffer_adapter {
+		Queue queue{capacity};
+
+		auto push(Item i) { return queue.try_push(i); }
+		auto push_bulk(const Item* items, std::size_t count) { return queue.push_bulk(items, count); }
+		auto pop(Item& out) { return queue.try_pop(out); }
+		auto pop_bulk(Item* out, std::size_t max_count) { return queue.pop_bulk(out, max_count); }
+	};
+
+	// the unbounded queue, that is used for the message bus and log sink
+	struct Concurrent_queue_adapter {
+		moodycamel::ConcurrentQueue<Item> queue{capacity};
+
+		auto push(Item i) { return queue.enqueue(i); }
+		auto push_bulk(const Item* items, std::size_t count)
+		{
+			return queue.enqueue_bulk(items, count) ? count : std::size_t(0);
+		}
+		auto pop(Item& out) { return queue.try_dequeue(out); }
+		auto pop_bulk(Item* out, std::size_t max_count) { return queue.try_dequeue_bulk(out, max_count); }
+	};
+
+	/// producers push n items each, while the consumers pop them
+	/// consumers have to be a divisor of producers, so the items can be split evenly between them
+	template <class Queue>
+	void run_contention_benchmark(const char* name, int producers, int consumers, bool bulk)
+	{
+		auto queue = Queue();
+
+		auto ns = benchmark::measure_parallel(producers + consumers, [&](int thread, std::size_t n) {
+			auto items = std::array<Item, batch_size>();
+
+			if(thread < producers) {
+				for(auto i = std::size_t(0); i < n;) {
+					auto pushed = bulk ? queue.push_bulk(items.data(), std::min(batch_size, n - i))
+					                   : std::size_t(queue.push(Item(i)));
+					if(pushed == 0)
+						std::this_thread::yield(); // in case there are more threads than cores
+
+					i += pushed;
+				}
+
+			} else {
+				auto sum   = Item(0);
+				auto count = n * std::size_t(producers / consumers);
+				for(auto i = std::size_t(0); i < count;) {
+					auto popped = bulk ? queue.pop_bulk(items.data(), std::min(batch_size, count - i))
+					                   : std::size_t(queue.pop(items[0]));
+					if(popped == 0)
+						std::this_thread::yield();
+
+					sum += items[0];
+					i += popped;
+				}
+				benchmark::do_not_optimize(sum);
+			}
+		});
+
+		// time per transferred item, instead of per operation of each thread
+		ns = ns * (producers + consumers) / producers;
+
+		auto label = std::string(name) + (bulk ? " bulk" : "");
+		label += " producers=" + std::to_string(producers) + " consumers=" + std::to_string(consumers);
+		benchmark::report(label, ns);
+	}
+} // namespace
+
+MIRRAGE_BENCHMARK(ring_buffer_spsc)
+{
+	for(auto bulk : {false, true}) {
+		run_contention_benchmark<Ring_buffer_adapter<spsc_ring_buffer<Item>>>("spsc_ring_buffer", 1, 1, bulk);
+		run_contention_benchmark<Ring_buffer_adapter<mpmc_ring_buffer<Item>>>("mpmc_ring_buffer", 1, 1, bulk);
+		run_contention_benchmark<Concurrent_queue_adapter>("moodycamel::ConcurrentQueue", 1, 1, bulk);
+	}
+}
+
+MIRRAGE_BENCHMARK(ring_buffer_mpmc)
+{
+	for(auto bulk : {false, true}) {
+		for(auto [producers, consumers] : {std::pair{2, 1}, {2, 2}, {4, 1}, {4, 4}}) {
+			run_contention_benchmark<Ring_buffer_adapter<mpmc_ring_buffer<Item>>>(
+			        "mpmc_ring_buffer", producers, consumers, bulk);
+			run_contention_benchmark<Concurrent_queue_adapter>(
+			        "moodycamel::ConcurrentQueue", producers, consumers, bulk);
+		}
+	}
+}
@@ -0,0 +1,77 @@
+#include <mirrage/utils/benchmark.hpp>
+#include <mirrage/utils/sharded_map.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace mirrage::util;
+
+namespace {
+	constexpr auto key_count = 1024;
+
+	auto make_keys()
+	{
+		auto keys = std::vector<std::string>();
+		keys.reserve(key_count);
+		for(auto i = 0; i < key_count; i++)
+			keys.emplace_back("materials/generated/material_" + std::to_string(i) + ".json");
+
+		return keys;
+	}
+
+	// the previous Asset_container implementation: one exclusive lock for every lookup
+	struct Locked_map {
+		std::mutex                                            mutex;
+		std::unordered_map<std::string, std::shared_ptr<int>> map;
+
+		auto get(const std::string& key)
+		{
+			auto lock = std::scoped_lock{mutex};
+			return map.find(key)->second;
+		}
+	};
+
+	struct Sharded_map {
+		sharded_unordered_map<std::string, std::shared_ptr<int>> map;
+
+		auto get(const std::string& key)
+		{
+			auto result = std::shared_ptr<int>();
+			map.visit(key, [&](auto& v) { result = v; });
+			return result;
+		}
+	};
+
+	template <class Map, class Insert>
+	void run_contention_benchmark(const char* name, Insert&& insert)
+	{
+		auto keys = make_keys();
+		auto map  = Map();
+		for(auto& k : keys)
+			insert(map, k);
+
+		for(auto threads : {1, 2, 4, 8, 16}) {
+			auto ns = benchmark::measure_parallel(threads, [&](int thread, std::size_t n) {
+				for(auto i = std::size_t(0); i < n; i++) {
+					auto value = map.get(keys[(i * 7 + std::size_t(thread) * 13) % keys.size()]);
+					benchmark::do_not_optimize(value);
+				}
+			});
+
+			benchmark::report(std::string(name) + " threads=" + std::to_string(threads), ns);
+		}
+	}
+} // namespace
+
+MIRRAGE_BENCHMARK(sharded_map_cache_hits)
+{
+	run_contention_benchmark<Locked_map>("mutex + unordered_map", [](auto& m, auto& key) {
+		m.map.emplace(key, std::make_shared<int>(42));
+	});
+	run_contention_benchmark<Sharded_map>("sharded_map", [](auto& m, auto& key) {
+		m.map.modify(key, [&](auto& map) { map.emplace(key, std::make_shared<int>(42)); });
+	});
+}
@@ -0,0 +1,58 @@
+#include <mirrage/utils/benchmark.hpp>
+#include <mirrage/utils/md5.hpp>
+#include <mirrage/utils/xxhash.hpp>
+
+#include <cstdio>
+#include <string>
+
+using namespace mirrage::util;
+
+namespace {
+	constexpr std::size_t input_sizes[] = {16, 256, 4 * 1024, 1024 * 1024};
+
+	auto make_input(std::size_t size)
+	{
+		auto str = std::string(size, '\0');
+		for(auto i = std::size_t(0); i < size; i++)
+			str[i] = char((i * 31 + 7) & 0xff);
+
+		return str;
+	}
+
+	auto throughput(std::size_t size, double ns)
+	{
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "%.2f GB/s", double(size) / ns);
+		return std::string(buffer);
+	}
+
+	template <class F>
+	void run_hash_benchmark(const char* name, F&& hash)
+	{
+		for(auto size : input_sizes) {
+			auto input = make_input(size);
+
+			auto ns = benchmark::measure([&](std::size_t n) {
+				for(auto i = std::size_t(0); i < n; i++)
+					benchmark::do_not_optimize(hash(input));
+			});
+
+			benchmark::report(std::string(name) + " " + std::to_string(size) + "B", ns, throughput(size, ns));
+		}
+	}
+} // namespace
+
+MIRRAGE_BENCHMARK(hash_throughput)
+{
+	run_hash_benchmark("md5", [](const std::string& in) { return md5(in); });
+	run_hash_benchmark("xxh3_64", [](const std::string& in) { return xxh3_64(in); });
+	run_hash_benchmark("xxh3_128", [](const std::string& in) { return xxh3_128(in); });
+
+	// overhead of the streaming API for small chunks
+	run_hash_benchmark("xxh3_hasher 1KiB chunks", [](const std::string& in) {
+		auto hasher = xxh3_hasher();
+		for(auto i = std::size_t(0); i < in.size(); i += 1024)
+			hasher.update(std::string_view(in).substr(i, 1024));
+		return hasher.digest128();
+	});
+}
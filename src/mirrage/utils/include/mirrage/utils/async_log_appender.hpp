@@ -0,0 +1,93 @@
+/** plog appender that writes on a background thread *************************
+ *                                                                           *
+ * Copyright (c) 2020 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <mirrage/utils/ring_buffer.hpp>
+
+#include <plog/Log.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace mirrage::util {
+
+	/**
+	 * @brief Equivalent of plog::TxtFormatter, that prints the original time and thread of records
+	 *          that are written through an async_log_appender, instead of the ones of its background thread.
+	 */
+	class log_formatter {
+	  public:
+		static auto header() -> plog::util::nstring { return {}; }
+		static auto format(const plog::Record&) -> plog::util::nstring;
+	};
+
+	/**
+	 * @brief A plog appender that copies the records into a bounded lock-free queue and forwards them
+	 *          to its child appenders on a background thread.
+	 * Formatting and I/O is done by the background thread, so logging never blocks the caller,
+	 *   except for fatal records that wait until everything has been written (because they are
+	 *   usually followed by std::abort).
+	 * If the queue is full new records (except fatal ones) are dropped and reported later through a warning.
+	 * The child appenders should use log_formatter to print the correct time and thread ids.
+	 */
+	class async_log_appender : public plog::IAppender {
+	  public:
+		/// max_queued_records is rounded up to the next power of two
+		explicit async_log_appender(std::size_t max_queued_records = 8192);
+		async_log_appender(const async_log_appender&) = delete;
+		auto operator=(const async_log_appender&) -> async_log_appender& = delete;
+		/// writes all remaining records before it returns
+		~async_log_appender() override;
+
+		/// not thread-safe, has to be called before the first record is written
+		auto add_appender(plog::IAppender*) -> async_log_appender&;
+
+		void write(const plog::Record&) override;
+
+		/// blocks until all records that have been written until now are passed to the child appenders
+		void flush();
+
+		/// number of records that have been dropped because the queue was full
+		auto dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+
+	  private:
+		struct Entry {
+			plog::Severity      severity;
+			plog::util::Time    time;
+			unsigned int        tid;
+			std::string         func;
+			std::size_t         line;
+			const char*         file;
+			const void*         object;
+			int                 instance_id;
+			plog::util::nstring message;
+		};
+
+		std::vector<plog::IAppender*> _appenders;
+		mpmc_ring_buffer<Entry>       _queue;
+		std::atomic<std::size_t>      _queued{0}; //< records that have been written but not yet processed
+		std::atomic<std::uint64_t>    _dropped{0};
+		std::uint64_t                 _reported_drops = 0;
+
+		std::mutex              _mutex;
+		std::condition_variable _wakeup;
+		std::condition_variable _empty;
+		bool                    _shutdown = false;
+		std::thread             _thread;
+
+		void _run();
+		void _write(const Entry&);
+	};
+
+} // namespace mirrage::util
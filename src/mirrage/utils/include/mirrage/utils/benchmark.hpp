@@ -0,0 +1,156 @@
+/** minimal harness for micro-benchmarks *************************************
+ *                                                                           *
+ * Copyright (c) 2020 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * MIRRAGE_BENCHMARK(my_benchmark) {
+ *		auto ns = util::benchmark::measure([&](std::size_t n) { for(auto i=0; i<n; i++) ... });
+ *		util::benchmark::report("my_benchmark", ns);
+ * }
+ */
+namespace mirrage::util::benchmark {
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Entry {
+		const char* name;
+		void (*func)();
+	};
+	inline auto entries() -> std::vector<Entry>&
+	{
+		static auto entries = std::vector<Entry>();
+		return entries;
+	}
+
+	struct Registrar {
+		Registrar(const char* name, void (*func)()) { entries().push_back({name, func}); }
+	};
+
+	/// prevents the compiler from optimizing away the computation of the given value
+	template <class T>
+	inline void do_not_optimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+
+	inline auto to_ns(Clock::duration d) -> double
+	{
+		return std::chrono::duration<double, std::nano>(d).count();
+	}
+
+	/// calls f(n) with an increasing n, until a single call takes at least min_duration
+	/// @return the time per iteration in nanoseconds
+	template <class F>
+	auto measure(F&& f, std::chrono::milliseconds min_duration = std::chrono::milliseconds(200)) -> double
+	{
+		for(auto n = std::size_t(1);; n *= 2) {
+			auto start = Clock::now();
+			f(n);
+			auto time = Clock::now() - start;
+
+			if(time >= min_duration || n >= (std::size_t(1) << 40))
+				return to_ns(time) / double(n);
+		}
+	}
+
+	/// calls f(thread_index, n) concurrently on thread_count threads with an increasing n,
+	///   until a single run takes at least min_duration
+	/// @return the wall-clock time per iteration of all threads combined in nanoseconds
+	template <class F>
+	auto measure_parallel(int                       thread_count,
+	                      F&&                       f,
+	                      std::chrono::milliseconds min_duration = std::chrono::milliseconds(200)) -> double
+	{
+		for(auto n = std::size_t(1);; n *= 2) {
+			auto threads = std::vector<std::thread>();
+			threads.reserve(std::size_t(thread_count));
+
+			auto ready = std::atomic<int>(0);
+			auto go    = std::atomic<bool>(false);
+			for(auto i = 0; i < thread_count; i++) {
+				threads.emplace_back([&, i] {
+					ready++;
+					while(!go.load(std::memory_order_acquire))
+						std::this_thread::yield();
+					f(i, n);
+				});
+			}
+
+			while(ready.load() < thread_count)
+				std::this_thread::yield();
+
+			auto start = Clock::now();
+			go.store(true, std::memory_order_release);
+			for(auto& t : threads)
+				t.join();
+			auto time = Clock::now() - start;
+
+			if(time >= min_duration || n >= (std::size_t(1) << 40))
+				return to_ns(time) / double(n * std::size_t(thread_count));
+		}
+	}
+
+	/// returns the p-th percentile (0-1) of the given samples and reorders them
+	inline auto percentile(std::vector<double>& samples, double p) -> double
+	{
+		if(samples.empty())
+			return 0.0;
+
+		auto idx = std::min(samples.size() - 1, std::size_t(p * double(samples.size())));
+		std::nth_element(samples.begin(), samples.begin() + std::ptrdiff_t(idx), samples.end());
+		return samples[idx];
+	}
+
+	inline void report(std::string_view name, double ns_per_op, std::string_view details = "")
+	{
+		std::printf("%-56.*s %12.2f ns/op %12.3f M/s  %.*s\n",
+		            int(name.size()),
+		            name.data(),
+		            ns_per_op,
+		            1000.0 / ns_per_op,
+		            int(details.size()),
+		            details.data());
+	}
+
+	/// runs all registered benchmarks, whose name contains the first argument (if any)
+	inline int run(int argc, char** argv)
+	{
+		auto filter = argc > 1 ? std::string_view(argv[1]) : std::string_view();
+
+		for(auto& e : entries()) {
+			if(!filter.empty() && std::string_view(e.name).find(filter) == std::string_view::npos)
+				continue;
+
+			std::printf("\n== %s ==\n", e.name);
+			e.func();
+		}
+
+		return 0;
+	}
+
+} // namespace mirrage::util::benchmark
+
+#define MIRRAGE_BENCHMARK(NAME)                                                  \
+	static void NAME();                                                          \
+	static ::mirrage::util::benchmark::Registrar NAME##_registrar{#NAME, &NAME}; \
+	static void NAME()
@@ -0,0 +1,138 @@
+/** low-overhead CPU profiler for instrumented scopes ************************
+ *                                                                           *
+ * Copyright (c) 2020 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * void update() {
+ *		MIRRAGE_PROFILE_ZONE("Physics::update"); // the name has to be a string literal
+ *		...
+ * }
+ *
+ * The macros expand to nothing, if the engine is built without MIRRAGE_ENABLE_CPU_PROFILER.
+ */
+#ifdef MIRRAGE_ENABLE_CPU_PROFILER
+#define MIRRAGE_PROFILE_CONCATENATE_DIRECT(s1, s2) s1##s2
+#define MIRRAGE_PROFILE_CONCATENATE(s1, s2) MIRRAGE_PROFILE_CONCATENATE_DIRECT(s1, s2)
+#define MIRRAGE_PROFILE_ZONE(NAME) \
+	::mirrage::util::cpu_profiler::Zone MIRRAGE_PROFILE_CONCATENATE(_profiler_zone, __LINE__)(NAME)
+#define MIRRAGE_PROFILE_FUNCTION() MIRRAGE_PROFILE_ZONE(__func__)
+#else
+#define MIRRAGE_PROFILE_ZONE(NAME) \
+	do {                           \
+	} while(false)
+#define MIRRAGE_PROFILE_FUNCTION() \
+	do {                           \
+	} while(false)
+#endif
+
+/**
+ * Each thread records its completed zones into its own ring buffer, without any synchronization.
+ * The buffers are collected once per frame by end_frame(), that aggregates the zones by name and
+ *   copies them for the export in the Chrome trace-event format, while a capture is running.
+ */
+namespace mirrage::util::cpu_profiler {
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Zone_stats {
+		std::string_view name;
+		std::size_t      calls       = 0; //< calls in the last frame
+		double           time_ms     = 0; //< accumulated time in the last frame
+		double           time_avg_ms = 0;
+		double           time_min_ms = 0;
+		double           time_max_ms = 0;
+	};
+
+	/// collects and aggregates the zones that completed since the last call
+	/// should be called exactly once per frame
+	extern void end_frame();
+
+	/// the statistics of all zones that have been recorded until the last end_frame(), sorted by time_avg_ms
+	extern auto results() -> std::vector<Zone_stats>;
+	extern void reset_results();
+
+	/// number of zones that have been lost, because a thread recorded more than the size of its buffer
+	///   in a single frame or the capture was full
+	extern auto dropped_zones() -> std::uint64_t;
+
+	/// name of the calling thread in exported traces
+	extern void set_thread_name(std::string name);
+
+	/// discards the previous capture and starts recording all zones
+	extern void start_capture();
+	extern void stop_capture();
+	extern auto capturing() noexcept -> bool;
+
+	/// writes the last capture in the Chrome trace-event format (chrome://tracing, ui.perfetto.dev)
+	extern void write_chrome_trace(std::ostream&);
+
+
+	namespace detail {
+		constexpr auto buffer_size = std::size_t(1) << 14;
+
+		// atomic members, so end_frame() can detect entries that have been overwritten while it read them
+		struct Event {
+			std::atomic<const char*>  name{nullptr};
+			std::atomic<std::int64_t> begin_ns{0};
+			std::atomic<std::int64_t> end_ns{0};
+		};
+
+		struct Thread_buffer {
+			std::array<Event, buffer_size> events;
+			std::atomic<std::uint64_t>     write_index{0};
+			std::uint64_t                  read_index = 0; //< only accessed by end_frame
+			std::uint32_t                  thread_id  = 0;
+			bool                           in_use     = true;
+		};
+
+		/// the buffer of the calling thread, which is registered on first use
+		extern auto thread_buffer() -> Thread_buffer&;
+
+		inline auto now_ns() noexcept -> std::int64_t
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch())
+			        .count();
+		}
+	} // namespace detail
+
+	/// records the time between its construction and destruction
+	class Zone {
+	  public:
+		explicit Zone(const char* name) noexcept
+		  : _buffer(detail::thread_buffer()), _name(name), _begin_ns(detail::now_ns())
+		{
+		}
+		Zone(const Zone&) = delete;
+		auto operator=(const Zone&) -> Zone& = delete;
+		~Zone()
+		{
+			auto  end_ns = detail::now_ns();
+			auto  index  = _buffer.write_index.load(std::memory_order_relaxed);
+			auto& event  = _buffer.events[index & (detail::buffer_size - 1)];
+			event.name.store(_name, std::memory_order_relaxed);
+			event.begin_ns.store(_begin_ns, std::memory_order_relaxed);
+			event.end_ns.store(end_ns, std::memory_order_relaxed);
+			_buffer.write_index.store(index + 1, std::memory_order_release);
+		}
+
+	  private:
+		detail::Thread_buffer& _buffer;
+		const char*            _name;
+		std::int64_t           _begin_ns;
+	};
+
+} // namespace mirrage::util::cpu_profiler
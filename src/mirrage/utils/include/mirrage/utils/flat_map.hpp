@@ -0,0 +1,522 @@
+/** flat sorted containers for integer keys **********************************
+ *                                                                           *
+ * Copyright (c) 2020 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <mirrage/utils/maybe.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MIRRAGE_FLAT_MAP_SIMD
+#elif defined(__SSE4_2__)
+#include <nmmintrin.h>
+#define MIRRAGE_FLAT_MAP_SIMD
+#endif
+
+
+namespace mirrage::util {
+
+	namespace detail {
+#ifdef MIRRAGE_FLAT_MAP_SIMD
+		/// the signed integer comparisons of AVX2 or SSE4.2 for lanes of 4 or 8 bytes
+		template <std::size_t LaneSize>
+		struct flat_map_simd;
+
+#ifdef __AVX2__
+		template <>
+		struct flat_map_simd<4> {
+			using vector = __m256i;
+			static auto set(std::int32_t v) { return _mm256_set1_epi32(v); }
+			static auto load(const void* p) { return _mm256_loadu_si256(static_cast<const vector*>(p)); }
+			static auto bit_xor(vector a, vector b) { return _mm256_xor_si256(a, b); }
+			static auto greater(vector a, vector b) { return _mm256_cmpgt_epi32(a, b); }
+			static auto sub(vector a, vector b) { return _mm256_sub_epi32(a, b); }
+			static auto sum(vector a)
+			{
+				auto s = _mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+				s      = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+				s      = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+				return std::size_t(_mm_cvtsi128_si32(s));
+			}
+		};
+		template <>
+		struct flat_map_simd<8> {
+			using vector = __m256i;
+			static auto set(std::int64_t v) { return _mm256_set1_epi64x(v); }
+			static auto load(const void* p) { return _mm256_loadu_si256(static_cast<const vector*>(p)); }
+			static auto bit_xor(vector a, vector b) { return _mm256_xor_si256(a, b); }
+			static auto greater(vector a, vector b) { return _mm256_cmpgt_epi64(a, b); }
+			static auto sub(vector a, vector b) { return _mm256_sub_epi64(a, b); }
+			static auto sum(vector a)
+			{
+				// the sum is at most the number of keys in a node, so the lower half of the lane is enough
+				auto s = _mm_add_epi64(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+				s      = _mm_add_epi64(s, _mm_unpackhi_epi64(s, s));
+				return std::size_t(_mm_cvtsi128_si32(s));
+			}
+		};
+#else
+		template <>
+		struct flat_map_simd<4> {
+			using vector = __m128i;
+			static auto set(std::int32_t v) { return _mm_set1_epi32(v); }
+			static auto load(const void* p) { return _mm_loadu_si128(static_cast<const vector*>(p)); }
+			static auto bit_xor(vector a, vector b) { return _mm_xor_si128(a, b); }
+			static auto greater(vector a, vector b) { return _mm_cmpgt_epi32(a, b); }
+			static auto sub(vector a, vector b) { return _mm_sub_epi32(a, b); }
+			static auto sum(vector a)
+			{
+				auto s = _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2)));
+				s      = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+				return std::size_t(_mm_cvtsi128_si32(s));
+			}
+		};
+		template <>
+		struct flat_map_simd<8> {
+			using vector = __m128i;
+			static auto set(std::int64_t v) { return _mm_set1_epi64x(v); }
+			static auto load(const void* p) { return _mm_loadu_si128(static_cast<const vector*>(p)); }
+			static auto bit_xor(vector a, vector b) { return _mm_xor_si128(a, b); }
+			static auto greater(vector a, vector b) { return _mm_cmpgt_epi64(a, b); }
+			static auto sub(vector a, vector b) { return _mm_sub_epi64(a, b); }
+			static auto sum(vector a)
+			{
+				auto s = _mm_add_epi64(a, _mm_unpackhi_epi64(a, a));
+				return std::size_t(_mm_cvtsi128_si32(s));
+			}
+		};
+#endif
+#endif
+
+		/// number of keys in [keys, keys+n) that are less than key, i.e. the lower_bound of a sorted range.
+		/// Compares every key, which is faster than a binary search for the small nodes of flat_search_index.
+		/// Without AVX2/SSE4.2 the plain loop is used, which compilers vectorize on their own where possible
+		///   (emulating 64 bit comparisons with SSE2 is slower than that).
+		template <class Key>
+		auto count_less(const Key* keys, std::size_t n, Key key) noexcept -> std::size_t
+		{
+			auto count = std::size_t(0);
+			auto i     = std::size_t(0);
+
+#ifdef MIRRAGE_FLAT_MAP_SIMD
+			if constexpr(sizeof(Key) == 4 || sizeof(Key) == 8) {
+				using simd   = flat_map_simd<sizeof(Key)>;
+				using vector = typename simd::vector;
+				using Bits   = std::conditional_t<sizeof(Key) == 8, std::uint64_t, std::uint32_t>;
+				using Lane   = std::make_signed_t<Bits>;
+
+				// unsigned keys are compared as signed values with a flipped sign bit
+				constexpr auto bias       = std::is_signed_v<Key> ? Bits(0) : ~(~Bits(0) >> 1);
+				constexpr auto lane_count = sizeof(vector) / sizeof(Key);
+
+				auto bias_v = simd::set(static_cast<Lane>(bias));
+				auto key_v  = simd::set(static_cast<Lane>(Bits(key) ^ bias));
+				auto sum    = simd::set(0);
+				for(auto simd_end = n - n % lane_count; i < simd_end; i += lane_count) {
+					// the lanes of the comparison result are -1 if true
+					auto less = simd::greater(key_v, simd::bit_xor(simd::load(keys + i), bias_v));
+					sum       = simd::sub(sum, less);
+				}
+
+				count = simd::sum(sum);
+			}
+#endif
+
+			for(; i < n; i++)
+				count += keys[i] < key ? 1u : 0u;
+
+			return count;
+		}
+
+		/**
+		 * @brief Implicit B+tree over a sorted array of integer keys, that is used to find the lower_bound.
+		 * Each level contains the largest key of every node_size keys of the level below it (the sorted
+		 *   keys themselves are the lowest level), until a level fits into a single node.
+		 * A search visits one node per level and compares all of its keys at once, instead of jumping
+		 *   around the (much larger) sorted array like a binary search.
+		 * The levels are padded with the largest possible key, so all nodes can be searched completely.
+		 */
+		template <class Key>
+		class flat_search_index {
+		  public:
+			static constexpr auto node_size = std::size_t(16);
+			/// below this size, a binary search over the keys is about as fast and updates are cheaper
+			static constexpr auto small_size = node_size * 4;
+
+			void clear()
+			{
+				_level_count = 0;
+				_size        = 0;
+			}
+
+			/// has to be called after the keys at [first_changed, size) or the size have been modified
+			void update(const Key* keys, std::size_t size, std::size_t first_changed)
+			{
+				auto old_size = std::exchange(_size, size);
+				if(size <= small_size)
+					_level_count = 0; // the vectors are kept, so growing again doesn't allocate
+				else
+					_update_levels(keys, size, old_size, first_changed);
+			}
+
+			/// position of the first key that is not less than key
+			auto lower_bound(const Key* keys, std::size_t size, Key key) const noexcept -> std::size_t
+			{
+				if(size <= small_size)
+					return std::size_t(std::lower_bound(keys, keys + size, key) - keys);
+
+				// larger than all keys => the descent below would run into the padding
+				if(keys[size - 1] < key)
+					return size;
+
+				auto node = std::size_t(0);
+				for(auto level = _level_count; level > 0; level--) {
+					auto first_key = _levels[level - 1].data() + node * node_size;
+					node           = node * node_size + count_less(first_key, node_size, key);
+				}
+
+				auto first = node * node_size;
+				return first + count_less(keys + first, std::min(node_size, size - first), key);
+			}
+
+		  private:
+			static constexpr auto padding = std::numeric_limits<Key>::max();
+
+			std::vector<std::vector<Key>> _levels; ///< lowest level first, may contain unused levels
+			std::size_t                   _level_count = 0;
+			std::size_t                   _size        = 0;
+
+			void _update_levels(const Key*  keys,
+			                    std::size_t size,
+			                    std::size_t old_below_size,
+			                    std::size_t first_changed)
+			{
+				auto level_count = std::size_t(0);
+				auto below       = keys;
+				auto below_size  = size;
+				while(below_size > node_size) {
+					if(_levels.size() <= level_count)
+						_levels.emplace_back();
+
+					auto& level       = _levels[level_count];
+					auto  level_size  = (below_size + node_size - 1) / node_size;
+					auto  padded_size = (level_size + node_size - 1) / node_size * node_size;
+					auto  old_size    = std::size_t(0);
+					auto  changed     = true;
+					if(level_count++ < _level_count) {
+						old_size      = (old_below_size + node_size - 1) / node_size;
+						changed       = level_size != old_size;
+						first_changed = std::min(first_changed / node_size, old_size);
+						level.resize(padded_size, padding);
+					} else {
+						// not part of the index before => nothing to reuse
+						first_changed = 0;
+						level.assign(padded_size, padding);
+					}
+
+					// the last node of the level below might not be full
+					auto full_nodes = below_size / node_size;
+					for(auto i = first_changed; i < level_size; i++) {
+						auto max = below[i < full_nodes ? i * node_size + node_size - 1 : below_size - 1];
+						changed |= level[i] != max;
+						level[i] = max;
+					}
+
+					for(auto i = level_size; i < std::min(old_size, padded_size); i++)
+						level[i] = padding;
+
+					// the levels above only depend on this one
+					if(!changed)
+						return;
+
+					below          = level.data();
+					below_size     = level_size;
+					old_below_size = old_size;
+				}
+
+				_level_count = level_count;
+			}
+		};
+	} // namespace detail
+
+
+	/**
+	 * @brief Sorted set of unique integer keys in a contiguous array, with an index for fast searches.
+	 * Iteration and access by position are the same as for a sorted std::vector (i.e. fast), lookups
+	 *   use a SIMD B+tree index (see detail::flat_search_index) that is updated from the modified position
+	 *   onward, so insertions/removals near the end are cheap. Insertions/removals in the middle of large
+	 *   sets are slower than for a plain sorted std::vector, because most of the index has to be updated.
+	 * Inserting many keys at once should use the range insert(), which merges them in a single pass.
+	 */
+	template <class Key>
+	class flat_set {
+		static_assert(std::is_integral_v<Key>, "flat_set only supports integer keys");
+
+	  public:
+		using key_type               = Key;
+		using value_type             = Key;
+		using const_iterator         = typename std::vector<Key>::const_iterator;
+		using const_reverse_iterator = typename std::vector<Key>::const_reverse_iterator;
+
+		flat_set() = default;
+		explicit flat_set(std::vector<Key> keys) : _keys(std::move(keys))
+		{
+			std::sort(_keys.begin(), _keys.end());
+			_keys.erase(std::unique(_keys.begin(), _keys.end()), _keys.end());
+			_index.update(_keys.data(), _keys.size(), 0);
+		}
+
+		/// returns the position of the key and false if it was already part of the set
+		auto insert(Key key) -> std::pair<const_iterator, bool>
+		{
+			auto pos = _lower_bound(key);
+			if(pos < _keys.size() && _keys[pos] == key)
+				return {begin() + std::ptrdiff_t(pos), false};
+
+			_keys.insert(_keys.begin() + std::ptrdiff_t(pos), key);
+			_index.update(_keys.data(), _keys.size(), pos);
+			return {begin() + std::ptrdiff_t(pos), true};
+		}
+
+		/// inserts all keys in [first, last) with a single sort+merge, instead of shifting the
+		///   following keys for each one
+		template <class Iter>
+		void insert(Iter first, Iter last)
+		{
+			auto old_size = _keys.size();
+			_keys.insert(_keys.end(), first, last);
+			if(_keys.size() == old_size)
+				return;
+
+			auto mid = _keys.begin() + std::ptrdiff_t(old_size);
+			std::sort(mid, _keys.end());
+
+			// everything before the smallest new key stays where it is
+			auto first_changed = _index.lower_bound(_keys.data(), old_size, *mid);
+			auto merge_begin   = _keys.begin() + std::ptrdiff_t(first_changed);
+			std::inplace_merge(merge_begin, mid, _keys.end());
+			_keys.erase(std::unique(merge_begin, _keys.end()), _keys.end());
+
+			_index.update(_keys.data(), _keys.size(), first_changed);
+		}
+
+		/// returns true if the key was part of the set
+		auto erase(Key key) -> bool
+		{
+			auto pos = _lower_bound(key);
+			if(pos == _keys.size() || _keys[pos] != key)
+				return false;
+
+			erase(begin() + std::ptrdiff_t(pos));
+			return true;
+		}
+		auto erase(const_iterator iter) -> const_iterator { return erase(iter, iter + 1); }
+		auto erase(const_iterator first, const_iterator last) -> const_iterator
+		{
+			auto pos = first - begin();
+			_keys.erase(first, last);
+			_index.update(_keys.data(), _keys.size(), std::size_t(pos));
+			return begin() + pos;
+		}
+
+		auto pop_back() -> Key
+		{
+			auto v = _keys.back();
+			_keys.pop_back();
+			_index.update(_keys.data(), _keys.size(), _keys.size());
+			return v;
+		}
+
+		/// first key that is not less than the given key
+		auto lower_bound(Key key) const noexcept -> const_iterator
+		{
+			return begin() + std::ptrdiff_t(_lower_bound(key));
+		}
+		auto find(Key key) const noexcept -> const_iterator
+		{
+			auto iter = lower_bound(key);
+			return iter != end() && *iter == key ? iter : end();
+		}
+		auto contains(Key key) const noexcept { return find(key) != end(); }
+
+		auto front() const { return _keys.front(); }
+		auto back() const { return _keys.back(); }
+
+		void clear()
+		{
+			_keys.clear();
+			_index.clear();
+		}
+
+		void reserve(std::size_t n) { _keys.reserve(n); }
+
+		auto size() const noexcept { return _keys.size(); }
+		auto empty() const noexcept { return _keys.empty(); }
+		auto begin() const noexcept { return _keys.begin(); }
+		auto end() const noexcept { return _keys.end(); }
+		auto rbegin() const noexcept { return _keys.rbegin(); }
+		auto rend() const noexcept { return _keys.rend(); }
+
+		auto operator[](std::int64_t i) const { return _keys.at(std::size_t(i)); }
+
+	  private:
+		std::vector<Key>                _keys;
+		detail::flat_search_index<Key> _index;
+
+		auto _lower_bound(Key key) const noexcept
+		{
+			return _index.lower_bound(_keys.data(), _keys.size(), key);
+		}
+	};
+
+
+	/**
+	 * @brief Sorted map from integer keys to values, with the same lookup structure as flat_set.
+	 * The keys and values are stored in separate arrays, so a search only touches the keys.
+	 */
+	template <class Key, class T>
+	class flat_map {
+		static_assert(std::is_integral_v<Key>, "flat_map only supports integer keys");
+
+	  public:
+		using key_type    = Key;
+		using mapped_type = T;
+
+		/// returns the value for the key and false if the key was already part of the map,
+		///   in which case the arguments are ignored
+		template <class... Args>
+		auto emplace(Key key, Args&&... args) -> std::pair<T&, bool>
+		{
+			auto pos = _lower_bound(key);
+			if(pos < _keys.size() && _keys[pos] == key)
+				return {_values[pos], false};
+
+			_values.emplace(_values.begin() + std::ptrdiff_t(pos), std::forward<Args>(args)...);
+			_keys.insert(_keys.begin() + std::ptrdiff_t(pos), key);
+			_index.update(_keys.data(), _keys.size(), pos);
+			return {_values[pos], true};
+		}
+
+		/// inserts all (key, value) pairs in [first, last) with a single sort+merge.
+		/// Like emplace(), keys that are already part of the map (or repeated) keep their first value.
+		template <class Iter>
+		void insert(Iter first, Iter last)
+		{
+			auto entries = std::vector<std::pair<Key, T>>(first, last);
+			if(entries.empty())
+				return;
+
+			std::stable_sort(entries.begin(), entries.end(), [](auto& lhs, auto& rhs) {
+				return lhs.first < rhs.first;
+			});
+
+			// everything before the smallest new key stays where it is
+			auto first_changed = _lower_bound(entries.front().first);
+
+			auto split  = std::ptrdiff_t(first_changed);
+			auto keys   = std::vector<Key>(_keys.begin() + split, _keys.end());
+			auto values = std::vector<T>(std::make_move_iterator(_values.begin() + split),
+			                             std::make_move_iterator(_values.end()));
+			_keys.erase(_keys.begin() + split, _keys.end());
+			_values.erase(_values.begin() + split, _values.end());
+			_keys.reserve(first_changed + keys.size() + entries.size());
+			_values.reserve(first_changed + keys.size() + entries.size());
+
+			auto old = std::size_t(0);
+			for(auto& [key, value] : entries) {
+				for(; old < keys.size() && keys[old] < key; old++) {
+					_keys.push_back(keys[old]);
+					_values.push_back(std::move(values[old]));
+				}
+
+				auto exists = (old < keys.size() && keys[old] == key)
+				              || (_keys.size() > first_changed && _keys.back() == key);
+				if(!exists) {
+					_keys.push_back(key);
+					_values.push_back(std::move(value));
+				}
+			}
+			for(; old < keys.size(); old++) {
+				_keys.push_back(keys[old]);
+				_values.push_back(std::move(values[old]));
+			}
+
+			_index.update(_keys.data(), _keys.size(), first_changed);
+		}
+
+		/// returns true if the key was part of the map
+		auto erase(Key key) -> bool
+		{
+			auto pos = _lower_bound(key);
+			if(pos == _keys.size() || _keys[pos] != key)
+				return false;
+
+			_keys.erase(_keys.begin() + std::ptrdiff_t(pos));
+			_values.erase(_values.begin() + std::ptrdiff_t(pos));
+			_index.update(_keys.data(), _keys.size(), pos);
+			return true;
+		}
+
+		auto find(Key key) -> util::maybe<T&>
+		{
+			auto pos = _find(key);
+			return pos < _keys.size() ? util::justPtr(&_values[pos]) : util::nothing;
+		}
+		auto find(Key key) const -> util::maybe<const T&>
+		{
+			auto pos = _find(key);
+			return pos < _keys.size() ? util::justPtr(&_values[pos]) : util::nothing;
+		}
+		auto contains(Key key) const noexcept { return _find(key) < _keys.size(); }
+
+		auto operator[](Key key) -> T& { return emplace(key).first; }
+
+		void clear()
+		{
+			_keys.clear();
+			_values.clear();
+			_index.clear();
+		}
+
+		void reserve(std::size_t n)
+		{
+			_keys.reserve(n);
+			_values.reserve(n);
+		}
+
+		auto size() const noexcept { return _keys.size(); }
+		auto empty() const noexcept { return _keys.empty(); }
+
+		/// the sorted keys, the value of keys()[i] is value_at(i)
+		auto keys() const noexcept -> const std::vector<Key>& { return _keys; }
+		auto value_at(std::size_t i) -> T& { return _values.at(i); }
+		auto value_at(std::size_t i) const -> const T& { return _values.at(i); }
+
+	  private:
+		std::vector<Key>                _keys;
+		std::vector<T>                  _values;
+		detail::flat_search_index<Key> _index;
+
+		auto _lower_bound(Key key) const noexcept
+		{
+			return _index.lower_bound(_keys.data(), _keys.size(), key);
+		}
+		auto _find(Key key) const noexcept
+		{
+			auto pos = _lower_bound(key);
+			return pos < _keys.size() && _keys[pos] == key ? pos : _keys.size();
+		}
+	};
+
+} // namespace mirrage::util
@@ -0,0 +1,126 @@
+/** linear per-frame allocator ***********************************************
+ *                                                                           *
+ * Copyright (c) 2020 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace mirrage::util {
+
+	/**
+	 * @brief A linear allocator for data that only lives until the end of the current frame.
+	 * Each registered thread bumps a pointer in its own sub-arena, so allocations never synchronize.
+	 * Deallocation is a no-op and all memory is released at once by reset(), which also merges the
+	 *   chunks that have been added during the last frame, so steady-state frames don't touch the heap.
+	 */
+	class frame_arena {
+	  public:
+		static constexpr auto default_chunk_size = std::size_t(64) * 1024;
+
+		struct stats {
+			std::size_t allocations      = 0; //< number of allocate() calls
+			std::size_t bytes            = 0; //< number of bytes handed out
+			std::size_t heap_allocations = 0; //< number of chunks that had to be allocated
+			std::size_t capacity         = 0; //< size of all chunks (at the end of the frame)
+		};
+
+		explicit frame_arena(std::size_t chunk_size = default_chunk_size);
+		frame_arena(const frame_arena&) = delete;
+		auto operator=(const frame_arena&) -> frame_arena& = delete;
+		~frame_arena();
+
+		/// registers a thread for calls to allocate
+		/// thread-safe, but must not be called concurrently with allocate or reset
+		void register_thread(std::thread::id id = std::this_thread::get_id());
+
+		/// thread-safe for concurrent calls from registered threads
+		auto allocate(std::size_t size, std::size_t alignment) -> void*
+		{
+			return _local().allocate(size, alignment, _chunk_size);
+		}
+
+		/// invalidates all memory returned by allocate since the last reset
+		/// must not be called concurrently with the other methods
+		void reset();
+
+		/// statistics of the frame that has been ended by the last call to reset()
+		auto last_frame_stats() const noexcept -> const stats& { return _last_frame_stats; }
+
+	  private:
+		struct Chunk {
+			std::unique_ptr<char[]> data;
+			std::size_t             size;
+		};
+		struct Sub_arena {
+			std::vector<Chunk> chunks;
+			std::size_t        current_chunk  = 0;
+			std::size_t        current_offset = 0;
+			stats              frame_stats;
+
+			auto allocate(std::size_t size, std::size_t alignment, std::size_t chunk_size) -> void*;
+			void reset();
+		};
+
+		std::size_t                                                         _chunk_size;
+		std::mutex                                                          _mutex;
+		std::vector<std::pair<std::thread::id, std::unique_ptr<Sub_arena>>> _sub_arenas;
+		stats                                                               _last_frame_stats;
+
+		auto _local() -> Sub_arena&;
+	};
+
+	/// std-allocator adapter for frame_arena
+	template <class T>
+	class frame_allocator {
+	  public:
+		using value_type                             = T;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap            = std::true_type;
+		using is_always_equal                        = std::false_type;
+
+		frame_allocator(frame_arena& arena) noexcept : _arena(&arena) {}
+		template <class U>
+		frame_allocator(const frame_allocator<U>& rhs) noexcept : _arena(&rhs.arena())
+		{
+		}
+
+		auto allocate(std::size_t n) -> T*
+		{
+			return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+		}
+		void deallocate(T*, std::size_t) noexcept {}
+
+		auto arena() const noexcept -> frame_arena& { return *_arena; }
+
+		template <class U>
+		friend auto operator==(const frame_allocator& lhs, const frame_allocator<U>& rhs) noexcept
+		{
+			return &lhs.arena() == &rhs.arena();
+		}
+		template <class U>
+		friend auto operator!=(const frame_allocator& lhs, const frame_allocator<U>& rhs) noexcept
+		{
+			return &lhs.arena() != &rhs.arena();
+		}
+
+	  private:
+		frame_arena* _arena;
+	};
+
+	/// a vector that lives in a frame_arena and has to be cleared or replaced before the arena is reset
+	template <class T>
+	using frame_vector = std::vector<T, frame_allocator<T>>;
+
+} // namespace mirrage::util
@@ -0,0 +1,165 @@
+/** interned strings with integer handles ************************************
+ *                                                                           *
+ * Copyright (c) 2020 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace mirrage::util {
+
+	namespace detail {
+		template <bool ConstantExpression>
+		constexpr auto read_u64_le(const char* p, std::size_t n) noexcept -> std::uint64_t
+		{
+			auto v = std::uint64_t(0);
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+			if constexpr(!ConstantExpression) {
+				std::memcpy(&v, p, n);
+				return v;
+			}
+#endif
+			for(auto i = std::size_t(0); i < n; i++)
+				v |= std::uint64_t(static_cast<std::uint8_t>(p[i])) << (i * 8);
+			return v;
+		}
+
+		/// MurmurHash64A. The variant for constant expressions (literals) reads the input byte-wise,
+		///   which is considerably slower at runtime.
+		template <bool ConstantExpression = false>
+		constexpr auto interned_str_hash(std::string_view str) noexcept -> std::uint64_t
+		{
+			if(str.empty())
+				return 0;
+
+			constexpr auto m = std::uint64_t(0xc6a4a7935bd1e995ull);
+			constexpr auto r = 47;
+
+			auto h     = std::uint64_t(0x8445d61a4e774912ull) ^ (str.size() * m);
+			auto data  = str.data();
+			auto words = str.size() / 8;
+
+			for(auto i = std::size_t(0); i < words; i++) {
+				auto k = read_u64_le<ConstantExpression>(data + i * 8, 8);
+				k *= m;
+				k ^= k >> r;
+				k *= m;
+				h ^= k;
+				h *= m;
+			}
+
+			if(auto rest = str.size() % 8; rest > 0) {
+				h ^= read_u64_le<ConstantExpression>(data + words * 8, rest);
+				h *= m;
+			}
+
+			h ^= h >> r;
+			h *= m;
+			h ^= h >> r;
+			// 0 is reserved for the empty string, which is remapped instead of setting the lowest bit,
+			//   so all 64 bits stay usable (e.g. to select a shard)
+			return h != 0 ? h : m;
+		}
+	} // namespace detail
+
+	/**
+	 * @brief A handle for an arbitrary string, that is stored only once in a global table.
+	 * Unlike Str_id there are no restrictions on the length or characters of the string, but the
+	 *   handle has to be looked up in the table to get the string back.
+	 *
+	 * The handle is the 64 bit hash of the string, so equality and hashing are integer operations,
+	 *   literals ("name"_istr) are evaluated at compile time and maps can be searched with hashed()
+	 *   without adding the key to the table. Looking up an existing string doesn't require a lock.
+	 * A hash collision between two interned strings is detected when the second one is interned.
+	 */
+	class Interned_str {
+	  public:
+		using int_type = std::uint64_t;
+
+		constexpr Interned_str() noexcept = default;
+		/// adds the string to the global table, if it's not already part of it
+		explicit Interned_str(std::string_view str);
+		explicit Interned_str(const char* str) : Interned_str(std::string_view(str)) {}
+		explicit Interned_str(const std::string& str) : Interned_str(std::string_view(str)) {}
+
+		/// handle for a string, that is not added to the table (e.g. for lookups)
+		/// str() only returns the value, if the same string has been interned somewhere else
+		static auto hashed(std::string_view str) noexcept
+		{
+			return Interned_str(detail::interned_str_hash(str), 0);
+		}
+		/// like hashed(), but can be evaluated at compile time (used by the _istr literal)
+		static constexpr auto hashed_literal(std::string_view str) noexcept
+		{
+			return Interned_str(detail::interned_str_hash<true>(str), 0);
+		}
+
+		/// the interned string or an empty string, if the handle is unknown
+		auto str() const -> const std::string&;
+		/// true if the string is part of the global table
+		auto interned() const -> bool;
+
+		constexpr auto empty() const noexcept { return _id == 0; }
+		constexpr auto id() const noexcept { return _id; }
+
+		friend constexpr bool operator==(Interned_str lhs, Interned_str rhs) noexcept
+		{
+			return lhs._id == rhs._id;
+		}
+		friend constexpr bool operator!=(Interned_str lhs, Interned_str rhs) noexcept
+		{
+			return lhs._id != rhs._id;
+		}
+		friend constexpr bool operator<(Interned_str lhs, Interned_str rhs) noexcept
+		{
+			return lhs._id < rhs._id;
+		}
+
+	  private:
+		int_type _id = 0;
+
+		constexpr Interned_str(int_type id, int) noexcept : _id(id) {}
+	};
+
+	static_assert(Interned_str::hashed_literal("").empty(), "The empty string has to be represented by 0");
+
+	inline std::ostream& operator<<(std::ostream& s, const Interned_str& str)
+	{
+		s << str.str();
+		return s;
+	}
+
+#ifdef sf2_structDef
+	inline void load(sf2::JsonDeserializer& s, Interned_str& v)
+	{
+		std::string str;
+		s.read_value(str);
+		v = Interned_str(str);
+	}
+
+	inline void save(sf2::JsonSerializer& s, const Interned_str& v) { s.write_value(v.str()); }
+#endif
+} // namespace mirrage::util
+
+inline constexpr mirrage::util::Interned_str operator"" _istr(const char* str, std::size_t len)
+{
+	return mirrage::util::Interned_str::hashed_literal(std::string_view(str, len));
+}
+
+namespace std {
+	template <>
+	struct hash<mirrage::util::Interned_str> {
+		constexpr size_t operator()(mirrage::util::Interned_str s) const noexcept
+		{
+			return static_cast<size_t>(s.id());
+		}
+	};
+} // namespace std
@@ -0,0 +1,285 @@
+/** work-stealing job system *************************************************
+ *                                                                           *
+ * Copyright (c) 2020 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <mirrage/utils/ring_buffer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace mirrage::util {
+
+	enum class Job_priority { high, normal, low };
+	constexpr auto job_priority_count = std::size_t(3);
+
+	/**
+	 * @brief Tracks the completion of a group of jobs (e.g. all children of a parent job).
+	 * Jobs spawned with a counter increment it and decrement it after they have been executed,
+	 *   so job_system::wait() can be used to block until all of them are done.
+	 */
+	class job_counter {
+	  public:
+		job_counter() = default;
+		job_counter(const job_counter&) = delete;
+		auto operator=(const job_counter&) -> job_counter& = delete;
+
+		auto done() const noexcept { return _pending.load(std::memory_order_acquire) == 0; }
+
+		/// the lowest priority of all jobs that have been spawned with this counter
+		auto lowest_priority() const noexcept
+		{
+			auto priorities = _priorities.load(std::memory_order_relaxed);
+			auto lowest     = Job_priority::high;
+			for(auto p = std::size_t(0); p < job_priority_count; p++) {
+				if(priorities & (1u << p))
+					lowest = Job_priority(p);
+			}
+			return lowest;
+		}
+
+	  private:
+		friend class job_system;
+
+		std::atomic<std::size_t>   _pending{0};
+		std::atomic<std::uint32_t> _priorities{0}; //< bit set of the priorities of the spawned jobs
+	};
+
+	/**
+	 * @brief A pool of worker threads, that execute small jobs from per-worker deques.
+	 * Jobs spawned by a worker are pushed to the bottom of its own deque and popped in LIFO order, while idle
+	 *   workers steal the oldest jobs from the top of the other deques. The thread that constructed the
+	 *   job system (usually the main thread) owns a deque, too. Jobs spawned by any other thread are pushed
+	 *   into a shared injection queue. Higher priorities are always searched first.
+	 *
+	 * Threads that have to wait for the completion of jobs (wait() and help_until()) execute other jobs
+	 *   in the meantime, instead of blocking. So jobs may wait for their children without exhausting
+	 *   the workers. But they only execute jobs with at least the priority they are waiting for, so e.g.
+	 *   the main thread doesn't start a long-running low-priority job, while it waits for a short one.
+	 *
+	 * The job system also satisfies the scheduler interface of async++ (see scheduler()), so async::spawn()
+	 *   and async::parallel_for() can be used on top of it.
+	 */
+	class job_system {
+	  public:
+		/// maximum number of jobs in each of the per-worker deques and the injection queues
+		/// if a queue overflows, the job is executed directly by the spawning thread
+		static constexpr auto queue_capacity = std::size_t(4096);
+
+		/// adapter for the async++ scheduler interface, that spawns tasks with a fixed priority
+		class priority_scheduler {
+		  public:
+			template <class Task>
+			void schedule(Task&& t)
+			{
+				_jobs->spawn([t = std::forward<Task>(t)]() mutable { t.run(); }, _priority);
+			}
+
+		  private:
+			friend class job_system;
+
+			job_system*  _jobs     = nullptr;
+			Job_priority _priority = Job_priority::normal;
+		};
+
+		static auto default_worker_count() -> std::size_t;
+
+		/// on_worker_start is executed by each worker thread before it starts to execute jobs
+		explicit job_system(std::size_t                      worker_count    = default_worker_count(),
+		                    std::function<void(std::size_t)> on_worker_start = {});
+		job_system(const job_system&) = delete;
+		auto operator=(const job_system&) -> job_system& = delete;
+		/// executes all remaining jobs before the workers are stopped
+		~job_system();
+
+		template <class F>
+		void spawn(F&& f, Job_priority priority = Job_priority::normal)
+		{
+			_push(_create_job(std::forward<F>(f), nullptr), priority);
+		}
+		template <class F>
+		void spawn(job_counter& counter, F&& f, Job_priority priority = Job_priority::normal)
+		{
+			counter._pending.fetch_add(1, std::memory_order_relaxed);
+			counter._priorities.fetch_or(1u << std::size_t(priority), std::memory_order_relaxed);
+			_push(_create_job(std::forward<F>(f), &counter), priority);
+		}
+
+		/// executes other jobs until all jobs of the counter are done
+		void wait(job_counter& counter)
+		{
+			help_until([&] { return counter.done(); }, counter.lowest_priority());
+		}
+
+		/**
+		 * @brief Executes other jobs with at least min_priority until the predicate returns true.
+		 * If there haven't been any such jobs for a while, jobs with lower priorities are executed, too.
+		 *   Otherwise threads, that all wait for lower priority jobs, would never finish.
+		 */
+		template <class Predicate>
+		void help_until(Predicate&& done, Job_priority min_priority)
+		{
+			for(auto idle_rounds = 0; !done();) {
+				auto priority = idle_rounds < helper_starvation_rounds ? min_priority : Job_priority::low;
+				if(try_run_one(priority))
+					idle_rounds = 0;
+				else
+					_idle(idle_rounds++);
+			}
+		}
+		/// uses the priority of the job, that is executed by the calling thread, as the minimum priority
+		template <class Predicate>
+		void help_until(Predicate&& done)
+		{
+			help_until(std::forward<Predicate>(done), current_priority());
+		}
+
+		/// executes a single pending job with at least min_priority on the calling thread, if there is one
+		auto try_run_one(Job_priority min_priority = Job_priority::low) -> bool;
+
+		/// priority of the job that is currently executed by the calling thread
+		/// or normal if it isn't executing one (low if there are no workers, that could execute the rest)
+		auto current_priority() const noexcept -> Job_priority;
+
+		/**
+		 * @brief Calls f(begin, end) for disjunct subranges of [begin, end) with at most grain_size elements
+		 *          and waits until all of them are done.
+		 * The calling thread executes chunks itself, while the rest is distributed among the workers.
+		 */
+		template <class F>
+		void parallel_for(std::size_t  begin,
+		                  std::size_t  end,
+		                  std::size_t  grain_size,
+		                  F&&          f,
+		                  Job_priority priority = Job_priority::high)
+		{
+			grain_size = std::max(grain_size, std::size_t(1));
+
+			auto counter = job_counter();
+			while(end - begin > grain_size) {
+				auto chunk_end = begin + grain_size;
+				spawn(counter, [&f, begin, chunk_end] { f(begin, chunk_end); }, priority);
+				begin = chunk_end;
+			}
+			if(begin < end)
+				f(begin, end);
+
+			wait(counter);
+		}
+
+		auto scheduler(Job_priority priority = Job_priority::normal) noexcept -> priority_scheduler&
+		{
+			return _schedulers[std::size_t(priority)];
+		}
+
+		auto worker_count() const noexcept { return _threads.size(); }
+		auto worker_thread_ids() const noexcept -> const std::vector<std::thread::id>& { return _thread_ids; }
+		/// true if the calling thread is one of the worker threads of this job system
+		auto is_worker_thread() const noexcept -> bool;
+
+	  private:
+		static constexpr auto inline_storage_size = std::size_t(48);
+		/// number of idle rounds (about 3ms), after which help_until() executes jobs of any priority
+		static constexpr auto helper_starvation_rounds = 80;
+
+		struct Job {
+			void (*execute)(Job&) = nullptr; //< invokes and destroys the callable
+			job_counter* counter  = nullptr;
+			Job_priority priority = Job_priority::normal;
+			alignas(std::max_align_t) std::byte storage[inline_storage_size];
+		};
+
+		/// Chase-Lev work-stealing deque with a fixed capacity
+		/// push() and pop() may only be called by the owning worker, steal() by any thread
+		class Deque {
+		  public:
+			Deque();
+
+			auto push(Job* job) -> bool;
+			auto pop() -> Job*;
+			auto steal() -> Job*;
+
+		  private:
+			alignas(detail::cache_line_size) std::atomic<std::int64_t> _top{0};
+			alignas(detail::cache_line_size) std::atomic<std::int64_t> _bottom{0};
+			std::unique_ptr<std::atomic<Job*>[]>                       _jobs;
+		};
+
+		struct alignas(detail::cache_line_size) Worker {
+			Deque         deques[job_priority_count];
+			std::uint64_t rng_state;
+		};
+
+		std::vector<std::unique_ptr<Worker>>    _workers;
+		std::vector<std::thread>                _threads;
+		std::vector<std::thread::id>            _thread_ids;
+		std::unique_ptr<mpmc_ring_buffer<Job*>> _injected[job_priority_count];
+		priority_scheduler                      _schedulers[job_priority_count];
+		std::function<void(std::size_t)>        _on_worker_start;
+
+		// sleeping workers are woken whenever the work epoch changes
+		std::atomic<std::uint64_t> _work_epoch{0};
+		std::atomic<int>           _sleeping{0};
+		std::atomic<bool>          _stopping{false};
+		std::mutex                 _sleep_mutex;
+		std::condition_variable    _sleep_cv;
+
+		template <class F>
+		static auto _create_job(F&& f, job_counter* counter) -> Job*
+		{
+			using Callable = std::decay_t<F>;
+
+			auto job     = new Job();
+			job->counter = counter;
+
+			if constexpr(sizeof(Callable) <= inline_storage_size
+			             && alignof(Callable) <= alignof(std::max_align_t)) {
+				new(job->storage) Callable(std::forward<F>(f));
+				job->execute = [](Job& job) {
+					struct Destroy_on_exit {
+						Callable& callable;
+						~Destroy_on_exit() { callable.~Callable(); }
+					};
+
+					auto destroy = Destroy_on_exit{*std::launder(reinterpret_cast<Callable*>(job.storage))};
+					destroy.callable();
+				};
+			} else {
+				new(job->storage) Callable*(new Callable(std::forward<F>(f)));
+				job->execute = [](Job& job) {
+					auto callable = std::unique_ptr<Callable>(
+					        *std::launder(reinterpret_cast<Callable**>(job.storage)));
+					(*callable)();
+				};
+			}
+
+			return job;
+		}
+
+		void _push(Job*, Job_priority);
+		void _execute(Job*);
+		auto _find_job(Worker* self, Job_priority min_priority = Job_priority::low) -> Job*;
+		auto _steal(Worker* self, std::size_t priority) -> Job*;
+		void _wake_sleeping();
+		void _idle(int rounds);
+		void _worker_main(std::size_t index);
+		auto _current_worker() const noexcept -> Worker*;
+	};
+
+} // namespace mirrage::util
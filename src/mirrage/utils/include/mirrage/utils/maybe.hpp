@@ -67,6 +67,7 @@ namespace mirrage::util {
 		{
 			if(o._valid) {
 				new(&_data) T(std::move(o._data));
+				o._data.~T();
 			}
 			o._valid = false;
 		}
@@ -85,8 +86,17 @@ namespace mirrage::util {
 
 		maybe& operator=(const maybe& o) noexcept
 		{
+			if(o._valid) {
+				if(_valid)
+					_data = o._data;
+				else
+					new(&_data) T(o._data);
+
+			} else if(_valid) {
+				_data.~T();
+			}
+
 			_valid = o._valid;
-			_data  = o._data;
 			return *this;
 		}
 		maybe& operator=(maybe&& o) noexcept
@@ -98,6 +108,9 @@ namespace mirrage::util {
 					new(&_data) T(std::move(o._data));
 
 				o._data.~T();
+
+			} else if(_valid) {
+				_data.~T();
 			}
 
 			_valid   = o._valid;
@@ -17,17 +17,20 @@
 #include <mirrage/utils/uuid.hpp>
 
 #include <concurrentqueue.h>
+#include <gsl/gsl>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <functional>
 #include <future>
-#include <shared_mutex>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
-#include <chrono>
 
 
 namespace mirrage::util {
@@ -39,13 +42,19 @@ namespace mirrage::util {
 	extern auto create_request_id() -> Request_id;
 
 	namespace detail {
-		constexpr auto default_mailbox_size = 16;
+		constexpr auto default_mailbox_size   = 16;
+		constexpr auto default_msg_batch_size = std::size_t(2);
 
 		class Mailbox_base;
 
 		template <typename T>
 		class Mailbox;
 
+		class Topic_base;
+
+		template <typename T>
+		class Topic;
+
 		template <typename T>
 		using has_response_type = typename T::response_type;
 
@@ -92,10 +101,15 @@ namespace mirrage::util {
 		auto& bus() noexcept { return _bus; }
 
 		/// Subscribe to messages of type T, calling the given handler for each of them.
+		/// The handler may also accept a gsl::span<const T> instead, to process the messages in batches.
 		/// The queue_size is used as a hint for the temporary storage of unprocessed messages.
 		template <class T, std::size_t queue_size = detail::default_mailbox_size, typename Func>
 		void subscribe(Func&& handler);
 
+		/// Subscribe to messages of type T, processing up to batch_size messages at once.
+		template <class T, std::size_t batch_size, typename Func>
+		void subscribe_batched(std::size_t queue_size, Func&& handler);
+
 		/// Subscribe to a list of messages deduced from the argument types of the given handlers.
 		template <std::size_t queue_size = detail::default_mailbox_size, typename... Func>
 		void subscribe_to(Func&&... handler);
@@ -113,6 +127,9 @@ namespace mirrage::util {
 		template <typename Msg>
 		auto send_msg(const Msg& msg) -> message_result_t<Msg>;
 
+		template <typename Msg>
+		void send_bulk(gsl::span<const Msg> msgs);
+
 		void enable();
 		void disable();
 
@@ -125,8 +142,17 @@ namespace mirrage::util {
 	};
 
 
+	/// Messages are dispatched to the subscribers of their topic without locks, virtual calls or allocations.
+	/// The subscriber list of each message type is published RCU-style: senders only announce their presence
+	///   in the current epoch and (un-)subscriptions replace the list and wait for all older readers to
+	///   finish before the old list is freed.
 	class Message_bus {
 	  public:
+		Message_bus() = default;
+		Message_bus(const Message_bus&) = delete;
+		Message_bus& operator=(const Message_bus&) = delete;
+		~Message_bus();
+
 		/// thread-safe
 		template <typename Msg, typename... Arg>
 		void send(Arg&&... arg)
@@ -138,50 +164,38 @@ namespace mirrage::util {
 		template <typename Msg>
 		void send_msg(const Msg& msg, const void* self = nullptr);
 
+		/// thread-safe
+		template <typename Msg>
+		void send_bulk(gsl::span<const Msg> msgs, const void* self = nullptr);
+
 	  private:
 		template <typename T>
 		friend class detail::Mailbox;
 
-		struct Mailbox_ref {
-			Mailbox_ref() = default;
-			template <typename T>
-			Mailbox_ref(std::shared_ptr<detail::Mailbox<T>> mailbox);
-
-			template <typename T>
-			void exec_send(const T& m, const void* src) const;
+		static constexpr std::size_t topics_per_chunk = 64;
+		static constexpr std::size_t max_topic_chunks = 256;
 
-			std::weak_ptr<void>                     _mailbox;
-			std::function<void(void*, const void*)> _send;
+		struct Topic_chunk {
+			std::array<std::atomic<detail::Topic_base*>, topics_per_chunk> topics{};
 		};
 
-		struct Mailbox_array {
-			Mailbox_array() : data(), size(0) {}
-			Mailbox_array(std::size_t size)
-			  : data(new Mailbox_ref[size], std::default_delete<Mailbox_ref[]>()), size(size)
-			{
-			}
+		std::mutex                                              _topics_mutex; //< only for creating new topics
+		std::array<std::atomic<Topic_chunk*>, max_topic_chunks> _topic_chunks{};
 
-			template <typename... Ts>
-			auto with(Ts&&... args) -> Mailbox_array;
 
-			template <typename T>
-			auto without(std::weak_ptr<detail::Mailbox<T>> e) -> Mailbox_array;
-
-			std::shared_ptr<Mailbox_ref> data;
-			std::size_t                  size;
-		};
-
-		std::shared_mutex          _mutex;
-		std::vector<Mailbox_array> _groups;
+		template <typename T>
+		auto find_topic() noexcept -> detail::Topic<T>*;
 
+		template <typename T>
+		auto get_or_create_topic() -> detail::Topic<T>&;
 
 		/// thread-safe
 		template <typename T>
-		void register_mailbox(std::shared_ptr<detail::Mailbox<T>> mailbox);
+		void register_mailbox(detail::Mailbox<T>* mailbox);
 
-		/// thread-safe
+		/// thread-safe, blocks until the mailbox is no longer referenced by any concurrent sender
 		template <typename T>
-		void unregister_mailbox(std::weak_ptr<detail::Mailbox<T>> mailbox);
+		void unregister_mailbox(detail::Mailbox<T>* mailbox);
 	};
 } // namespace mirrage::util
 
@@ -8,7 +8,14 @@
 namespace mirrage::util {
 
 	namespace detail {
-		constexpr auto default_msg_batch_size = 2;
+		template <typename T>
+		struct span_element {
+			using type = T;
+		};
+		template <typename T>
+		struct span_element<gsl::span<T>> {
+			using type = std::remove_const_t<T>;
+		};
 
 		class Mailbox_base {
 		  public:
@@ -23,57 +30,81 @@ namespace mirrage::util {
 		};
 
 		template <typename T>
-		class Mailbox : public Mailbox_base, public std::enable_shared_from_this<Mailbox<T>> {
+		class Mailbox : public Mailbox_base {
 		  public:
-			template <typename Handler>
-			Mailbox(Message_bus& bus, Handler&& handler, std::size_t size = default_mailbox_size)
-			  : _queue(size, 0, 4)
-			  , _bus(bus)
-			  , _processor([h = std::forward<Handler>(handler)](Mailbox<T>& self) {
-				  T    msg[default_msg_batch_size];
-				  auto count = std::size_t(0);
-				  do {
-					  count = self._queue.try_dequeue_bulk(msg, default_msg_batch_size);
-					  std::for_each(std::begin(msg), std::begin(msg) + count, h);
-				  } while(count > 0);
-			  })
+			Mailbox(Message_bus& bus, std::size_t size = default_mailbox_size) : _queue(size, 0, 4), _bus(bus)
 			{
 			}
-			~Mailbox() { _bus.unregister_mailbox(this->weak_from_this()); }
+			~Mailbox() { _bus.unregister_mailbox(this); }
 
 			void send(const T& v)
 			{
-				if(_active.load())
+				if(_active.load(std::memory_order_relaxed))
 					_queue.enqueue(v);
 			}
+			void send_bulk(gsl::span<const T> msgs)
+			{
+				if(_active.load(std::memory_order_relaxed))
+					_queue.enqueue_bulk(msgs.data(), std::size_t(msgs.size()));
+			}
 
-			void register_mailbox() override { _bus.register_mailbox(this->shared_from_this()); }
+			void register_mailbox() override { _bus.register_mailbox(this); }
 
 			void enable() override { _active.store(true); }
 			void disable() override { _active.store(false); }
 
-			void process() override { _processor(*this); }
+		  protected:
+			/// dequeues all messages into the given buffer and passes them to on_batch(gsl::span<const T>)
+			template <std::size_t N, typename F>
+			void drain(std::array<T, N>& buffer, F&& on_batch)
+			{
+				auto count = std::size_t(0);
+				do {
+					count = _queue.try_dequeue_bulk(buffer.data(), N);
+					if(count > 0)
+						on_batch(gsl::span<const T>(buffer.data(), gsl::narrow<std::ptrdiff_t>(count)));
+				} while(count == N);
+			}
+
+		  private:
+			moodycamel::ConcurrentQueue<T> _queue;
+			Message_bus&                   _bus;
+			std::atomic<bool>              _active{true};
+		};
+
+		/// mailbox that stores its handler inline, so it can be invoked without type-erasure.
+		/// The handler is either called for each message or with a span of up to batch_size messages.
+		template <typename T, typename Handler, std::size_t batch_size = default_msg_batch_size>
+		class Handler_mailbox final : public Mailbox<T> {
+		  public:
+			template <typename H>
+			Handler_mailbox(Message_bus& bus, H&& handler, std::size_t size = default_mailbox_size)
+			  : Mailbox<T>(bus, size), _handler(std::forward<H>(handler))
+			{
+			}
+
+			void process() override
+			{
+				this->drain(_batch, [&](gsl::span<const T> msgs) {
+					if constexpr(std::is_invocable_v<Handler&, T&>) {
+						// the handler may modify its copy of the message
+						for(auto& msg : gsl::make_span(const_cast<T*>(msgs.data()), msgs.size()))
+							_handler(msg);
+					} else {
+						_handler(msgs);
+					}
+				});
+			}
 
 		  private:
-			moodycamel::ConcurrentQueue<T>   _queue;
-			Message_bus&                     _bus;
-			std::atomic<bool>                _active{true};
-			std::function<void(Mailbox<T>&)> _processor;
+			Handler                   _handler;
+			std::array<T, batch_size> _batch;
 		};
 
 		template <typename T>
 		class Response_mailbox : public Mailbox<T> {
 		  public:
-			Response_mailbox(Message_bus& bus, std::size_t size = default_mailbox_size)
-			  : Mailbox<T>(
-			          bus,
-			          [this](const T& msg) {
-				          if(auto iter = _mapping.find(msg.request_id); iter != _mapping.end()) {
-					          iter->second.set_value(msg);
-					          _mapping.erase(iter);
-				          }
-			          },
-			          size)
+			Response_mailbox(Message_bus& bus, std::size_t size = default_mailbox_size) : Mailbox<T>(bus, size)
 			{
 			}
 
@@ -88,7 +119,14 @@ namespace mirrage::util {
 
 			void process() override
 			{
-				Mailbox<T>::process();
+				this->drain(_batch, [&](gsl::span<const T> msgs) {
+					for(auto& msg : msgs) {
+						if(auto iter = _mapping.find(msg.request_id); iter != _mapping.end()) {
+							iter->second.promise.set_value(msg);
+							_mapping.erase(iter);
+						}
+					}
+				});
 
 				// remove mapping that reached their timeout without getting a response
 				auto now = std::chrono::steady_clock::now();
@@ -104,42 +142,168 @@ namespace mirrage::util {
 
 			static constexpr auto                 timeout = std::chrono::seconds(30);
 			std::unordered_map<Request_id, Entry> _mapping;
+			std::array<T, default_msg_batch_size> _batch;
+		};
+
+		/// Tracks the senders that are currently reading a subscriber list, so that replaced lists are only
+		///   freed after all senders that might still use them are done.
+		/// Readers are counted in one of two counters, selected by the current epoch. Writers flip the epoch
+		///   twice and wait for each counter to drain, so continuous reads can't starve them.
+		class Grace_period {
+		  public:
+			class Read_guard {
+			  public:
+				explicit Read_guard(std::atomic<std::int64_t>& readers) noexcept : _readers(&readers)
+				{
+					_readers->fetch_add(1);
+				}
+				Read_guard(const Read_guard&) = delete;
+				Read_guard& operator=(const Read_guard&) = delete;
+				~Read_guard() { _readers->fetch_sub(1); }
+
+			  private:
+				std::atomic<std::int64_t>* _readers;
+			};
+
+			auto read() noexcept { return Read_guard(_readers[_epoch.load() & 1u]); }
+
+			/// has to be externally synchronized with other calls to synchronize()
+			void synchronize() noexcept
+			{
+				for(auto i = 0; i < 2; i++) {
+					auto old_epoch = _epoch.fetch_add(1);
+					while(_readers[old_epoch & 1u].load() != 0)
+						std::this_thread::yield();
+				}
+			}
+
+		  private:
+			std::atomic<std::uint64_t> _epoch{0};
+			std::atomic<std::int64_t>  _readers[2] = {};
+		};
+
+		class Topic_base {
+		  public:
+			virtual ~Topic_base() = default;
+		};
+
+		/// all subscribers of messages of type T
+		template <typename T>
+		class Topic final : public Topic_base {
+		  public:
+			~Topic() { delete _subscribers.load(); }
+
+			void send(const T& msg, const void* self)
+			{
+				auto guard = _grace_period.read();
+
+				if(auto subscribers = _subscribers.load()) {
+					for(auto mailbox : *subscribers) {
+						if(static_cast<const Mailbox_base*>(mailbox) != self)
+							mailbox->send(msg);
+					}
+				}
+			}
+			void send_bulk(gsl::span<const T> msgs, const void* self)
+			{
+				auto guard = _grace_period.read();
+
+				if(auto subscribers = _subscribers.load()) {
+					for(auto mailbox : *subscribers) {
+						if(static_cast<const Mailbox_base*>(mailbox) != self)
+							mailbox->send_bulk(msgs);
+					}
+				}
+			}
+
+			void add(Mailbox<T>* mailbox)
+			{
+				_replace([&](auto& subscribers) { subscribers.push_back(mailbox); });
+			}
+			void remove(Mailbox<T>* mailbox)
+			{
+				_replace([&](auto& subscribers) {
+					subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), mailbox),
+					                  subscribers.end());
+				});
+			}
+
+		  private:
+			using Subscribers = std::vector<Mailbox<T>*>;
+
+			std::mutex                _write_mutex;
+			std::atomic<Subscribers*> _subscribers{nullptr};
+			Grace_period              _grace_period;
+
+			template <typename F>
+			void _replace(F&& modify)
+			{
+				auto lock = std::scoped_lock{_write_mutex};
+
+				auto old_subscribers = _subscribers.load();
+				auto new_subscribers = old_subscribers ? std::make_unique<Subscribers>(*old_subscribers)
+				                                       : std::make_unique<Subscribers>();
+				modify(*new_subscribers);
+
+				_subscribers.store(new_subscribers.release());
+				_grace_period.synchronize();
+				delete old_subscribers;
+			}
 		};
 	} // namespace detail
 
 	template <typename T, std::size_t queue_size, typename Func>
 	void Mailbox_collection::subscribe(Func&& handler)
+	{
+		subscribe_batched<T, detail::default_msg_batch_size>(queue_size, std::forward<Func>(handler));
+	}
+
+	template <typename T, std::size_t batch_size, typename Func>
+	void Mailbox_collection::subscribe_batched(std::size_t queue_size, Func&& handler)
 	{
 		MIRRAGE_INVARIANT(_boxes.find(type_uid_of<T>()) == _boxes.end(), "Listener already registered!");
 
-		using result_t = std::remove_reference_t<decltype(handler(std::declval<T&>()))>;
+		auto box = std::shared_ptr<detail::Mailbox<T>>();
 
-		if constexpr(is_request_message<T>) {
-			static_assert(std::is_same_v<result_t, typename T::response_type>,
-			              "Message handlers for request messages have to return the type specified in "
-			              "Request::response_type");
-		}
+		if constexpr(!std::is_invocable_v<Func&, T&>) {
+			static_assert(std::is_invocable_v<Func&, gsl::span<const T>>,
+			              "Message handlers have to accept either T& or gsl::span<const T>");
+			static_assert(!is_request_message<T>, "Request messages can't be processed in batches");
 
-		if constexpr(std::is_void_v<result_t>) {
-			auto box = std::make_shared<detail::Mailbox<T>>(_bus, std::forward<Func>(handler), queue_size);
-			box->register_mailbox();
-			_boxes.emplace(type_uid_of<T>(), std::move(box));
+			box = std::make_shared<detail::Handler_mailbox<T, std::decay_t<Func>, batch_size>>(
+			        _bus, std::forward<Func>(handler), queue_size);
 
 		} else {
-			auto handler_wrapper = [handler = std::forward<Func>(handler), this](T& msg) {
-				if constexpr(is_request_message<T>) {
-					auto resp       = handler(msg);
-					resp.request_id = msg.request_id;
-					_bus.send_msg(std::move(resp));
-				} else {
-					send_msg(handler(msg));
-				}
-			};
+			using result_t = std::remove_reference_t<decltype(handler(std::declval<T&>()))>;
 
-			auto box = std::make_shared<detail::Mailbox<T>>(_bus, std::move(handler_wrapper), queue_size);
-			box->register_mailbox();
-			_boxes.emplace(type_uid_of<T>(), std::move(box));
+			if constexpr(is_request_message<T>) {
+				static_assert(std::is_same_v<result_t, typename T::response_type>,
+				              "Message handlers for request messages have to return the type specified in "
+				              "Request::response_type");
+			}
+
+			if constexpr(std::is_void_v<result_t>) {
+				box = std::make_shared<detail::Handler_mailbox<T, std::decay_t<Func>, batch_size>>(
+				        _bus, std::forward<Func>(handler), queue_size);
+
+			} else {
+				auto handler_wrapper = [handler = std::forward<Func>(handler), this](T& msg) {
+					if constexpr(is_request_message<T>) {
+						auto resp       = handler(msg);
+						resp.request_id = msg.request_id;
+						_bus.send_msg(std::move(resp));
+					} else {
+						send_msg(handler(msg));
+					}
+				};
+
+				box = std::make_shared<detail::Handler_mailbox<T, decltype(handler_wrapper), batch_size>>(
+				        _bus, std::move(handler_wrapper), queue_size);
+			}
 		}
+
+		box->register_mailbox();
+		_boxes.emplace(type_uid_of<T>(), std::move(box));
 	}
 
 	template <std::size_t queue_size, typename... Func>
@@ -147,7 +311,8 @@ namespace mirrage::util {
 	{
 		apply(
 		        [&](auto&& h) {
-			        using T = std::decay_t<nth_func_arg_t<std::remove_reference_t<decltype(h)>, 0>>;
+			        using Arg = std::decay_t<nth_func_arg_t<std::remove_reference_t<decltype(h)>, 0>>;
+			        using T   = typename detail::span_element<Arg>::type;
 			        this->subscribe<T, queue_size>(std::forward<decltype(h)>(h));
 		        },
 		        std::forward<Func>(handler)...);
@@ -197,6 +362,15 @@ namespace mirrage::util {
 		}
 	}
 
+	template <typename Msg>
+	void Mailbox_collection::send_bulk(gsl::span<const Msg> msgs)
+	{
+		static_assert(!is_request_message<Msg>, "Request messages can't be send in bulk");
+
+		const auto self = _boxes.find(type_uid_of<Msg>());
+		_bus.send_bulk(msgs, self != _boxes.end() ? self->second.get() : nullptr);
+	}
+
 	inline void Mailbox_collection::enable()
 	{
 		for(auto&& [_, box] : _boxes) {
@@ -213,89 +387,74 @@ namespace mirrage::util {
 
 
 	template <typename T>
-	Message_bus::Mailbox_ref::Mailbox_ref(std::shared_ptr<detail::Mailbox<T>> mailbox)
-	  : _mailbox(std::static_pointer_cast<void>(std::move(mailbox))), _send(+[](void* mb, const void* m) {
-		  static_cast<detail::Mailbox<T>*>(mb)->send(*static_cast<const T*>(m));
-	  })
+	auto Message_bus::find_topic() noexcept -> detail::Topic<T>*
 	{
-	}
+		const auto id    = std::size_t(type_uid_of<T>());
+		const auto chunk = id / topics_per_chunk;
+		if(chunk >= max_topic_chunks)
+			return nullptr;
 
-	template <typename T>
-	void Message_bus::Mailbox_ref::exec_send(const T& m, const void* src) const
-	{
-		if(auto dst = _mailbox.lock(); dst && (src == nullptr || src != dst.get())) {
-			_send(dst.get(), static_cast<const void*>(&m));
-		}
-	}
+		auto topics = _topic_chunks[chunk].load(std::memory_order_acquire);
+		if(!topics)
+			return nullptr;
 
-	template <typename... Ts>
-	auto Message_bus::Mailbox_array::with(Ts&&... args) -> Mailbox_array
-	{
-		auto r    = Mailbox_array(size + 1);
-		auto back = std::copy(data.get(), data.get() + size, r.data.get());
-		*back     = Mailbox_ref{std::forward<Ts>(args)...};
-		return r;
+		return static_cast<detail::Topic<T>*>(
+		        topics->topics[id % topics_per_chunk].load(std::memory_order_acquire));
 	}
 
 	template <typename T>
-	auto Message_bus::Mailbox_array::without(std::weak_ptr<detail::Mailbox<T>> e) -> Mailbox_array
+	auto Message_bus::get_or_create_topic() -> detail::Topic<T>&
 	{
-		auto begin = data.get();
-		auto end   = data.get() + size;
-		auto iter  = std::find_if(begin, end, [&](auto& mb) {
-            return !mb._mailbox.owner_before(e) && !e.owner_before(mb._mailbox);
-        });
-
-		if(iter != end) {
-			auto r = Mailbox_array(size);
-			auto i = std::copy(begin, iter, r.data.get());
-			std::copy(iter + 1, end, i);
-			return r;
+		if(auto topic = find_topic<T>())
+			return *topic;
 
-		} else {
-			return *this;
-		}
-	}
+		const auto id    = std::size_t(type_uid_of<T>());
+		const auto chunk = id / topics_per_chunk;
+		MIRRAGE_INVARIANT(chunk < max_topic_chunks, "Too many message types: " << id);
 
-	template <typename T>
-	void Message_bus::register_mailbox(std::shared_ptr<detail::Mailbox<T>> mailbox)
-	{
-		auto _ = std::unique_lock(_mutex);
+		auto lock = std::scoped_lock{_topics_mutex};
 
-		const auto id = type_uid_of<T>();
-		if(std::size_t(id) >= _groups.size()) {
-			_groups.resize(id + 1);
+		auto topics = _topic_chunks[chunk].load(std::memory_order_acquire);
+		if(!topics) {
+			topics = new Topic_chunk();
+			_topic_chunks[chunk].store(topics, std::memory_order_release);
 		}
 
-		_groups[id] = _groups[id].with(std::move(mailbox));
+		auto& slot  = topics->topics[id % topics_per_chunk];
+		auto  topic = slot.load(std::memory_order_acquire);
+		if(!topic) {
+			topic = new detail::Topic<T>();
+			slot.store(topic, std::memory_order_release);
+		}
+
+		return *static_cast<detail::Topic<T>*>(topic);
 	}
 
 	template <typename T>
-	void Message_bus::unregister_mailbox(std::weak_ptr<detail::Mailbox<T>> mailbox)
+	void Message_bus::register_mailbox(detail::Mailbox<T>* mailbox)
 	{
-		auto _ = std::unique_lock(_mutex);
+		get_or_create_topic<T>().add(mailbox);
+	}
 
-		const auto id = type_uid_of<T>();
-		if(std::size_t(id) < _groups.size()) {
-			_groups[id] = _groups[id].without(mailbox);
-		}
+	template <typename T>
+	void Message_bus::unregister_mailbox(detail::Mailbox<T>* mailbox)
+	{
+		if(auto topic = find_topic<T>())
+			topic->remove(mailbox);
 	}
 
 	template <typename Msg>
 	void Message_bus::send_msg(const Msg& msg, const void* self)
 	{
-		const auto id = type_uid_of<Msg>();
-
-		auto lock = std::shared_lock(_mutex);
-		if(std::size_t(id) < _groups.size()) {
-			// copy because the callbacks might register/unregister listeners
-			auto receivers = _groups[id];
-			lock.unlock();
+		if(auto topic = find_topic<Msg>())
+			topic->send(msg, self);
+	}
 
-			for(auto& mb : util::range(receivers.data.get(), receivers.data.get() + receivers.size)) {
-				mb.exec_send(msg, self);
-			}
-		}
+	template <typename Msg>
+	void Message_bus::send_bulk(gsl::span<const Msg> msgs, const void* self)
+	{
+		if(auto topic = find_topic<Msg>(); topic && !msgs.empty())
+			topic->send_bulk(msgs, self);
 	}
 
 } // namespace mirrage::util
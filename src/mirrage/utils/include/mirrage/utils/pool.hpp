@@ -7,10 +7,10 @@
 
 #pragma once
 
+#include <mirrage/utils/flat_map.hpp>
 #include <mirrage/utils/log.hpp>
 #include <mirrage/utils/min_max.hpp>
 #include <mirrage/utils/ranges.hpp>
-#include <mirrage/utils/sorted_vector.hpp>
 #include <mirrage/utils/string_utils.hpp>
 
 #include <doctest.h>
@@ -132,7 +132,7 @@ namespace mirrage::util {
 		using chunk_type = std::unique_ptr<storage_t[]>;
 		std::vector<chunk_type>  _chunks;
 		IndexType                _used_elements = 0;
-		sorted_vector<IndexType> _freelist;
+		flat_set<IndexType>      _freelist;
 
 		unsigned char* _get_raw(IndexType i)
 		{
@@ -250,7 +250,7 @@ namespace mirrage::util {
 		}
 
 	  private:
-		using free_iterator = typename sorted_vector<index_type>::const_iterator;
+		using free_iterator = typename flat_set<index_type>::const_iterator;
 
 		Pool*         _pool;
 		index_type    _logical_index;  ///< without empty slots
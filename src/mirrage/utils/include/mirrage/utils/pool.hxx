@@ -214,7 +214,7 @@ namespace mirrage::util {
 				// find first free slot
 				auto first_empty = util::maybe<IndexType>{};
 				if constexpr(max_free_slots > 0) {
-					auto min = std::lower_bound(_freelist.begin(), _freelist.end(), i);
+					auto min = _freelist.lower_bound(i);
 					if(min != _freelist.end()) {
 						auto min_v = *min;
 						_freelist.erase(min);
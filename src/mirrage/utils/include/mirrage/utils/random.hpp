@@ -7,11 +7,353 @@
 
 #pragma once
 
+#include <gsl/gsl>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <random>
+#include <type_traits>
 
 namespace mirrage::util {
 
-	using default_rand = std::mt19937_64;
+	namespace detail {
+		constexpr auto rotl(std::uint64_t x, int k) noexcept -> std::uint64_t
+		{
+			return (x << k) | (x >> (64 - k));
+		}
+
+		constexpr auto splitmix64(std::uint64_t& x) noexcept -> std::uint64_t
+		{
+			auto z = (x += 0x9e3779b97f4a7c15ull);
+			z      = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+			z      = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+			return z ^ (z >> 31);
+		}
+
+		/// uniform float in [0, 1) from the upper 24 bits
+		constexpr auto to_unit_float(std::uint64_t x) noexcept -> float
+		{
+			return float(x >> 40) * (1.f / float(1u << 24));
+		}
+
+		/// uniform float in [0, 1) from a UniformRandomBitGenerator
+		template <class Rng>
+		auto uniform_float(Rng& rng) -> float
+		{
+			if constexpr(Rng::min() == 0 && Rng::max() == std::numeric_limits<std::uint64_t>::max()) {
+				return to_unit_float(rng());
+			} else if constexpr(Rng::min() == 0 && Rng::max() == std::numeric_limits<std::uint32_t>::max()) {
+				return to_unit_float(std::uint64_t(rng()) << 32);
+			} else {
+				// generate_canonical may return 1 due to rounding
+				return std::min(std::generate_canonical<float, 24>(rng), 1.f - 1.f / float(1u << 24));
+			}
+		}
+
+		template <class T>
+		constexpr auto is_seed_seq = !std::is_convertible_v<T, std::uint64_t>;
+	} // namespace detail
+
+	/**
+	 * @brief xoshiro256** by David Blackman and Sebastiano Vigna (http://prng.di.unimi.it)
+	 * A fast general purpose generator with 32 bytes of state and a period of 2^256-1, that satisfies
+	 *   the UniformRandomBitGenerator requirements.
+	 * jump() advances the state by 2^128 steps, which can be used to create independent
+	 *   streams (e.g. one per thread) from a single seed.
+	 */
+	class xoshiro256ss {
+	  public:
+		using result_type = std::uint64_t;
+
+		static constexpr auto min() noexcept { return std::numeric_limits<result_type>::min(); }
+		static constexpr auto max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+		constexpr explicit xoshiro256ss(std::uint64_t seed = 0x2545f4914f6cdd1dull) noexcept
+		{
+			this->seed(seed);
+		}
+
+		template <class SeedSeq, class = std::enable_if_t<detail::is_seed_seq<SeedSeq>>>
+		explicit xoshiro256ss(SeedSeq& seq)
+		{
+			seed(seq);
+		}
+
+		constexpr void seed(std::uint64_t seed) noexcept
+		{
+			for(auto& s : _state)
+				s = detail::splitmix64(seed);
+		}
+
+		template <class SeedSeq, class = std::enable_if_t<detail::is_seed_seq<SeedSeq>>>
+		void seed(SeedSeq& seq)
+		{
+			auto values = std::array<std::uint32_t, 8>();
+			seq.generate(values.begin(), values.end());
+
+			// mixed by splitmix64, so low-entropy seeds (and in particular zero) don't result in a bad state
+			auto x = std::uint64_t(0);
+			for(auto i = std::size_t(0); i < _state.size(); i++) {
+				x += (std::uint64_t(values[i * 2]) << 32) | values[i * 2 + 1];
+				_state[i] = detail::splitmix64(x);
+			}
+		}
+
+		constexpr auto operator()() noexcept -> result_type
+		{
+			const auto result = detail::rotl(_state[1] * 5, 7) * 9;
+			const auto t      = _state[1] << 17;
+
+			_state[2] ^= _state[0];
+			_state[3] ^= _state[1];
+			_state[1] ^= _state[2];
+			_state[0] ^= _state[3];
+
+			_state[2] ^= t;
+			_state[3] = detail::rotl(_state[3], 45);
+
+			return result;
+		}
+
+		void discard(unsigned long long n) noexcept
+		{
+			for(; n > 0; n--)
+				(*this)();
+		}
+
+		/// equivalent to 2^128 calls to operator()
+		constexpr void jump() noexcept
+		{
+			_jump({0x180ec6d33cfd0abaull,
+			       0xd5a61266f0c9392cull,
+			       0xa9582618e03fc9aaull,
+			       0x39abdc4529b1661cull});
+		}
+		/// equivalent to 2^192 calls to operator()
+		constexpr void long_jump() noexcept
+		{
+			_jump({0x76e15d3efefdcbbfull,
+			       0xc5004e441c522fb3ull,
+			       0x77710069854ee241ull,
+			       0x39109bb02acbe635ull});
+		}
+
+		/// returns a copy of this generator and jumps ahead, so the streams of both don't overlap
+		constexpr auto fork() noexcept -> xoshiro256ss
+		{
+			auto copy = *this;
+			jump();
+			return copy;
+		}
+
+		friend auto operator==(const xoshiro256ss& lhs, const xoshiro256ss& rhs) noexcept
+		{
+			return lhs._state == rhs._state;
+		}
+		friend auto operator!=(const xoshiro256ss& lhs, const xoshiro256ss& rhs) noexcept
+		{
+			return !(lhs == rhs);
+		}
+
+	  private:
+		friend class xoshiro256ss_x4;
+
+		std::array<std::uint64_t, 4> _state{};
+
+		constexpr void _jump(const std::array<std::uint64_t, 4>& polynomial) noexcept
+		{
+			auto state = std::array<std::uint64_t, 4>{};
+			for(auto word : polynomial) {
+				for(auto b = 0; b < 64; b++) {
+					if(word & (std::uint64_t(1) << b)) {
+						for(auto i = std::size_t(0); i < state.size(); i++)
+							state[i] ^= _state[i];
+					}
+					(*this)();
+				}
+			}
+			_state = state;
+		}
+	};
+
+	/**
+	 * @brief PCG32 (XSH-RR variant) by Melissa O'Neill (https://www.pcg-random.org)
+	 * 16 bytes of state and 32-bit results, with 2^63 selectable streams and O(log n) jump-ahead.
+	 */
+	class pcg32 {
+	  public:
+		using result_type = std::uint32_t;
+
+		static constexpr auto min() noexcept { return std::numeric_limits<result_type>::min(); }
+		static constexpr auto max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+		constexpr explicit pcg32(std::uint64_t seed   = 0x853c49e6748fea9bull,
+		                         std::uint64_t stream = 0xda3e39cb94b95bdbull) noexcept
+		{
+			this->seed(seed, stream);
+		}
+
+		template <class SeedSeq, class = std::enable_if_t<detail::is_seed_seq<SeedSeq>>>
+		explicit pcg32(SeedSeq& seq)
+		{
+			auto values = std::array<std::uint32_t, 4>();
+			seq.generate(values.begin(), values.end());
+			seed((std::uint64_t(values[0]) << 32) | values[1], (std::uint64_t(values[2]) << 32) | values[3]);
+		}
+
+		constexpr void seed(std::uint64_t seed, std::uint64_t stream = 0xda3e39cb94b95bdbull) noexcept
+		{
+			_state     = 0;
+			_increment = (stream << 1) | 1;
+			(*this)();
+			_state += seed;
+			(*this)();
+		}
+
+		constexpr auto operator()() noexcept -> result_type
+		{
+			const auto old = _state;
+			_state         = old * multiplier + _increment;
+
+			const auto xorshifted = std::uint32_t(((old >> 18) ^ old) >> 27);
+			const auto rot        = std::uint32_t(old >> 59);
+			return (xorshifted >> rot) | (xorshifted << ((~rot + 1) & 31));
+		}
+
+		/// equivalent to n calls to operator(), but in O(log n)
+		constexpr void discard(std::uint64_t n) noexcept
+		{
+			auto cur_mult = multiplier;
+			auto cur_plus = _increment;
+			auto acc_mult = std::uint64_t(1);
+			auto acc_plus = std::uint64_t(0);
+
+			for(; n > 0; n /= 2) {
+				if(n & 1) {
+					acc_mult *= cur_mult;
+					acc_plus = acc_plus * cur_mult + cur_plus;
+				}
+				cur_plus = (cur_mult + 1) * cur_plus;
+				cur_mult *= cur_mult;
+			}
+
+			_state = acc_mult * _state + acc_plus;
+		}
+
+		friend constexpr auto operator==(const pcg32& lhs, const pcg32& rhs) noexcept
+		{
+			return lhs._state == rhs._state && lhs._increment == rhs._increment;
+		}
+		friend constexpr auto operator!=(const pcg32& lhs, const pcg32& rhs) noexcept
+		{
+			return !(lhs == rhs);
+		}
+
+	  private:
+		static constexpr auto multiplier = 6364136223846793005ull;
+
+		std::uint64_t _state     = 0;
+		std::uint64_t _increment = 0;
+	};
+
+	/**
+	 * @brief Four interleaved xoshiro256** streams for batch generation.
+	 * The state is stored per component instead of per stream, so the compiler can vectorize the
+	 *   generation of four values at once (e.g. with AVX2).
+	 */
+	class xoshiro256ss_x4 {
+	  public:
+		static constexpr auto lanes = std::size_t(4);
+
+		/// the lanes are initialized with non-overlapping streams, that are forked from the given generator
+		explicit xoshiro256ss_x4(xoshiro256ss& source) noexcept
+		{
+			for(auto lane = std::size_t(0); lane < lanes; lane++) {
+				auto stream = source.fork();
+				for(auto i = std::size_t(0); i < _state.size(); i++)
+					_state[i][lane] = stream._state[i];
+			}
+		}
+
+		auto operator()() noexcept -> std::array<std::uint64_t, lanes>
+		{
+			auto result = std::array<std::uint64_t, lanes>();
+			auto& [s0, s1, s2, s3] = _state;
+
+			for(auto l = std::size_t(0); l < lanes; l++) {
+				result[l] = detail::rotl(s1[l] * 5, 7) * 9;
+
+				const auto t = s1[l] << 17;
+				s2[l] ^= s0[l];
+				s3[l] ^= s1[l];
+				s1[l] ^= s2[l];
+				s0[l] ^= s3[l];
+				s2[l] ^= t;
+				s3[l] = detail::rotl(s3[l], 45);
+			}
+
+			return result;
+		}
+
+	  private:
+		std::array<std::array<std::uint64_t, lanes>, 4> _state;
+	};
+
+
+	/// fills out with uniformly distributed values in [min, max)
+	template <class Rng>
+	void generate_uniform(Rng& rng, gsl::span<float> out, float min = 0.f, float max = 1.f)
+	{
+		const auto scale = max - min;
+		for(auto& v : out)
+			v = min + detail::uniform_float(rng) * scale;
+	}
+	inline void generate_uniform(xoshiro256ss_x4& rng, gsl::span<float> out, float min = 0.f, float max = 1.f)
+	{
+		const auto scale = max - min;
+
+		for(auto i = std::ptrdiff_t(0); i < out.size(); i += xoshiro256ss_x4::lanes) {
+			const auto bits  = rng();
+			const auto count = std::min(std::ptrdiff_t(xoshiro256ss_x4::lanes), out.size() - i);
+			for(auto l = std::ptrdiff_t(0); l < count; l++)
+				out[i + l] = min + detail::to_unit_float(bits[std::size_t(l)]) * scale;
+		}
+	}
+
+	/// fills out with normal distributed values, using the Box-Muller transform on pairs of uniform values
+	template <class Rng>
+	void generate_normal(Rng& rng, gsl::span<float> out, float mean = 0.f, float stddev = 1.f)
+	{
+		constexpr auto two_pi = 6.283185307179586f;
+
+		auto box_muller = [&](float& a, float& b) {
+			const auto u1 = 1.f - a; // (0, 1], so the logarithm is defined
+			const auto u2 = b;
+
+			const auto r = std::sqrt(-2.f * std::log(u1)) * stddev;
+			a            = mean + r * std::cos(two_pi * u2);
+			b            = mean + r * std::sin(two_pi * u2);
+		};
+
+		generate_uniform(rng, out);
+
+		auto i = std::ptrdiff_t(0);
+		for(; i + 2 <= out.size(); i += 2)
+			box_muller(out[i], out[i + 1]);
+
+		if(i < out.size()) {
+			auto pair = std::array<float, 2>();
+			generate_uniform(rng, pair);
+			box_muller(pair[0], pair[1]);
+			out[i] = pair[0];
+		}
+	}
+
+
+	using default_rand = xoshiro256ss;
 
 	struct random_seed_seq {
 		using result_type = std::random_device::result_type;
@@ -9,6 +9,13 @@
 
 #include <mirrage/utils/maybe.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 
@@ -75,4 +82,294 @@ namespace mirrage::util {
 		std::size_t    _head = 0;
 		std::size_t    _tail = 0;
 	};
+
+
+	namespace detail {
+		// not std::hardware_destructive_interference_size, because that is missing in some standard libraries
+		constexpr auto cache_line_size = std::size_t(64);
+
+		constexpr auto next_power_of_two(std::size_t v) noexcept
+		{
+			auto result = std::size_t(1);
+			while(result < v)
+				result <<= 1;
+			return result;
+		}
+
+		/// uninitialized storage for a single T, that is explicitly constructed/destroyed by the containers
+		template <class T>
+		struct ring_buffer_slot {
+			std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+			template <class... Args>
+			void construct(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args&&...>)
+			{
+				new(&storage) T(std::forward<Args>(args)...);
+			}
+			auto get() noexcept -> T& { return *std::launder(reinterpret_cast<T*>(&storage)); }
+			/// moves the value into out and destroys it
+			void take(T& out) noexcept
+			{
+				out = std::move(get());
+				get().~T();
+			}
+		};
+	} // namespace detail
+
+	/**
+	 * @brief Lock-free bounded queue for exactly one producer and one consumer thread.
+	 * The capacity is rounded up to the next power of two. The read and write indices are placed on
+	 *   separate cache lines and each side caches the last seen index of the other one, so they only
+	 *   touch the same cache line if the queue is (almost) empty or full.
+	 */
+	template <class T>
+	class spsc_ring_buffer {
+	  public:
+		explicit spsc_ring_buffer(std::size_t capacity)
+		  : _mask(detail::next_power_of_two(capacity) - 1), _slots(new Slot[_mask + 1])
+		{
+		}
+		spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+		auto operator=(const spsc_ring_buffer&) -> spsc_ring_buffer& = delete;
+		~spsc_ring_buffer()
+		{
+			auto head = _producer.index.load(std::memory_order_acquire);
+			for(auto i = _consumer.index.load(std::memory_order_acquire); i != head; i++)
+				_slots[i & _mask].get().~T();
+		}
+
+		/// producer only
+		template <class... Args>
+		auto try_emplace(Args&&... args) -> bool
+		{
+			auto head = _producer.index.load(std::memory_order_relaxed);
+			if(head - _producer.cached_other >= capacity()) {
+				_producer.cached_other = _consumer.index.load(std::memory_order_acquire);
+				if(head - _producer.cached_other >= capacity())
+					return false;
+			}
+
+			_slots[head & _mask].construct(std::forward<Args>(args)...);
+			_producer.index.store(head + 1, std::memory_order_release);
+			return true;
+		}
+		auto try_push(T&& v) { return try_emplace(std::move(v)); }
+		auto try_push(const T& v) { return try_emplace(v); }
+
+		/// producer only; moves as many elements from [begin, begin+count) as fit into the queue
+		/// returns the number of moved elements
+		template <class Iter>
+		auto push_bulk(Iter begin, std::size_t count) -> std::size_t
+		{
+			auto head = _producer.index.load(std::memory_order_relaxed);
+			if(capacity() - (head - _producer.cached_other) < count)
+				_producer.cached_other = _consumer.index.load(std::memory_order_acquire);
+
+			count = std::min(count, capacity() - (head - _producer.cached_other));
+			for(auto i = std::size_t(0); i < count; i++, ++begin)
+				_slots[(head + i) & _mask].construct(std::move(*begin));
+
+			_producer.index.store(head + count, std::memory_order_release);
+			return count;
+		}
+
+		/// consumer only
+		auto try_pop(T& out) -> bool
+		{
+			auto tail = _consumer.index.load(std::memory_order_relaxed);
+			if(tail == _consumer.cached_other) {
+				_consumer.cached_other = _producer.index.load(std::memory_order_acquire);
+				if(tail == _consumer.cached_other)
+					return false;
+			}
+
+			_slots[tail & _mask].take(out);
+			_consumer.index.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// consumer only; moves up to max_count elements into out and returns their number
+		template <class OutIter>
+		auto pop_bulk(OutIter out, std::size_t max_count) -> std::size_t
+		{
+			auto tail = _consumer.index.load(std::memory_order_relaxed);
+			if(_consumer.cached_other - tail < max_count)
+				_consumer.cached_other = _producer.index.load(std::memory_order_acquire);
+
+			auto count = std::min(max_count, _consumer.cached_other - tail);
+			for(auto i = std::size_t(0); i < count; i++, ++out)
+				_slots[(tail + i) & _mask].take(*out);
+
+			_consumer.index.store(tail + count, std::memory_order_release);
+			return count;
+		}
+
+		/// only a snapshot, if called while the other thread modifies the queue
+		auto size_approx() const noexcept
+		{
+			auto tail = _consumer.index.load(std::memory_order_acquire);
+			return _producer.index.load(std::memory_order_acquire) - tail;
+		}
+		auto empty() const noexcept { return size_approx() == 0; }
+		auto capacity() const noexcept { return _mask + 1; }
+
+	  private:
+		using Slot = detail::ring_buffer_slot<T>;
+
+		/// index and cached index of the other side, which are only written by one thread
+		struct alignas(detail::cache_line_size) Side {
+			std::atomic<std::size_t> index{0};
+			std::size_t              cached_other = 0;
+		};
+
+		const std::size_t       _mask;
+		std::unique_ptr<Slot[]> _slots;
+		Side                    _producer;
+		Side                    _consumer;
+	};
+
+	/**
+	 * @brief Lock-free bounded queue for any number of producer and consumer threads
+	 *          (based on Dmitry Vyukov's bounded MPMC queue).
+	 * Each slot has a sequence number, that tells producers and consumers if it is ready for them in the
+	 *   current lap, so they only have to synchronize through a CAS on their own (cache-line-padded) index.
+	 * The capacity is rounded up to the next power of two and is at least 2, because with a single slot
+	 *   the sequence number of a filled slot would be the one expected by the producers of the next lap.
+	 * The bulk operations claim as many consecutive slots as are ready with a single CAS.
+	 */
+	template <class T>
+	class mpmc_ring_buffer {
+	  public:
+		explicit mpmc_ring_buffer(std::size_t capacity)
+		  : _mask(detail::next_power_of_two(std::max<std::size_t>(2, capacity)) - 1)
+		  , _slots(new Slot[_mask + 1])
+		{
+			for(auto i = std::size_t(0); i <= _mask; i++)
+				_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		mpmc_ring_buffer(const mpmc_ring_buffer&) = delete;
+		auto operator=(const mpmc_ring_buffer&) -> mpmc_ring_buffer& = delete;
+		~mpmc_ring_buffer()
+		{
+			auto head = _head.value.load(std::memory_order_acquire);
+			for(auto i = _tail.value.load(std::memory_order_acquire); i != head; i++)
+				_slots[i & _mask].get().~T();
+		}
+
+		template <class... Args>
+		auto try_emplace(Args&&... args) -> bool
+		{
+			auto pos = _head.value.load(std::memory_order_relaxed);
+			if(_claim<0>(_head, pos, 1) == 0)
+				return false;
+
+			auto& slot = _slots[pos & _mask];
+			slot.construct(std::forward<Args>(args)...);
+			slot.sequence.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+		auto try_push(T&& v) { return try_emplace(std::move(v)); }
+		auto try_push(const T& v) { return try_emplace(v); }
+
+		/// moves as many elements from [begin, begin+count) as fit into the queue
+		/// returns the number of moved elements
+		template <class Iter>
+		auto push_bulk(Iter begin, std::size_t count) -> std::size_t
+		{
+			auto pos = _head.value.load(std::memory_order_relaxed);
+			count    = _claim<0>(_head, pos, count);
+
+			for(auto i = std::size_t(0); i < count; i++, ++begin) {
+				auto& slot = _slots[(pos + i) & _mask];
+				slot.construct(std::move(*begin));
+				slot.sequence.store(pos + i + 1, std::memory_order_release);
+			}
+			return count;
+		}
+
+		auto try_pop(T& out) -> bool
+		{
+			auto pos = _tail.value.load(std::memory_order_relaxed);
+			if(_claim<1>(_tail, pos, 1) == 0)
+				return false;
+
+			auto& slot = _slots[pos & _mask];
+			slot.take(out);
+			slot.sequence.store(pos + _mask + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// moves up to max_count elements into out and returns their number
+		template <class OutIter>
+		auto pop_bulk(OutIter out, std::size_t max_count) -> std::size_t
+		{
+			auto pos   = _tail.value.load(std::memory_order_relaxed);
+			auto count = _claim<1>(_tail, pos, max_count);
+
+			for(auto i = std::size_t(0); i < count; i++, ++out) {
+				auto& slot = _slots[(pos + i) & _mask];
+				slot.take(*out);
+				slot.sequence.store(pos + i + _mask + 1, std::memory_order_release);
+			}
+			return count;
+		}
+
+		/// only a snapshot, if called while other threads modify the queue
+		auto size_approx() const noexcept
+		{
+			auto tail = _tail.value.load(std::memory_order_acquire);
+			auto head = _head.value.load(std::memory_order_acquire);
+			return head > tail ? head - tail : std::size_t(0);
+		}
+		auto empty() const noexcept { return size_approx() == 0; }
+		auto capacity() const noexcept { return _mask + 1; }
+
+	  private:
+		struct Slot : detail::ring_buffer_slot<T> {
+			std::atomic<std::size_t> sequence;
+		};
+
+		struct alignas(detail::cache_line_size) Index {
+			std::atomic<std::size_t> value{0};
+		};
+
+		const std::size_t       _mask;
+		std::unique_ptr<Slot[]> _slots;
+		Index                   _head;
+		Index                   _tail;
+
+		/// claims up to max_count consecutive slots, that are ready for the producers (Offset=0)
+		///   or consumers (Offset=1), starting at pos
+		/// returns the number of claimed slots and updates pos to the first one
+		template <std::size_t Offset>
+		auto _claim(Index& index, std::size_t& pos, std::size_t max_count) -> std::size_t
+		{
+			while(true) {
+				auto count = std::size_t(0);
+				auto stale = false;
+				for(; count < max_count; count++) {
+					auto seq = _slots[(pos + count) & _mask].sequence.load(std::memory_order_acquire);
+					auto dif = static_cast<std::intptr_t>(seq - (pos + count + Offset));
+					if(dif != 0) {
+						// dif<0: the slot is still used from the previous lap (full/empty)
+						// dif>0: another thread claimed it since we read the index
+						stale = count == 0 && dif > 0;
+						break;
+					}
+				}
+
+				if(stale) {
+					pos = index.value.load(std::memory_order_relaxed);
+					continue;
+				}
+
+				if(count == 0)
+					return 0;
+
+				// on failure pos is updated to the current value
+				if(index.value.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+					return count;
+			}
+		}
+	};
 } // namespace mirrage::util
@@ -0,0 +1,129 @@
+/** a hash map split into independently locked shards ************************
+ *                                                                           *
+ * Copyright (c) 2020 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+
+namespace mirrage::util {
+
+	/**
+	 * @brief A thread-safe wrapper around a map type, that distributes its keys over multiple
+	 *          independently locked shards.
+	 * Lookups only take a shared lock on a single shard, so concurrent readers never block each other
+	 *   and writers only block readers of the same shard.
+	 */
+	template <class Map, std::size_t ShardCount = 16>
+	class sharded_map {
+	  public:
+		using key_type    = typename Map::key_type;
+		using mapped_type = typename Map::mapped_type;
+		using hasher      = typename Map::hasher;
+
+		static_assert(ShardCount > 0 && (ShardCount & (ShardCount - 1)) == 0,
+		              "ShardCount has to be a power of two");
+
+		/// calls f(const mapped_type&) under a shared lock, if the key exists
+		template <class Key, class F>
+		auto visit(const Key& key, F&& f) const -> bool
+		{
+			auto& shard = _shard(key);
+			auto  lock  = std::shared_lock{shard.mutex};
+
+			auto iter = shard.map.find(key);
+			if(iter == shard.map.end())
+				return false;
+
+			f(iter->second);
+			return true;
+		}
+
+		/// calls f(Map&) with the shard that contains the key, under an exclusive lock
+		template <class Key, class F>
+		decltype(auto) modify(const Key& key, F&& f)
+		{
+			auto& shard = _shard(key);
+			auto  lock  = std::unique_lock{shard.mutex};
+			return f(shard.map);
+		}
+
+		/// calls f(Map&) for each shard, under an exclusive lock
+		template <class F>
+		void for_each_shard(F&& f)
+		{
+			for(auto& shard : _shards) {
+				auto lock = std::unique_lock{shard.mutex};
+				f(shard.map);
+			}
+		}
+
+		void clear()
+		{
+			for_each_shard([](auto& map) { map.clear(); });
+		}
+
+		auto size() const -> std::size_t
+		{
+			auto size = std::size_t(0);
+			for(auto& shard : _shards) {
+				auto lock = std::shared_lock{shard.mutex};
+				size += shard.map.size();
+			}
+			return size;
+		}
+
+	  private:
+		// aligned to avoid false sharing between the mutexes of neighbouring shards
+		struct alignas(64) Shard {
+			mutable std::shared_mutex mutex;
+			Map                       map;
+		};
+
+		std::array<Shard, ShardCount> _shards;
+
+		template <class Key>
+		auto _shard(const Key& key) const -> const Shard&
+		{
+			return _shards[_shard_index(key)];
+		}
+		template <class Key>
+		auto _shard(const Key& key) -> Shard&
+		{
+			return _shards[_shard_index(key)];
+		}
+
+		/// the inner maps select their buckets by the low bits of the hash, so the shard is selected by the
+		///   high bits of the (fibonacci-)remixed hash. Otherwise all keys of a shard would share their low
+		///   bits, e.g. for integer keys with an identity hash
+		template <class Key>
+		static auto _shard_index(const Key& key) -> std::size_t
+		{
+			if constexpr(ShardCount == 1) {
+				return 0;
+			} else {
+				constexpr auto shard_bits = [] {
+					auto bits = 0;
+					while((std::size_t(1) << bits) < ShardCount)
+						bits++;
+					return bits;
+				}();
+
+				auto hash = static_cast<std::uint64_t>(hasher{}(key)) * 0x9e3779b97f4a7c15ull;
+				return static_cast<std::size_t>(hash >> (64 - shard_bits));
+			}
+		}
+	};
+
+	template <class K, class V, std::size_t ShardCount = 16>
+	using sharded_unordered_map = sharded_map<std::unordered_map<K, V>, ShardCount>;
+
+} // namespace mirrage::util
@@ -19,6 +19,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 namespace mirrage::util {
 
@@ -191,4 +192,27 @@ namespace mirrage::util {
 
 		return true;
 	}
+
+	/// writes the string as the content of a JSON string literal (without the quotes), i.e. escapes all
+	///   quotes, backslashes and control characters
+	inline void write_json_escaped(std::ostream& out, std::string_view str)
+	{
+		constexpr auto hex = "0123456789abcdef";
+
+		for(auto c : str) {
+			switch(c) {
+				case '"': out << "\\\""; break;
+				case '\\': out << "\\\\"; break;
+				case '\n': out << "\\n"; break;
+				case '\r': out << "\\r"; break;
+				case '\t': out << "\\t"; break;
+				default:
+					if(auto code = static_cast<unsigned char>(c); code < 0x20)
+						out << "\\u00" << hex[code >> 4] << hex[code & 0xf];
+					else
+						out << c;
+					break;
+			}
+		}
+	}
 } // namespace mirrage::util
@@ -0,0 +1,93 @@
+/** fast non-cryptographic hash (XXH3) ***************************************
+ *                                                                           *
+ * Copyright (c) 2020 Florian Oetke                                          *
+ *  This file is distributed under the MIT License                           *
+ *  See LICENSE file for details.                                            *
+\*****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+/**
+ * Implementation of the XXH3 64- and 128-bit hash functions by Yann Collet
+ *   (https://github.com/Cyan4973/xxHash).
+ * The results are identical to XXH3_64bits_withSeed() and XXH3_128bits_withSeed() of the reference
+ *   implementation, so they can be compared with hashes calculated by other tools.
+ *
+ * XXH3 is not a cryptographic hash and should only be used to detect changes, deduplicate data or
+ *   calculate cache keys. For anything else (e.g. the cache file names based on md5) the old
+ *   hash should be kept for compatibility.
+ */
+namespace mirrage::util {
+
+	struct hash128 {
+		std::uint64_t low  = 0;
+		std::uint64_t high = 0;
+
+		friend constexpr auto operator==(const hash128& lhs, const hash128& rhs) noexcept
+		{
+			return lhs.low == rhs.low && lhs.high == rhs.high;
+		}
+		friend constexpr auto operator!=(const hash128& lhs, const hash128& rhs) noexcept
+		{
+			return !(lhs == rhs);
+		}
+		friend constexpr auto operator<(const hash128& lhs, const hash128& rhs) noexcept
+		{
+			return std::tie(lhs.high, lhs.low) < std::tie(rhs.high, rhs.low);
+		}
+	};
+
+	/// 32 hex digits, in the canonical (big-endian) order of the reference implementation
+	extern auto to_hex(const hash128&) -> std::string;
+
+	extern auto xxh3_64(const void* data, std::size_t size, std::uint64_t seed = 0) noexcept -> std::uint64_t;
+	extern auto xxh3_128(const void* data, std::size_t size, std::uint64_t seed = 0) noexcept -> hash128;
+
+	inline auto xxh3_64(std::string_view str, std::uint64_t seed = 0) noexcept
+	{
+		return xxh3_64(str.data(), str.size(), seed);
+	}
+	inline auto xxh3_128(std::string_view str, std::uint64_t seed = 0) noexcept
+	{
+		return xxh3_128(str.data(), str.size(), seed);
+	}
+
+	/**
+	 * @brief Streaming variant of xxh3_64 and xxh3_128, for data that is not contiguous in memory or
+	 *          too large to be read at once.
+	 * The data can be passed in chunks of any size and the result is identical to the one-shot functions.
+	 */
+	class xxh3_hasher {
+	  public:
+		explicit xxh3_hasher(std::uint64_t seed = 0) noexcept { reset(seed); }
+
+		void reset(std::uint64_t seed = 0) noexcept;
+		void update(const void* data, std::size_t size) noexcept;
+		void update(std::string_view str) noexcept { update(str.data(), str.size()); }
+
+		/// doesn't modify the state, so more data can be appended afterwards
+		auto digest64() const noexcept -> std::uint64_t;
+		auto digest128() const noexcept -> hash128;
+
+	  private:
+		static constexpr auto buffer_size = std::size_t(256);
+		static constexpr auto secret_size = std::size_t(192);
+
+		alignas(64) std::array<std::uint64_t, 8> _acc;
+		alignas(64) std::array<std::uint8_t, secret_size> _secret;
+		alignas(64) std::array<std::uint8_t, buffer_size> _buffer;
+		std::size_t   _buffered_size    = 0;
+		std::size_t   _stripes_in_block = 0;
+		std::uint64_t _total_size       = 0;
+		std::uint64_t _seed             = 0;
+
+		void _digest_long(std::array<std::uint64_t, 8>& acc) const noexcept;
+	};
+
+} // namespace mirrage::util
@@ -0,0 +1,164 @@
+#include <mirrage/utils/async_log_appender.hpp>
+
+#include <chrono>
+#include <iomanip>
+
+
+namespace mirrage::util {
+
+	namespace {
+		constexpr auto batch_size = std::size_t(64);
+
+		/// time and thread of the record, that is currently written by the background thread
+		struct Origin {
+			plog::util::Time time;
+			unsigned int     tid;
+		};
+		thread_local const Origin* current_origin = nullptr;
+	} // namespace
+
+	auto log_formatter::format(const plog::Record& record) -> plog::util::nstring
+	{
+		const auto& time = current_origin ? current_origin->time : record.getTime();
+		const auto  tid  = current_origin ? current_origin->tid : record.getTid();
+
+		auto t = tm{};
+		plog::util::localtime_s(&t, &time.time);
+
+		auto ss = plog::util::nostringstream();
+		ss << t.tm_year + 1900 << "-" << std::setfill(PLOG_NSTR('0')) << std::setw(2) << t.tm_mon + 1
+		   << PLOG_NSTR("-") << std::setfill(PLOG_NSTR('0')) << std::setw(2) << t.tm_mday << PLOG_NSTR(" ");
+		ss << std::setfill(PLOG_NSTR('0')) << std::setw(2) << t.tm_hour << PLOG_NSTR(":")
+		   << std::setfill(PLOG_NSTR('0')) << std::setw(2) << t.tm_min << PLOG_NSTR(":")
+		   << std::setfill(PLOG_NSTR('0')) << std::setw(2) << t.tm_sec << PLOG_NSTR(".")
+		   << std::setfill(PLOG_NSTR('0')) << std::setw(3) << static_cast<int>(time.millitm)
+		   << PLOG_NSTR(" ");
+		ss << std::setfill(PLOG_NSTR(' ')) << std::setw(5) << std::left
+		   << plog::severityToString(record.getSeverity()) << PLOG_NSTR(" ");
+		ss << PLOG_NSTR("[") << tid << PLOG_NSTR("] ");
+		ss << PLOG_NSTR("[") << record.getFunc() << PLOG_NSTR("@") << record.getLine() << PLOG_NSTR("] ");
+		ss << record.getMessage() << PLOG_NSTR("\n");
+
+		return ss.str();
+	}
+
+
+	async_log_appender::async_log_appender(std::size_t max_queued_records)
+	  : _queue(max_queued_records), _thread([this] { _run(); })
+	{
+	}
+	async_log_appender::~async_log_appender()
+	{
+		{
+			auto lock = std::scoped_lock{_mutex};
+			_shutdown = true;
+		}
+		_wakeup.notify_one();
+		_thread.join();
+	}
+
+	auto async_log_appender::add_appender(plog::IAppender* appender) -> async_log_appender&
+	{
+		_appenders.emplace_back(appender);
+		return *this;
+	}
+
+	void async_log_appender::write(const plog::Record& record)
+	{
+		const auto fatal = record.getSeverity() == plog::fatal;
+
+		// checked before the entry is constructed, to avoid copying the message just to drop it
+		if(!fatal && _queue.size_approx() >= _queue.capacity()) {
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		auto entry = Entry{record.getSeverity(),
+		                   record.getTime(),
+		                   record.getTid(),
+		                   record.getFunc(),
+		                   record.getLine(),
+		                   record.getFile(),
+		                   record.getObject(),
+		                   record.getInstanceId(),
+		                   record.getMessage()};
+
+		_queued.fetch_add(1, std::memory_order_relaxed);
+		while(!_queue.try_push(std::move(entry))) {
+			if(!fatal) {
+				_queued.fetch_sub(1, std::memory_order_relaxed);
+				_dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			// fatal records wait until the background thread made room
+			_wakeup.notify_one();
+			std::this_thread::yield();
+		}
+
+		if(fatal)
+			flush();
+		else
+			_wakeup.notify_one();
+	}
+
+	void async_log_appender::flush()
+	{
+		auto lock = std::unique_lock{_mutex};
+		_wakeup.notify_one();
+		_empty.wait(lock, [&] { return _queued.load() == 0; });
+	}
+
+	void async_log_appender::_run()
+	{
+		auto batch = std::vector<Entry>(batch_size);
+
+		while(true) {
+			auto count = _queue.pop_bulk(batch.begin(), batch.size());
+
+			for(auto i = std::size_t(0); i < count; i++)
+				_write(batch[i]);
+
+			if(auto dropped = _dropped.load(std::memory_order_relaxed); dropped != _reported_drops) {
+				auto record = plog::Record(
+				        plog::warning, "async_log_appender", 0, "", nullptr, PLOG_DEFAULT_INSTANCE_ID);
+				record << "Dropped " << (dropped - _reported_drops)
+				       << " log messages, because the queue was full";
+				for(auto& appender : _appenders)
+					appender->write(record);
+
+				_reported_drops = dropped;
+			}
+
+			if(count > 0) {
+				_queued.fetch_sub(count);
+				continue;
+			}
+
+			auto lock = std::unique_lock{_mutex};
+			_empty.notify_all();
+
+			if(_shutdown && _queue.empty())
+				return;
+
+			// timeout in case a notification from write() got lost, because it doesn't hold the mutex
+			_wakeup.wait_for(lock, std::chrono::milliseconds(10));
+		}
+	}
+
+	void async_log_appender::_write(const Entry& entry)
+	{
+		auto origin    = Origin{entry.time, entry.tid};
+		current_origin = &origin;
+
+		auto record = plog::Record(
+		        entry.severity, entry.func.c_str(), entry.line, entry.file, entry.object, entry.instance_id);
+		record << entry.message;
+
+		for(auto& appender : _appenders)
+			appender->write(record);
+
+		current_origin = nullptr;
+	}
+
+} // namespace mirrage::util
@@ -0,0 +1,235 @@
+#include <mirrage/utils/cpu_profiler.hpp>
+
+#include <mirrage/utils/string_utils.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+
+namespace mirrage::util::cpu_profiler {
+
+	namespace {
+		constexpr auto max_captured_zones = std::size_t(1) << 22;
+		constexpr auto avg_weight         = 0.05;
+
+		struct Captured_zone {
+			const char*   name;
+			std::int64_t  begin_ns;
+			std::int64_t  end_ns;
+			std::uint32_t thread_id;
+		};
+
+		struct Profiler_state {
+			std::mutex                                          mutex;
+			std::vector<std::unique_ptr<detail::Thread_buffer>> buffers;
+			std::uint32_t                                       next_thread_id = 1;
+			std::unordered_map<std::uint32_t, std::string>      thread_names;
+
+			std::vector<Zone_stats>                           stats;
+			std::unordered_map<std::string_view, std::size_t> stats_lookup;
+			std::uint64_t                                     dropped = 0;
+
+			std::atomic<bool>          capturing{false};
+			std::int64_t               capture_start_ns = 0;
+			std::vector<Captured_zone> capture;
+		};
+		auto state() -> Profiler_state&
+		{
+			static auto state = Profiler_state();
+			return state;
+		}
+
+		/// returns the buffer to the pool, when its thread exits
+		struct Thread_buffer_handle {
+			detail::Thread_buffer* buffer = nullptr;
+
+			~Thread_buffer_handle()
+			{
+				if(buffer) {
+					auto& s    = state();
+					auto  lock = std::scoped_lock{s.mutex};
+
+					buffer->in_use = false;
+				}
+			}
+		};
+	} // namespace
+
+	namespace detail {
+		auto thread_buffer() -> Thread_buffer&
+		{
+			thread_local auto handle = Thread_buffer_handle{};
+			if(handle.buffer)
+				return *handle.buffer;
+
+			auto& s    = state();
+			auto  lock = std::scoped_lock{s.mutex};
+
+			auto free = std::find_if(s.buffers.begin(), s.buffers.end(), [](auto& b) { return !b->in_use; });
+			if(free != s.buffers.end()) {
+				handle.buffer = free->get();
+			} else {
+				handle.buffer = s.buffers.emplace_back(std::make_unique<Thread_buffer>()).get();
+			}
+
+			handle.buffer->in_use    = true;
+			handle.buffer->thread_id = s.next_thread_id++;
+			return *handle.buffer;
+		}
+	} // namespace detail
+
+	void end_frame()
+	{
+		auto& s    = state();
+		auto  lock = std::scoped_lock{s.mutex};
+
+		for(auto& stat : s.stats) {
+			stat.calls   = 0;
+			stat.time_ms = 0;
+		}
+
+		const auto capturing = s.capturing.load();
+
+		for(auto& buffer : s.buffers) {
+			auto begin = buffer->read_index;
+			auto end   = buffer->write_index.load(std::memory_order_acquire);
+			if(end - begin > detail::buffer_size) {
+				s.dropped += end - begin - detail::buffer_size;
+				begin = end - detail::buffer_size;
+			}
+
+			for(auto i = begin; i < end; i++) {
+				auto& event    = buffer->events[i & (detail::buffer_size - 1)];
+				auto  name     = event.name.load(std::memory_order_relaxed);
+				auto  begin_ns = event.begin_ns.load(std::memory_order_relaxed);
+				auto  end_ns   = event.end_ns.load(std::memory_order_relaxed);
+
+				// the slot might have been reused by the owning thread while we were reading it
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if(i + detail::buffer_size <= buffer->write_index.load(std::memory_order_relaxed)) {
+					s.dropped++;
+					continue;
+				}
+
+				auto [iter, inserted] = s.stats_lookup.try_emplace(name, s.stats.size());
+				if(inserted)
+					s.stats.emplace_back().name = name;
+
+				auto& stat = s.stats[iter->second];
+				stat.calls++;
+				stat.time_ms += double(end_ns - begin_ns) / 1'000'000.0;
+
+				if(capturing) {
+					if(s.capture.size() < max_captured_zones)
+						s.capture.push_back(Captured_zone{name, begin_ns, end_ns, buffer->thread_id});
+					else
+						s.dropped++;
+				}
+			}
+
+			buffer->read_index = end;
+		}
+
+		for(auto& stat : s.stats) {
+			if(stat.calls == 0)
+				continue;
+
+			if(stat.time_max_ms == 0) {
+				stat.time_avg_ms = stat.time_min_ms = stat.time_max_ms = stat.time_ms;
+			} else {
+				stat.time_avg_ms = stat.time_avg_ms * (1.0 - avg_weight) + stat.time_ms * avg_weight;
+				stat.time_min_ms = std::min(stat.time_min_ms, stat.time_ms);
+				stat.time_max_ms = std::max(stat.time_max_ms, stat.time_ms);
+			}
+		}
+	}
+
+	auto results() -> std::vector<Zone_stats>
+	{
+		auto& s    = state();
+		auto  lock = std::scoped_lock{s.mutex};
+
+		auto sorted = s.stats;
+		std::sort(sorted.begin(), sorted.end(), [](auto& lhs, auto& rhs) {
+			return lhs.time_avg_ms > rhs.time_avg_ms;
+		});
+		return sorted;
+	}
+	void reset_results()
+	{
+		auto& s    = state();
+		auto  lock = std::scoped_lock{s.mutex};
+		s.stats.clear();
+		s.stats_lookup.clear();
+		s.dropped = 0;
+	}
+
+	auto dropped_zones() -> std::uint64_t
+	{
+		auto& s    = state();
+		auto  lock = std::scoped_lock{s.mutex};
+		return s.dropped;
+	}
+
+	void set_thread_name(std::string name)
+	{
+		auto& buffer = detail::thread_buffer();
+
+		auto& s    = state();
+		auto  lock = std::scoped_lock{s.mutex};
+
+		s.thread_names[buffer.thread_id] = std::move(name);
+	}
+
+	void start_capture()
+	{
+		auto& s    = state();
+		auto  lock = std::scoped_lock{s.mutex};
+		s.capture.clear();
+		s.capture_start_ns = detail::now_ns();
+		s.capturing.store(true);
+	}
+	void stop_capture() { state().capturing.store(false); }
+	auto capturing() noexcept -> bool { return state().capturing.load(); }
+
+	void write_chrome_trace(std::ostream& out)
+	{
+		auto& s    = state();
+		auto  lock = std::scoped_lock{s.mutex};
+
+		auto us = [&](std::int64_t ns) { return double(ns - s.capture_start_ns) / 1000.0; };
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		auto first = true;
+		for(auto& [tid, name] : s.thread_names) {
+			out << (first ? "\n" : ",\n");
+			first = false;
+
+			out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+			    << ",\"args\":{\"name\":\"";
+			util::write_json_escaped(out, name);
+			out << "\"}}";
+		}
+
+		for(auto& zone : s.capture) {
+			// zones that started before the capture are still exported, but clamped to its start
+			auto begin_ns = std::max(zone.begin_ns, s.capture_start_ns);
+
+			out << (first ? "\n" : ",\n");
+			first = false;
+
+			out << "{\"name\":\"";
+			util::write_json_escaped(out, zone.name);
+			out << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << zone.thread_id
+			    << ",\"ts\":" << us(begin_ns) << ",\"dur\":" << double(zone.end_ns - begin_ns) / 1000.0
+			    << "}";
+		}
+
+		out << "\n]}\n";
+	}
+
+} // namespace mirrage::util::cpu_profiler
@@ -0,0 +1,102 @@
+#include <mirrage/utils/frame_arena.hpp>
+
+#include <mirrage/utils/log.hpp>
+
+#include <algorithm>
+
+
+namespace mirrage::util {
+
+	frame_arena::frame_arena(std::size_t chunk_size) : _chunk_size(chunk_size)
+	{
+		MIRRAGE_INVARIANT(chunk_size > 0, "The chunk size of a frame_arena can't be zero");
+	}
+	frame_arena::~frame_arena() = default;
+
+	void frame_arena::register_thread(std::thread::id id)
+	{
+		auto _ = std::scoped_lock(_mutex);
+
+		auto iter =
+		        std::find_if(_sub_arenas.begin(), _sub_arenas.end(), [&](auto& e) { return e.first == id; });
+		if(iter == _sub_arenas.end())
+			_sub_arenas.emplace_back(id, std::make_unique<Sub_arena>());
+	}
+
+	void frame_arena::reset()
+	{
+		_last_frame_stats = {};
+
+		for(auto& [_, sub_arena] : _sub_arenas) {
+			sub_arena->reset();
+
+			auto& s = sub_arena->frame_stats;
+			_last_frame_stats.allocations += s.allocations;
+			_last_frame_stats.bytes += s.bytes;
+			_last_frame_stats.heap_allocations += s.heap_allocations;
+			_last_frame_stats.capacity += s.capacity;
+			s = {};
+		}
+	}
+
+	auto frame_arena::_local() -> Sub_arena&
+	{
+		// linear search, because there are only a handful of threads and thread::id has no cheap hash
+		const auto id = std::this_thread::get_id();
+		for(auto& [thread, sub_arena] : _sub_arenas) {
+			if(thread == id)
+				return *sub_arena;
+		}
+
+		MIRRAGE_FAIL("Called frame_arena::allocate from unregistered thread: " << id);
+	}
+
+	auto frame_arena::Sub_arena::allocate(std::size_t size, std::size_t alignment, std::size_t chunk_size)
+	        -> void*
+	{
+		frame_stats.allocations++;
+		frame_stats.bytes += size;
+
+		for(; current_chunk < chunks.size(); current_chunk++, current_offset = 0) {
+			auto& chunk      = chunks[current_chunk];
+			auto  begin      = static_cast<void*>(chunk.data.get() + current_offset);
+			auto  space_left = chunk.size - current_offset;
+
+			if(std::align(alignment, size, begin, space_left)) {
+				current_offset =
+				        static_cast<std::size_t>(static_cast<char*>(begin) + size - chunk.data.get());
+				return begin;
+			}
+		}
+
+		// out of memory => allocate a new chunk that is large enough for this request
+		auto new_size = std::max(chunk_size, size + alignment);
+		chunks.push_back(Chunk{std::make_unique<char[]>(new_size), new_size});
+		frame_stats.heap_allocations++;
+
+		auto& chunk      = chunks.back();
+		auto  begin      = static_cast<void*>(chunk.data.get());
+		auto  space_left = chunk.size;
+		std::align(alignment, size, begin, space_left);
+		current_offset = static_cast<std::size_t>(static_cast<char*>(begin) + size - chunk.data.get());
+		return begin;
+	}
+
+	void frame_arena::Sub_arena::reset()
+	{
+		auto capacity = std::size_t(0);
+		for(auto& chunk : chunks)
+			capacity += chunk.size;
+
+		// replace fragmented chunks by a single one that can hold everything at once
+		if(chunks.size() > 1) {
+			chunks.clear();
+			chunks.push_back(Chunk{std::make_unique<char[]>(capacity), capacity});
+		}
+
+		current_chunk        = 0;
+		current_offset       = 0;
+		frame_stats.capacity = capacity;
+	}
+
+} // namespace mirrage::util
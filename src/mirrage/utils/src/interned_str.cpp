@@ -0,0 +1,137 @@
+#include <mirrage/utils/interned_str.hpp>
+
+#include <mirrage/utils/log.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace mirrage::util {
+
+	namespace {
+		struct Entry {
+			std::uint64_t id;
+			std::string   str;
+		};
+
+		/// open addressing with linear probing, that is never modified after an entry has been published
+		struct Table {
+			explicit Table(std::size_t capacity)
+			  : mask(capacity - 1), slots(std::make_unique<std::atomic<const Entry*>[]>(capacity))
+			{
+				for(auto i = std::size_t(0); i < capacity; i++)
+					slots[i].store(nullptr, std::memory_order_relaxed);
+			}
+
+			void insert(const Entry& entry)
+			{
+				for(auto i = entry.id;; i++) {
+					auto& slot = slots[i & mask];
+					if(!slot.load(std::memory_order_relaxed)) {
+						slot.store(&entry, std::memory_order_release);
+						return;
+					}
+				}
+			}
+
+			std::size_t                                  mask;
+			std::unique_ptr<std::atomic<const Entry*>[]> slots;
+		};
+
+		/**
+		 * Readers only load the current table and its slots, so they never block.
+		 * Writers insert new entries into the current table under a lock. When the table becomes too full,
+		 *   all entries are copied into a larger table, which is then published. The old tables are kept
+		 *   alive, because readers might still be searching them (the table only grows, so that's at most
+		 *   as much memory as the current table).
+		 */
+		class Interner {
+		  public:
+			Interner()
+			{
+				_tables.emplace_back(std::make_unique<Table>(initial_capacity));
+				_table.store(_tables.back().get());
+			}
+
+			auto find(std::uint64_t id) const noexcept -> const Entry*
+			{
+				auto& table = *_table.load(std::memory_order_acquire);
+				for(auto i = id;; i++) {
+					auto entry = table.slots[i & table.mask].load(std::memory_order_acquire);
+					if(!entry || entry->id == id)
+						return entry;
+				}
+			}
+
+			auto insert(std::uint64_t id, std::string_view str) -> const Entry&
+			{
+				auto lock = std::scoped_lock(_mutex);
+
+				// recheck, because another thread might have inserted it in the meantime
+				if(auto entry = find(id))
+					return *entry;
+
+				if((_entries.size() + 1) * 2 > _tables.back()->mask + 1)
+					_grow();
+
+				auto& entry = *_entries.emplace_back(std::make_unique<Entry>(Entry{id, std::string(str)}));
+				_tables.back()->insert(entry);
+				return entry;
+			}
+
+		  private:
+			static constexpr auto initial_capacity = std::size_t(1024);
+
+			std::atomic<Table*>                 _table;
+			std::mutex                          _mutex;
+			std::vector<std::unique_ptr<Table>> _tables;
+			std::vector<std::unique_ptr<Entry>> _entries;
+
+			void _grow()
+			{
+				auto& table = *_tables.emplace_back(std::make_unique<Table>((_tables.back()->mask + 1) * 2));
+				for(auto& entry : _entries)
+					table.insert(*entry);
+
+				_table.store(&table, std::memory_order_release);
+			}
+		};
+
+		auto interner() -> Interner&
+		{
+			static auto instance = Interner();
+			return instance;
+		}
+	} // namespace
+
+
+	Interned_str::Interned_str(std::string_view str) : _id(detail::interned_str_hash(str))
+	{
+		if(_id == 0)
+			return;
+
+		auto& interner = util::interner();
+
+		auto entry = interner.find(_id);
+		if(!entry)
+			entry = &interner.insert(_id, str);
+
+		if(entry->str != str) {
+			MIRRAGE_FAIL("Hash collision between the interned strings '" << entry->str << "' and '" << str
+			                                                              << "'");
+		}
+	}
+
+	auto Interned_str::str() const -> const std::string&
+	{
+		static const auto empty = std::string();
+
+		auto entry = _id != 0 ? interner().find(_id) : nullptr;
+		return entry ? entry->str : empty;
+	}
+
+	auto Interned_str::interned() const -> bool { return _id == 0 || interner().find(_id) != nullptr; }
+
+} // namespace mirrage::util
@@ -0,0 +1,334 @@
+#include <mirrage/utils/job_system.hpp>
+
+#include <mirrage/utils/cpu_profiler.hpp>
+#include <mirrage/utils/log.hpp>
+
+#include <chrono>
+#include <exception>
+#include <string>
+#include <utility>
+
+
+namespace mirrage::util {
+
+	namespace {
+		struct Current_worker {
+			const job_system* jobs   = nullptr;
+			void*             worker = nullptr;
+		};
+		thread_local Current_worker current_worker;
+
+		/// priority of the innermost job executed by this thread or -1
+		thread_local auto executing_priority = -1;
+
+		auto next_random(std::uint64_t& state) noexcept
+		{
+			// xorshift64
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			return state;
+		}
+
+		constexpr auto spin_rounds = 64;
+	} // namespace
+
+
+	job_system::Deque::Deque() : _jobs(std::make_unique<std::atomic<Job*>[]>(queue_capacity)) {}
+
+	auto job_system::Deque::push(Job* job) -> bool
+	{
+		auto bottom = _bottom.load(std::memory_order_relaxed);
+		auto top    = _top.load(std::memory_order_acquire);
+		if(bottom - top >= std::int64_t(queue_capacity))
+			return false;
+
+		_jobs[std::size_t(bottom) % queue_capacity].store(job, std::memory_order_relaxed);
+		_bottom.store(bottom + 1, std::memory_order_release);
+		return true;
+	}
+
+	auto job_system::Deque::pop() -> Job*
+	{
+		// reserve the bottom element, before checking if a thief got there first
+		auto bottom = _bottom.load(std::memory_order_relaxed) - 1;
+		_bottom.store(bottom, std::memory_order_seq_cst);
+		auto top = _top.load(std::memory_order_seq_cst);
+
+		if(top > bottom) {
+			// empty
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		auto job = _jobs[std::size_t(bottom) % queue_capacity].load(std::memory_order_relaxed);
+		if(top == bottom) {
+			// last element: race against the thieves for it
+			if(!_top.compare_exchange_strong(
+			           top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				job = nullptr;
+
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+
+		return job;
+	}
+
+	auto job_system::Deque::steal() -> Job*
+	{
+		auto top    = _top.load(std::memory_order_seq_cst);
+		auto bottom = _bottom.load(std::memory_order_seq_cst);
+		if(top >= bottom)
+			return nullptr;
+
+		auto job = _jobs[std::size_t(top) % queue_capacity].load(std::memory_order_relaxed);
+		if(!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr; // lost the race against the owner or another thief
+
+		return job;
+	}
+
+
+	auto job_system::default_worker_count() -> std::size_t
+	{
+		// the main thread helps while it waits, so it counts as one of the workers
+		return std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+	}
+
+	job_system::job_system(std::size_t worker_count, std::function<void(std::size_t)> on_worker_start)
+	  : _on_worker_start(std::move(on_worker_start))
+	{
+		for(auto i = std::size_t(0); i < job_priority_count; i++) {
+			_injected[i]             = std::make_unique<mpmc_ring_buffer<Job*>>(queue_capacity);
+			_schedulers[i]._jobs     = this;
+			_schedulers[i]._priority = Job_priority(i);
+		}
+
+		// the first deque belongs to the constructing thread, unless it's already a worker of another system
+		_workers.reserve(worker_count + 1);
+		for(auto i = std::size_t(0); i <= worker_count; i++) {
+			auto& w      = _workers.emplace_back(std::make_unique<Worker>());
+			w->rng_state = 0x9E3779B97F4A7C15ull * (i + 1);
+		}
+
+		_threads.reserve(worker_count);
+		_thread_ids.reserve(worker_count);
+		for(auto i = std::size_t(0); i < worker_count; i++) {
+			_threads.emplace_back([this, i] { _worker_main(i); });
+			_thread_ids.emplace_back(_threads.back().get_id());
+		}
+
+		if(!current_worker.jobs)
+			current_worker = Current_worker{this, _workers.front().get()};
+	}
+
+	job_system::~job_system()
+	{
+		_stopping.store(true);
+		{
+			auto lock = std::scoped_lock(_sleep_mutex);
+			_work_epoch.fetch_add(1);
+		}
+		_sleep_cv.notify_all();
+
+		for(auto& t : _threads)
+			t.join();
+
+		// jobs that have been spawned by other threads while the workers shut down
+		while(try_run_one()) {
+		}
+
+		if(current_worker.jobs == this)
+			current_worker = Current_worker{};
+	}
+
+	auto job_system::try_run_one(Job_priority min_priority) -> bool
+	{
+		if(auto job = _find_job(_current_worker(), min_priority)) {
+			_execute(job);
+			return true;
+		}
+
+		return false;
+	}
+
+	auto job_system::current_priority() const noexcept -> Job_priority
+	{
+		if(executing_priority >= 0)
+			return Job_priority(executing_priority);
+
+		return _threads.empty() ? Job_priority::low : Job_priority::normal;
+	}
+
+	auto job_system::is_worker_thread() const noexcept -> bool
+	{
+		auto worker = _current_worker();
+		return worker && worker != _workers.front().get();
+	}
+
+	auto job_system::_current_worker() const noexcept -> Worker*
+	{
+		return current_worker.jobs == this ? static_cast<Worker*>(current_worker.worker) : nullptr;
+	}
+
+	void job_system::_push(Job* job, Job_priority priority)
+	{
+		auto p      = std::size_t(priority);
+		auto worker = _current_worker();
+
+		job->priority = priority;
+
+		auto pushed = worker ? worker->deques[p].push(job) : _injected[p]->try_push(job);
+		if(!pushed) {
+			// the queue is full, which should only happen if jobs are spawned much faster than they can
+			//   be executed. Executing the job directly is always correct and applies back pressure.
+			_execute(job);
+			return;
+		}
+
+		_work_epoch.fetch_add(1);
+		if(_sleeping.load() > 0)
+			_wake_sleeping();
+	}
+
+	void job_system::_execute(Job* job)
+	{
+		auto counter = job->counter;
+		auto outer   = std::exchange(executing_priority, int(job->priority));
+
+		try {
+			job->execute(*job);
+		} catch(const std::exception& e) {
+			LOG(plog::error) << "Uncaught exception in job: " << e.what();
+		} catch(...) {
+			LOG(plog::error) << "Uncaught exception in job";
+		}
+
+		executing_priority = outer;
+		delete job;
+
+		if(counter && counter->_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			// threads waiting for the counter might be asleep
+			if(_sleeping.load() > 0) {
+				_work_epoch.fetch_add(1);
+				_wake_sleeping();
+			}
+		}
+	}
+
+	auto job_system::_find_job(Worker* self, Job_priority min_priority) -> Job*
+	{
+		for(auto p = std::size_t(0); p <= std::size_t(min_priority); p++) {
+			if(self) {
+				if(auto job = self->deques[p].pop())
+					return job;
+			}
+
+			auto job = static_cast<Job*>(nullptr);
+			if(_injected[p]->try_pop(job))
+				return job;
+
+			if(auto job = _steal(self, p))
+				return job;
+		}
+
+		return nullptr;
+	}
+
+	auto job_system::_steal(Worker* self, std::size_t priority) -> Job*
+	{
+		auto count = _workers.size();
+		if(count == 0)
+			return nullptr;
+
+		// start at a random victim, so the thieves don't all contend for the same deque
+		thread_local auto thread_rng =
+		        std::uint64_t(std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1u);
+
+		auto& rng   = self ? self->rng_state : thread_rng;
+		auto  start = std::size_t(next_random(rng) % count);
+
+		for(auto i = std::size_t(0); i < count; i++) {
+			auto& victim = *_workers[(start + i) % count];
+			if(&victim == self)
+				continue;
+
+			if(auto job = victim.deques[priority].steal())
+				return job;
+		}
+
+		return nullptr;
+	}
+
+	void job_system::_wake_sleeping()
+	{
+		{
+			// the lock orders this notification after the epoch check of a worker that is about to sleep
+			auto lock = std::scoped_lock(_sleep_mutex);
+		}
+		_sleep_cv.notify_all();
+	}
+
+	void job_system::_idle(int rounds)
+	{
+		if(rounds < spin_rounds) {
+			std::this_thread::yield();
+			return;
+		}
+
+		// threads that help while they wait can't sleep indefinitely, because the predicate they are waiting
+		//   for might be satisfied by something other than a job of this system
+		auto epoch = _work_epoch.load();
+		auto lock  = std::unique_lock(_sleep_mutex);
+		_sleeping.fetch_add(1);
+		if(_work_epoch.load() == epoch)
+			_sleep_cv.wait_for(lock, std::chrono::microseconds(200));
+		_sleeping.fetch_sub(1);
+	}
+
+	void job_system::_worker_main(std::size_t index)
+	{
+		auto& self     = *_workers[index + 1];
+		current_worker = Current_worker{this, &self};
+
+		cpu_profiler::set_thread_name("job worker " + std::to_string(index));
+		if(_on_worker_start)
+			_on_worker_start(index);
+
+		auto idle_rounds = 0;
+		while(true) {
+			if(auto job = _find_job(&self)) {
+				_execute(job);
+				idle_rounds = 0;
+				continue;
+			}
+
+			if(idle_rounds++ < spin_rounds) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			auto epoch = _work_epoch.load();
+			if(_stopping.load())
+				break; // there are no jobs left and no new ones will be spawned by workers
+
+			// the deques are checked again after the sleeping counter has been incremented,
+			//   so a job that has been pushed concurrently can't be missed
+			auto lock = std::unique_lock(_sleep_mutex);
+			_sleeping.fetch_add(1);
+			if(auto job = _find_job(&self)) {
+				_sleeping.fetch_sub(1);
+				lock.unlock();
+				_execute(job);
+				idle_rounds = 0;
+				continue;
+			}
+			_sleep_cv.wait(lock, [&] { return _work_epoch.load() != epoch; });
+			_sleeping.fetch_sub(1);
+			idle_rounds = 0;
+		}
+
+		current_worker = Current_worker{};
+	}
+
+} // namespace mirrage::util
@@ -8,5 +8,17 @@ namespace mirrage::util {
 		static thread_local auto generator = random_uuid_generator{};
 		return generator.generate_id();
 	}
+
+	Message_bus::~Message_bus()
+	{
+		for(auto& chunk : _topic_chunks) {
+			if(auto topics = chunk.load()) {
+				for(auto& topic : topics->topics)
+					delete topic.load();
+
+				delete topics;
+			}
+		}
+	}
 	
 }
@@ -0,0 +1,578 @@
+#include <mirrage/utils/xxhash.hpp>
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MIRRAGE_XXH3_SSE2
+#endif
+
+
+namespace mirrage::util {
+
+	namespace {
+		constexpr auto prime32_1 = std::uint64_t(0x9E3779B1u);
+		constexpr auto prime32_2 = std::uint64_t(0x85EBCA77u);
+		constexpr auto prime32_3 = std::uint64_t(0xC2B2AE3Du);
+		constexpr auto prime64_1 = std::uint64_t(0x9E3779B185EBCA87ull);
+		constexpr auto prime64_2 = std::uint64_t(0xC2B2AE3D27D4EB4Full);
+		constexpr auto prime64_3 = std::uint64_t(0x165667B19E3779F9ull);
+		constexpr auto prime64_4 = std::uint64_t(0x85EBCA77C2B2AE63ull);
+		constexpr auto prime64_5 = std::uint64_t(0x27D4EB2F165667C5ull);
+		constexpr auto prime_mx1 = std::uint64_t(0x165667919E3779F9ull);
+		constexpr auto prime_mx2 = std::uint64_t(0x9FB21C651E98DF25ull);
+
+		constexpr auto stripe_size          = std::size_t(64);
+		constexpr auto secret_consume_rate  = std::size_t(8);
+		constexpr auto secret_size          = std::size_t(192);
+		constexpr auto secret_size_min      = std::size_t(136);
+		constexpr auto midsize_max          = std::size_t(240);
+		constexpr auto midsize_start_offset = std::size_t(3);
+		constexpr auto midsize_last_offset  = std::size_t(17);
+		constexpr auto last_acc_start       = std::size_t(7);
+		constexpr auto merge_accs_start     = std::size_t(11);
+		constexpr auto stripes_per_block    = (secret_size - stripe_size) / secret_consume_rate;
+		constexpr auto block_size           = stripe_size * stripes_per_block;
+
+		// clang-format off
+		alignas(64) constexpr std::uint8_t default_secret[secret_size] = {
+			0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+			0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+			0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+			0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+			0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+			0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+			0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+			0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+			0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+			0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+			0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+			0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+		};
+		// clang-format on
+
+		using Acc = std::array<std::uint64_t, 8>;
+
+		constexpr auto init_acc =
+		        Acc{prime32_3, prime64_1, prime64_2, prime64_3, prime64_4, prime32_2, prime64_5, prime32_1};
+
+		// the reference implementation defines the hash on little-endian reads
+		auto read32(const std::uint8_t* p) noexcept -> std::uint64_t
+		{
+			auto v = std::uint32_t(0);
+			std::memcpy(&v, p, sizeof(v));
+			return v;
+		}
+		auto read64(const std::uint8_t* p) noexcept -> std::uint64_t
+		{
+			auto v = std::uint64_t(0);
+			std::memcpy(&v, p, sizeof(v));
+			return v;
+		}
+		void write64(std::uint8_t* p, std::uint64_t v) noexcept { std::memcpy(p, &v, sizeof(v)); }
+
+		constexpr auto swap32(std::uint32_t x) noexcept -> std::uint32_t
+		{
+			return ((x << 24) & 0xff000000u) | ((x << 8) & 0x00ff0000u) | ((x >> 8) & 0x0000ff00u)
+			       | ((x >> 24) & 0x000000ffu);
+		}
+		constexpr auto swap64(std::uint64_t x) noexcept -> std::uint64_t
+		{
+			return (std::uint64_t(swap32(std::uint32_t(x))) << 32) | swap32(std::uint32_t(x >> 32));
+		}
+		constexpr auto rotl32(std::uint32_t x, int r) noexcept -> std::uint32_t
+		{
+			return (x << r) | (x >> (32 - r));
+		}
+		constexpr auto rotl64(std::uint64_t x, int r) noexcept -> std::uint64_t
+		{
+			return (x << r) | (x >> (64 - r));
+		}
+
+#if defined(__SIZEOF_INT128__)
+		// __extension__ keeps -pedantic from rejecting the non-standard type
+		__extension__ typedef unsigned __int128 uint128;
+#endif
+
+		auto mult64to128(std::uint64_t lhs, std::uint64_t rhs) noexcept -> hash128
+		{
+#if defined(__SIZEOF_INT128__)
+			auto product = static_cast<uint128>(lhs) * rhs;
+			return {std::uint64_t(product), std::uint64_t(product >> 64)};
+#else
+			auto lo_lo = (lhs & 0xffffffff) * (rhs & 0xffffffff);
+			auto hi_lo = (lhs >> 32) * (rhs & 0xffffffff);
+			auto lo_hi = (lhs & 0xffffffff) * (rhs >> 32);
+			auto hi_hi = (lhs >> 32) * (rhs >> 32);
+
+			auto cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+			auto upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+			auto lower = (cross << 32) | (lo_lo & 0xffffffff);
+			return {lower, upper};
+#endif
+		}
+		auto mul128_fold64(std::uint64_t lhs, std::uint64_t rhs) noexcept -> std::uint64_t
+		{
+			auto product = mult64to128(lhs, rhs);
+			return product.low ^ product.high;
+		}
+
+		constexpr auto xxh64_avalanche(std::uint64_t h) noexcept -> std::uint64_t
+		{
+			h ^= h >> 33;
+			h *= prime64_2;
+			h ^= h >> 29;
+			h *= prime64_3;
+			h ^= h >> 32;
+			return h;
+		}
+		constexpr auto avalanche(std::uint64_t h) noexcept -> std::uint64_t
+		{
+			h ^= h >> 37;
+			h *= prime_mx1;
+			h ^= h >> 32;
+			return h;
+		}
+		constexpr auto rrmxmx(std::uint64_t h, std::uint64_t size) noexcept -> std::uint64_t
+		{
+			h ^= rotl64(h, 49) ^ rotl64(h, 24);
+			h *= prime_mx2;
+			h ^= (h >> 35) + size;
+			h *= prime_mx2;
+			h ^= h >> 28;
+			return h;
+		}
+
+		auto mix16(const std::uint8_t* in, const std::uint8_t* secret, std::uint64_t seed) noexcept
+		        -> std::uint64_t
+		{
+			return mul128_fold64(read64(in) ^ (read64(secret) + seed),
+			                     read64(in + 8) ^ (read64(secret + 8) - seed));
+		}
+		void mix32(hash128&            acc,
+		           const std::uint8_t* in_1,
+		           const std::uint8_t* in_2,
+		           const std::uint8_t* secret,
+		           std::uint64_t       seed) noexcept
+		{
+			acc.low += mix16(in_1, secret, seed);
+			acc.low ^= read64(in_2) + read64(in_2 + 8);
+			acc.high += mix16(in_2, secret + 16, seed);
+			acc.high ^= read64(in_1) + read64(in_1 + 8);
+		}
+
+
+		// the core loop of large inputs, that is vectorized if SSE2 is available
+		void accumulate_stripe(Acc& acc, const std::uint8_t* in, const std::uint8_t* secret) noexcept
+		{
+#ifdef MIRRAGE_XXH3_SSE2
+			auto acc_vec = reinterpret_cast<__m128i*>(acc.data());
+			for(auto i = 0; i < 4; i++) {
+				auto data     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in) + i);
+				auto key      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+				auto data_key = _mm_xor_si128(data, key);
+				// 32x32->64 bit multiplication of the lower and upper halves of each lane
+				auto product = _mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+				// add the input to the neighbouring lane, so no information is lost if the product is 0
+				auto swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+				acc_vec[i]   = _mm_add_epi64(product, _mm_add_epi64(acc_vec[i], swapped));
+			}
+#else
+			for(auto i = std::size_t(0); i < acc.size(); i++) {
+				auto data     = read64(in + 8 * i);
+				auto data_key = data ^ read64(secret + 8 * i);
+				acc[i ^ 1] += data;
+				acc[i] += (data_key & 0xffffffff) * (data_key >> 32);
+			}
+#endif
+		}
+
+		void scramble(Acc& acc, const std::uint8_t* secret) noexcept
+		{
+#ifdef MIRRAGE_XXH3_SSE2
+			auto acc_vec = reinterpret_cast<__m128i*>(acc.data());
+			auto prime   = _mm_set1_epi32(int(prime32_1));
+			for(auto i = 0; i < 4; i++) {
+				auto data       = _mm_xor_si128(acc_vec[i], _mm_srli_epi64(acc_vec[i], 47));
+				auto key        = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+				auto data_key   = _mm_xor_si128(data, key);
+				auto product_lo = _mm_mul_epu32(data_key, prime);
+				auto product_hi = _mm_mul_epu32(_mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+				acc_vec[i]      = _mm_add_epi64(product_lo, _mm_slli_epi64(product_hi, 32));
+			}
+#else
+			for(auto i = std::size_t(0); i < acc.size(); i++) {
+				auto a = acc[i];
+				a ^= a >> 47;
+				a ^= read64(secret + 8 * i);
+				acc[i] = a * prime32_1;
+			}
+#endif
+		}
+
+		void accumulate(Acc&                acc,
+		                const std::uint8_t* in,
+		                const std::uint8_t* secret,
+		                std::size_t         stripes) noexcept
+		{
+			for(auto n = std::size_t(0); n < stripes; n++)
+				accumulate_stripe(acc, in + n * stripe_size, secret + n * secret_consume_rate);
+		}
+
+		/// processes all stripes of the input, except for the last one
+		void hash_long_loop(Acc&                acc,
+		                    const std::uint8_t* in,
+		                    std::size_t         size,
+		                    const std::uint8_t* secret) noexcept
+		{
+			auto blocks = (size - 1) / block_size;
+			for(auto n = std::size_t(0); n < blocks; n++) {
+				accumulate(acc, in + n * block_size, secret, stripes_per_block);
+				scramble(acc, secret + secret_size - stripe_size);
+			}
+
+			auto stripes = ((size - 1) - block_size * blocks) / stripe_size;
+			accumulate(acc, in + blocks * block_size, secret, stripes);
+			accumulate_stripe(
+			        acc, in + size - stripe_size, secret + secret_size - stripe_size - last_acc_start);
+		}
+
+		auto merge_accs(const Acc& acc, const std::uint8_t* secret, std::uint64_t start) noexcept
+		        -> std::uint64_t
+		{
+			auto result = start;
+			for(auto i = std::size_t(0); i < 4; i++)
+				result += mul128_fold64(acc[2 * i] ^ read64(secret + 16 * i),
+				                        acc[2 * i + 1] ^ read64(secret + 16 * i + 8));
+
+			return avalanche(result);
+		}
+
+		void init_custom_secret(std::uint8_t* secret, std::uint64_t seed) noexcept
+		{
+			for(auto i = std::size_t(0); i < secret_size; i += 16) {
+				write64(secret + i, read64(default_secret + i) + seed);
+				write64(secret + i + 8, read64(default_secret + i + 8) - seed);
+			}
+		}
+
+
+		auto hash64_short(const std::uint8_t* in, std::size_t size, std::uint64_t seed) noexcept
+		        -> std::uint64_t
+		{
+			const auto secret = default_secret;
+
+			if(size > 16) {
+				auto acc = size * prime64_1;
+				if(size > 128) {
+					for(auto i = std::size_t(0); i < 8; i++)
+						acc += mix16(in + 16 * i, secret + 16 * i, seed);
+					acc = avalanche(acc);
+
+					for(auto i = std::size_t(8); i < size / 16; i++)
+						acc += mix16(in + 16 * i, secret + 16 * (i - 8) + midsize_start_offset, seed);
+
+					acc += mix16(in + size - 16, secret + secret_size_min - midsize_last_offset, seed);
+					return avalanche(acc);
+				}
+
+				if(size > 32) {
+					if(size > 64) {
+						if(size > 96) {
+							acc += mix16(in + 48, secret + 96, seed);
+							acc += mix16(in + size - 64, secret + 112, seed);
+						}
+						acc += mix16(in + 32, secret + 64, seed);
+						acc += mix16(in + size - 48, secret + 80, seed);
+					}
+					acc += mix16(in + 16, secret + 32, seed);
+					acc += mix16(in + size - 32, secret + 48, seed);
+				}
+				acc += mix16(in, secret, seed);
+				acc += mix16(in + size - 16, secret + 16, seed);
+				return avalanche(acc);
+
+			} else if(size > 8) {
+				auto bitflip_1 = (read64(secret + 24) ^ read64(secret + 32)) + seed;
+				auto bitflip_2 = (read64(secret + 40) ^ read64(secret + 48)) - seed;
+				auto lo        = read64(in) ^ bitflip_1;
+				auto hi        = read64(in + size - 8) ^ bitflip_2;
+				return avalanche(size + swap64(lo) + hi + mul128_fold64(lo, hi));
+
+			} else if(size >= 4) {
+				seed ^= std::uint64_t(swap32(std::uint32_t(seed))) << 32;
+				auto bitflip = (read64(secret + 8) ^ read64(secret + 16)) - seed;
+				auto input   = read32(in + size - 4) + (read32(in) << 32);
+				return rrmxmx(input ^ bitflip, size);
+
+			} else if(size > 0) {
+				auto combined = (std::uint64_t(in[0]) << 16) | (std::uint64_t(in[size >> 1]) << 24)
+				                | std::uint64_t(in[size - 1]) | (std::uint64_t(size) << 8);
+				auto bitflip = (read32(secret) ^ read32(secret + 4)) + seed;
+				return xxh64_avalanche(combined ^ bitflip);
+
+			} else {
+				return xxh64_avalanche(seed ^ read64(secret + 56) ^ read64(secret + 64));
+			}
+		}
+
+		auto hash128_short(const std::uint8_t* in, std::size_t size, std::uint64_t seed) noexcept -> hash128
+		{
+			const auto secret = default_secret;
+
+			auto finalize = [&](const hash128& acc) {
+				auto h = hash128{acc.low + acc.high,
+				                 acc.low * prime64_1 + acc.high * prime64_4 + (size - seed) * prime64_2};
+				return hash128{avalanche(h.low), std::uint64_t(0) - avalanche(h.high)};
+			};
+
+			if(size > 16) {
+				auto acc = hash128{size * prime64_1, 0};
+				if(size > 128) {
+					for(auto i = std::size_t(32); i < 160; i += 32)
+						mix32(acc, in + i - 32, in + i - 16, secret + i - 32, seed);
+
+					acc.low  = avalanche(acc.low);
+					acc.high = avalanche(acc.high);
+
+					for(auto i = std::size_t(160); i <= size; i += 32)
+						mix32(acc, in + i - 32, in + i - 16, secret + midsize_start_offset + i - 160, seed);
+
+					mix32(acc,
+					      in + size - 16,
+					      in + size - 32,
+					      secret + secret_size_min - midsize_last_offset - 16,
+					      std::uint64_t(0) - seed);
+					return finalize(acc);
+				}
+
+				if(size > 32) {
+					if(size > 64) {
+						if(size > 96) {
+							mix32(acc, in + 48, in + size - 64, secret + 96, seed);
+						}
+						mix32(acc, in + 32, in + size - 48, secret + 64, seed);
+					}
+					mix32(acc, in + 16, in + size - 32, secret + 32, seed);
+				}
+				mix32(acc, in, in + size - 16, secret, seed);
+				return finalize(acc);
+
+			} else if(size > 8) {
+				auto bitflip_lo = (read64(secret + 32) ^ read64(secret + 40)) - seed;
+				auto bitflip_hi = (read64(secret + 48) ^ read64(secret + 56)) + seed;
+				auto input_lo   = read64(in);
+				auto input_hi   = read64(in + size - 8);
+
+				auto m = mult64to128(input_lo ^ input_hi ^ bitflip_lo, prime64_1);
+				m.low += std::uint64_t(size - 1) << 54;
+				input_hi ^= bitflip_hi;
+				m.high += input_hi + (input_hi & 0xffffffff) * (prime32_2 - 1);
+				m.low ^= swap64(m.high);
+
+				auto h = mult64to128(m.low, prime64_2);
+				h.high += m.high * prime64_2;
+				return {avalanche(h.low), avalanche(h.high)};
+
+			} else if(size >= 4) {
+				seed ^= std::uint64_t(swap32(std::uint32_t(seed))) << 32;
+				auto input   = read32(in) + (read32(in + size - 4) << 32);
+				auto bitflip = (read64(secret + 16) ^ read64(secret + 24)) + seed;
+
+				auto m = mult64to128(input ^ bitflip, prime64_1 + (std::uint64_t(size) << 2));
+				m.high += m.low << 1;
+				m.low ^= m.high >> 3;
+				m.low ^= m.low >> 35;
+				m.low *= prime_mx2;
+				m.low ^= m.low >> 28;
+				m.high = avalanche(m.high);
+				return m;
+
+			} else if(size > 0) {
+				auto combined_lo = (std::uint32_t(in[0]) << 16) | (std::uint32_t(in[size >> 1]) << 24)
+				                   | std::uint32_t(in[size - 1]) | (std::uint32_t(size) << 8);
+				auto combined_hi = rotl32(swap32(combined_lo), 13);
+				auto bitflip_lo  = (read32(secret) ^ read32(secret + 4)) + seed;
+				auto bitflip_hi  = (read32(secret + 8) ^ read32(secret + 12)) - seed;
+				return {xxh64_avalanche(combined_lo ^ bitflip_lo), xxh64_avalanche(combined_hi ^ bitflip_hi)};
+
+			} else {
+				return {xxh64_avalanche(seed ^ read64(secret + 64) ^ read64(secret + 72)),
+				        xxh64_avalanche(seed ^ read64(secret + 80) ^ read64(secret + 88))};
+			}
+		}
+
+		auto digest_long_64(const Acc& acc, const std::uint8_t* secret, std::uint64_t size) noexcept
+		{
+			return merge_accs(acc, secret + merge_accs_start, size * prime64_1);
+		}
+		auto digest_long_128(const Acc& acc, const std::uint8_t* secret, std::uint64_t size) noexcept
+		{
+			constexpr auto high_offset = secret_size - stripe_size - merge_accs_start;
+
+			return hash128{merge_accs(acc, secret + merge_accs_start, size * prime64_1),
+			               merge_accs(acc, secret + high_offset, ~(size * prime64_2))};
+		}
+
+		template <typename Digest>
+		auto hash_long(const std::uint8_t* in, std::size_t size, std::uint64_t seed, Digest&& digest) noexcept
+		{
+			alignas(64) auto acc = init_acc;
+			if(seed == 0) {
+				hash_long_loop(acc, in, size, default_secret);
+				return digest(acc, default_secret, size);
+			}
+
+			alignas(64) std::uint8_t secret[secret_size];
+			init_custom_secret(secret, seed);
+			hash_long_loop(acc, in, size, secret);
+			return digest(acc, secret, size);
+		}
+	} // namespace
+
+	auto to_hex(const hash128& hash) -> std::string
+	{
+		constexpr auto digits = "0123456789abcdef";
+
+		auto str = std::string(32, '0');
+		for(auto i = 0; i < 16; i++) {
+			str[std::size_t(15 - i)] = digits[(hash.high >> (4 * i)) & 0xf];
+			str[std::size_t(31 - i)] = digits[(hash.low >> (4 * i)) & 0xf];
+		}
+		return str;
+	}
+
+	auto xxh3_64(const void* data, std::size_t size, std::uint64_t seed) noexcept -> std::uint64_t
+	{
+		auto in = static_cast<const std::uint8_t*>(data);
+		if(size <= midsize_max)
+			return hash64_short(in, size, seed);
+		else
+			return hash_long(in, size, seed, digest_long_64);
+	}
+
+	auto xxh3_128(const void* data, std::size_t size, std::uint64_t seed) noexcept -> hash128
+	{
+		auto in = static_cast<const std::uint8_t*>(data);
+		if(size <= midsize_max)
+			return hash128_short(in, size, seed);
+		else
+			return hash_long(in, size, seed, digest_long_128);
+	}
+
+
+	void xxh3_hasher::reset(std::uint64_t seed) noexcept
+	{
+		_acc              = init_acc;
+		_buffered_size    = 0;
+		_stripes_in_block = 0;
+		_total_size       = 0;
+		_seed             = seed;
+
+		if(seed == 0)
+			std::memcpy(_secret.data(), default_secret, secret_size);
+		else
+			init_custom_secret(_secret.data(), seed);
+	}
+
+	namespace {
+		/// accumulates stripes that may cross the end of the current block
+		void consume_stripes(Acc&                acc,
+		                     std::size_t&        stripes_in_block,
+		                     const std::uint8_t* in,
+		                     std::size_t         stripes,
+		                     const std::uint8_t* secret) noexcept
+		{
+			if(stripes_per_block - stripes_in_block <= stripes) {
+				auto stripes_to_end = stripes_per_block - stripes_in_block;
+				accumulate(acc, in, secret + stripes_in_block * secret_consume_rate, stripes_to_end);
+				scramble(acc, secret + secret_size - stripe_size);
+				accumulate(acc, in + stripes_to_end * stripe_size, secret, stripes - stripes_to_end);
+				stripes_in_block = stripes - stripes_to_end;
+			} else {
+				accumulate(acc, in, secret + stripes_in_block * secret_consume_rate, stripes);
+				stripes_in_block += stripes;
+			}
+		}
+	} // namespace
+
+	void xxh3_hasher::update(const void* data, std::size_t size) noexcept
+	{
+		constexpr auto buffer_stripes = buffer_size / stripe_size;
+
+		auto in  = static_cast<const std::uint8_t*>(data);
+		auto end = in + size;
+		_total_size += size;
+
+		if(_buffered_size + size <= buffer_size) {
+			std::memcpy(_buffer.data() + _buffered_size, in, size);
+			_buffered_size += size;
+			return;
+		}
+
+		// the buffer is only consumed if more data follows, because the last stripe is handled by the digest
+		if(_buffered_size > 0) {
+			auto load_size = buffer_size - _buffered_size;
+			std::memcpy(_buffer.data() + _buffered_size, in, load_size);
+			in += load_size;
+			consume_stripes(_acc, _stripes_in_block, _buffer.data(), buffer_stripes, _secret.data());
+			_buffered_size = 0;
+		}
+
+		if(std::size_t(end - in) > buffer_size) {
+			do {
+				consume_stripes(_acc, _stripes_in_block, in, buffer_stripes, _secret.data());
+				in += buffer_size;
+			} while(std::size_t(end - in) > buffer_size);
+
+			// the digest may need the previous stripe, if less than a stripe remains
+			std::memcpy(_buffer.data() + buffer_size - stripe_size, in - stripe_size, stripe_size);
+		}
+
+		std::memcpy(_buffer.data(), in, std::size_t(end - in));
+		_buffered_size = std::size_t(end - in);
+	}
+
+	void xxh3_hasher::_digest_long(Acc& acc) const noexcept
+	{
+		acc = _acc;
+
+		if(_buffered_size >= stripe_size) {
+			auto stripes          = (_buffered_size - 1) / stripe_size;
+			auto stripes_in_block = _stripes_in_block;
+			consume_stripes(acc, stripes_in_block, _buffer.data(), stripes, _secret.data());
+			accumulate_stripe(acc,
+			                  _buffer.data() + _buffered_size - stripe_size,
+			                  _secret.data() + secret_size - stripe_size - last_acc_start);
+
+		} else {
+			// the last stripe is composed of the end of the previous data and the buffered data
+			alignas(16) std::uint8_t last_stripe[stripe_size];
+			auto                     catchup_size = stripe_size - _buffered_size;
+			std::memcpy(last_stripe, _buffer.data() + buffer_size - catchup_size, catchup_size);
+			std::memcpy(last_stripe + catchup_size, _buffer.data(), _buffered_size);
+			accumulate_stripe(acc, last_stripe, _secret.data() + secret_size - stripe_size - last_acc_start);
+		}
+	}
+
+	auto xxh3_hasher::digest64() const noexcept -> std::uint64_t
+	{
+		if(_total_size <= midsize_max)
+			return hash64_short(_buffer.data(), _buffered_size, _seed);
+
+		alignas(64) auto acc = Acc();
+		_digest_long(acc);
+		return digest_long_64(acc, _secret.data(), _total_size);
+	}
+
+	auto xxh3_hasher::digest128() const noexcept -> hash128
+	{
+		if(_total_size <= midsize_max)
+			return hash128_short(_buffer.data(), _buffered_size, _seed);
+
+		alignas(64) auto acc = Acc();
+		_digest_long(acc);
+		return digest_long_128(acc, _secret.data(), _total_size);
+	}
+
+} // namespace mirrage::util
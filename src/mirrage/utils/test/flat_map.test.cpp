@@ -0,0 +1,204 @@
+#include <mirrage/utils/flat_map.hpp>
+
+#include <doctest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+using mirrage::util::flat_map;
+using mirrage::util::flat_set;
+
+namespace {
+	/// mostly small keys (so there are many duplicates) and some at the limits of the key type
+	template <class Key>
+	auto random_key(std::mt19937_64& rng, Key range) -> Key
+	{
+		switch(rng() % 8) {
+			case 0: return Key(std::numeric_limits<Key>::min() + Key(rng() % 4));
+			case 1: return Key(std::numeric_limits<Key>::max() - Key(rng() % 4));
+			default: return Key(rng() % std::uint64_t(range));
+		}
+	}
+
+	/// @return the number of keys whose lower_bound/find differ from the reference
+	template <class Key>
+	auto count_mismatches(const flat_set<Key>&  set,
+	                      const std::set<Key>& reference,
+	                      std::mt19937_64&     rng,
+	                      Key                  range) -> int
+	{
+		auto mismatches = 0;
+		auto check      = [&](Key key) {
+			auto expected = std::distance(reference.begin(), reference.lower_bound(key));
+			if(std::distance(set.begin(), set.lower_bound(key)) != expected)
+				mismatches++;
+			if(set.contains(key) != (reference.count(key) > 0))
+				mismatches++;
+			if(set.contains(key) && *set.find(key) != key)
+				mismatches++;
+		};
+
+		for(auto key : reference)
+			check(key);
+		for(auto i = 0; i < 500; i++)
+			check(random_key(rng, range));
+
+		check(std::numeric_limits<Key>::min());
+		check(std::numeric_limits<Key>::max());
+		return mismatches;
+	}
+
+	template <class Key>
+	void check_random_set_operations(Key range, std::size_t max_size)
+	{
+		auto rng       = std::mt19937_64(42);
+		auto set       = flat_set<Key>();
+		auto reference = std::set<Key>();
+
+		for(auto round = 0; round < 60; round++) {
+			// grows the set most of the time, but also removes keys in between
+			auto insert = set.size() < max_size && (round % 10 < 7 || set.size() < 64);
+			auto count  = std::size_t(rng() % (max_size / 16 + 1));
+
+			switch(rng() % 3) {
+				case 0:
+					for(auto i = std::size_t(0); i < count; i++) {
+						auto key = random_key(rng, range);
+						if(insert) {
+							auto [iter, inserted] = set.insert(key);
+							CHECK(inserted == reference.insert(key).second);
+							CHECK(*iter == key);
+						} else {
+							CHECK(set.erase(key) == (reference.erase(key) > 0));
+						}
+					}
+					break;
+
+				case 1:
+					if(insert) {
+						auto keys = std::vector<Key>();
+						for(auto i = std::size_t(0); i < count; i++)
+							keys.push_back(random_key(rng, range));
+
+						set.insert(keys.begin(), keys.end());
+						reference.insert(keys.begin(), keys.end());
+					} else if(!set.empty()) {
+						auto first = std::size_t(rng() % set.size());
+						auto last  = std::min(set.size(), first + count);
+						set.erase(set.begin() + std::ptrdiff_t(first), set.begin() + std::ptrdiff_t(last));
+						reference.erase(std::next(reference.begin(), std::ptrdiff_t(first)),
+						                std::next(reference.begin(), std::ptrdiff_t(last)));
+					}
+					break;
+
+				case 2:
+					for(auto i = std::size_t(0); i < count && (insert || !set.empty()); i++) {
+						if(insert) {
+							auto key = random_key(rng, range);
+							set.insert(key);
+							reference.insert(key);
+						} else {
+							CHECK(set.pop_back() == *reference.rbegin());
+							reference.erase(std::prev(reference.end()));
+						}
+					}
+					break;
+			}
+
+			REQUIRE(set.size() == reference.size());
+			CHECK(std::equal(set.begin(), set.end(), reference.begin()));
+			CHECK(count_mismatches(set, reference, rng, range) == 0);
+		}
+
+		// shrinks the set until it is small enough to be searched without the index levels
+		for(auto i = 0; !set.empty(); i++) {
+			auto key = set[std::int64_t(rng() % set.size())];
+			CHECK(set.erase(key));
+			reference.erase(key);
+
+			if(i % 64 == 0 || set.size() < 100)
+				CHECK(count_mismatches(set, reference, rng, range) == 0);
+		}
+	}
+} // namespace
+
+TEST_CASE("flat_set behaves like std::set for random insertions, removals and searches.")
+{
+	SUBCASE("int32") { check_random_set_operations<std::int32_t>(10'000, 3'000); }
+	SUBCASE("uint32") { check_random_set_operations<std::uint32_t>(10'000, 3'000); }
+	SUBCASE("int64") { check_random_set_operations<std::int64_t>(10'000, 3'000); }
+	SUBCASE("uint64") { check_random_set_operations<std::uint64_t>(10'000, 3'000); }
+	SUBCASE("int16") { check_random_set_operations<std::int16_t>(2'000, 1'000); }
+}
+
+TEST_CASE("flat_set is constructed from unsorted keys with duplicates.")
+{
+	auto set = flat_set<int>(std::vector<int>{5, 3, 9, 3, 1, 5});
+	CHECK(std::vector<int>(set.begin(), set.end()) == std::vector<int>{1, 3, 5, 9});
+	CHECK(*set.lower_bound(4) == 5);
+	CHECK(set.lower_bound(10) == set.end());
+}
+
+TEST_CASE("flat_map behaves like std::map for random insertions, removals and searches.")
+{
+	auto rng       = std::mt19937_64(7);
+	auto map       = flat_map<std::int64_t, std::int64_t>();
+	auto reference = std::map<std::int64_t, std::int64_t>();
+	auto range     = std::int64_t(8'000);
+
+	for(auto round = 0; round < 60; round++) {
+		auto insert = map.size() < 2'000 && (round % 10 < 7 || map.size() < 64);
+		auto count  = std::size_t(rng() % 200);
+
+		if(insert && round % 2 == 0) {
+			auto entries = std::vector<std::pair<std::int64_t, std::int64_t>>();
+			for(auto i = std::size_t(0); i < count; i++)
+				entries.emplace_back(random_key(rng, range), std::int64_t(rng()));
+
+			// existing keys and repeated keys keep their first value, like emplace
+			map.insert(entries.begin(), entries.end());
+			for(auto& [key, value] : entries)
+				reference.emplace(key, value);
+
+		} else {
+			for(auto i = std::size_t(0); i < count; i++) {
+				auto key = random_key(rng, range);
+				if(insert) {
+					auto value             = std::int64_t(rng());
+					auto [entry, emplaced] = map.emplace(key, value);
+					auto expected          = reference.emplace(key, value);
+					CHECK(emplaced == expected.second);
+					CHECK(entry == expected.first->second);
+				} else {
+					CHECK(map.erase(key) == (reference.erase(key) > 0));
+				}
+			}
+		}
+
+		REQUIRE(map.size() == reference.size());
+
+		auto mismatches = 0;
+		auto i          = std::size_t(0);
+		for(auto& [key, value] : reference) {
+			if(map.keys()[i] != key || map.value_at(i) != value)
+				mismatches++;
+			i++;
+		}
+		for(auto j = 0; j < 500; j++) {
+			auto key      = random_key(rng, range);
+			auto expected = reference.find(key);
+			auto found    = map.find(key);
+			if(found.is_some() != (expected != reference.end())
+			   || (found.is_some() && found.get_or_throw() != expected->second)
+			   || map.contains(key) != found.is_some())
+				mismatches++;
+		}
+		CHECK(mismatches == 0);
+	}
+}
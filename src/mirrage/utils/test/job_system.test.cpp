@@ -0,0 +1,170 @@
+#include <mirrage/utils/job_system.hpp>
+
+#include <doctest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+using mirrage::util::Job_priority;
+using mirrage::util::job_counter;
+using mirrage::util::job_system;
+
+TEST_CASE("try_run_one only executes jobs with at least the requested priority.")
+{
+	auto jobs     = job_system(0);
+	auto executed = std::vector<Job_priority>();
+	jobs.spawn([&] { executed.push_back(Job_priority::low); }, Job_priority::low);
+	jobs.spawn([&] { executed.push_back(Job_priority::high); }, Job_priority::high);
+
+	CHECK(jobs.try_run_one(Job_priority::normal));
+	CHECK_FALSE(jobs.try_run_one(Job_priority::normal));
+	CHECK(jobs.try_run_one());
+	CHECK(executed == std::vector<Job_priority>{Job_priority::high, Job_priority::low});
+}
+
+TEST_CASE("current_priority is the priority of the executed job.")
+{
+	auto jobs = job_system(0);
+	CHECK(jobs.current_priority() == Job_priority::low);
+
+	auto inner = Job_priority::normal;
+	jobs.spawn([&] { inner = jobs.current_priority(); }, Job_priority::high);
+	jobs.try_run_one();
+	CHECK(inner == Job_priority::high);
+	CHECK(jobs.current_priority() == Job_priority::low);
+}
+
+TEST_CASE("wait executes the jobs of the counter, even if they have a low priority.")
+{
+	auto jobs    = job_system(0);
+	auto counter = job_counter();
+	auto count   = 0;
+	jobs.spawn(counter, [&] { count++; }, Job_priority::high);
+	jobs.spawn(counter, [&] { count++; }, Job_priority::low);
+	CHECK(counter.lowest_priority() == Job_priority::low);
+
+	jobs.wait(counter);
+	CHECK(count == 2);
+}
+
+TEST_CASE("help_until executes lower priority jobs, if there is nothing else to do.")
+{
+	auto jobs = job_system(0);
+	auto done = false;
+	jobs.spawn([&] { done = true; }, Job_priority::low);
+
+	jobs.help_until([&] { return done; }, Job_priority::high);
+	CHECK(done);
+}
+
+TEST_CASE("Jobs that are spawned and stolen concurrently by several workers are all executed once.")
+{
+	constexpr auto outer_jobs = std::uint64_t(64);
+	constexpr auto inner_jobs = std::uint64_t(100);
+
+	auto jobs    = job_system(4);
+	auto counter = job_counter();
+	auto total   = std::atomic<std::uint64_t>(0);
+
+	// the inner jobs are pushed to the deques of the workers and stolen by the others
+	for(auto i = std::uint64_t(0); i < outer_jobs; i++) {
+		jobs.spawn(counter, [&, i] {
+			for(auto j = std::uint64_t(0); j < inner_jobs; j++)
+				jobs.spawn(counter, [&, value = i * inner_jobs + j] { total += value; });
+		});
+	}
+	jobs.wait(counter);
+
+	constexpr auto n = outer_jobs * inner_jobs;
+	CHECK(counter.done());
+	CHECK(total.load() == n * (n - 1) / 2);
+}
+
+TEST_CASE("Nested waits finish while the workers are busy with other jobs.")
+{
+	constexpr auto outer_jobs = 32;
+	constexpr auto inner_jobs = 16;
+
+	auto jobs         = job_system(4);
+	auto load_counter = job_counter();
+	auto load_done    = std::atomic<int>(0);
+	for(auto i = 0; i < 2000; i++) {
+		jobs.spawn(load_counter, [&] {
+			auto sum = std::atomic<int>(0);
+			for(auto j = 0; j < 1000; j++)
+				sum += j;
+			load_done++;
+		});
+	}
+
+	auto counter = job_counter();
+	auto done    = std::atomic<int>(0);
+	for(auto i = 0; i < outer_jobs; i++) {
+		jobs.spawn(counter, [&] {
+			auto inner       = job_counter();
+			auto inner_count = std::atomic<int>(0);
+			for(auto j = 0; j < inner_jobs; j++)
+				jobs.spawn(inner, [&] { inner_count++; }, Job_priority::low);
+
+			jobs.wait(inner);
+			CHECK(inner_count.load() == inner_jobs);
+			done++;
+		});
+	}
+
+	jobs.wait(counter);
+	CHECK(done.load() == outer_jobs);
+
+	jobs.wait(load_counter);
+	CHECK(load_done.load() == 2000);
+}
+
+TEST_CASE("parallel_for visits every index exactly once.")
+{
+	constexpr auto begin = std::size_t(3);
+	constexpr auto end   = std::size_t(10'000);
+	constexpr auto grain = std::size_t(7);
+
+	auto jobs           = job_system(4);
+	auto visits         = std::vector<std::atomic<int>>(end);
+	auto invalid_chunks = std::atomic<int>(0);
+
+	jobs.parallel_for(begin, end, grain, [&](std::size_t chunk_begin, std::size_t chunk_end) {
+		if(chunk_begin >= chunk_end || chunk_end - chunk_begin > grain || chunk_begin < begin
+		   || chunk_end > end)
+			invalid_chunks++;
+
+		for(auto i = chunk_begin; i < chunk_end; i++)
+			visits[i]++;
+	});
+
+	CHECK(invalid_chunks.load() == 0);
+
+	auto wrong_visits = 0;
+	for(auto i = std::size_t(0); i < end; i++) {
+		if(visits[i].load() != (i < begin ? 0 : 1))
+			wrong_visits++;
+	}
+	CHECK(wrong_visits == 0);
+}
+
+TEST_CASE("The destructor executes all pending jobs, including the ones they spawn.")
+{
+	constexpr auto count = 1000;
+
+	auto executed = std::atomic<int>(0);
+	{
+		auto jobs = job_system(2);
+		for(auto i = 0; i < count; i++) {
+			jobs.spawn(
+			        [&] {
+				        executed++;
+				        jobs.spawn([&] { executed++; }, Job_priority::low);
+			        },
+			        Job_priority::low);
+		}
+	}
+
+	CHECK(executed.load() == 2 * count);
+}
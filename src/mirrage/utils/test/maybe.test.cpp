@@ -0,0 +1,67 @@
+#include <mirrage/utils/maybe.hpp>
+
+#include <doctest.h>
+
+#include <memory>
+#include <utility>
+
+using mirrage::util::maybe;
+using mirrage::util::nothing;
+
+namespace {
+	/// counts the live instances through the shared_ptr's use_count
+	struct Tracked {
+		std::shared_ptr<int> owner;
+	};
+} // namespace
+
+TEST_CASE("Assigning nothing to a maybe destroys its value.")
+{
+	auto value = std::make_shared<int>(42);
+
+	auto copied = maybe<Tracked>(Tracked{value});
+	auto moved  = maybe<Tracked>(Tracked{value});
+	CHECK(value.use_count() == 3);
+
+	auto empty = maybe<Tracked>();
+	copied     = empty;
+	CHECK(copied.is_nothing());
+	CHECK(value.use_count() == 2);
+
+	moved = maybe<Tracked>();
+	CHECK(moved.is_nothing());
+	CHECK(value.use_count() == 1);
+}
+
+TEST_CASE("Assigning a value to a maybe creates or replaces its value.")
+{
+	auto a = std::make_shared<int>(1);
+	auto b = std::make_shared<int>(2);
+
+	auto target = maybe<Tracked>();
+	auto source = maybe<Tracked>(Tracked{a});
+	target      = source;
+	CHECK(a.use_count() == 3);
+
+	target = maybe<Tracked>(Tracked{b});
+	CHECK(a.use_count() == 2);
+	CHECK(b.use_count() == 2);
+	CHECK(target.get_or_throw().owner == b);
+
+	target = std::move(source);
+	CHECK(source.is_nothing());
+	CHECK(a.use_count() == 2);
+	CHECK(b.use_count() == 1);
+}
+
+TEST_CASE("Moving from a maybe leaves nothing behind.")
+{
+	auto value  = std::make_shared<int>(42);
+	auto source = maybe<Tracked>(Tracked{value});
+	{
+		auto target = std::move(source);
+		CHECK(source.is_nothing());
+		CHECK(value.use_count() == 2);
+	}
+	CHECK(value.use_count() == 1);
+}
@@ -0,0 +1,153 @@
+#include <mirrage/utils/ring_buffer.hpp>
+
+#include <doctest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using mirrage::util::mpmc_ring_buffer;
+using mirrage::util::spsc_ring_buffer;
+
+namespace {
+	template <class Queue>
+	void check_full_and_empty(Queue& queue)
+	{
+		auto out = 0;
+		CHECK(queue.empty());
+		CHECK_FALSE(queue.try_pop(out));
+
+		for(auto i = 0; i < int(queue.capacity()); i++)
+			CHECK(queue.try_push(i));
+
+		CHECK(queue.size_approx() == queue.capacity());
+		CHECK_FALSE(queue.try_push(-1));
+
+		for(auto lap = 0; lap < 3; lap++) {
+			for(auto i = 0; i < int(queue.capacity()); i++) {
+				REQUIRE(queue.try_pop(out));
+				CHECK(out == i);
+				CHECK(queue.try_push(i));
+				CHECK_FALSE(queue.try_push(-1));
+			}
+		}
+
+		for(auto i = 0; i < int(queue.capacity()); i++) {
+			REQUIRE(queue.try_pop(out));
+			CHECK(out == i);
+		}
+		CHECK(queue.empty());
+		CHECK_FALSE(queue.try_pop(out));
+	}
+
+	template <class Queue>
+	void check_bulk(Queue& queue)
+	{
+		auto in = std::vector<int>(queue.capacity() + 3);
+		std::iota(in.begin(), in.end(), 0);
+
+		CHECK(queue.push_bulk(in.begin(), in.size()) == queue.capacity());
+		CHECK(queue.push_bulk(in.begin(), 1) == 0);
+
+		auto out   = std::vector<int>(in.size(), -1);
+		auto first = std::min(queue.capacity(), std::size_t(2));
+		CHECK(queue.pop_bulk(out.begin(), first) == first);
+		CHECK(queue.pop_bulk(out.begin() + first, out.size()) == queue.capacity() - first);
+		CHECK(queue.pop_bulk(out.begin(), 1) == 0);
+		CHECK(std::equal(out.begin(), out.begin() + queue.capacity(), in.begin()));
+	}
+
+	struct Counted {
+		std::shared_ptr<int> value = std::make_shared<int>(0);
+	};
+} // namespace
+
+TEST_CASE("spsc_ring_buffer rounds its capacity up to the next power of two.")
+{
+	CHECK(spsc_ring_buffer<int>(0).capacity() == 1);
+	CHECK(spsc_ring_buffer<int>(1).capacity() == 1);
+	CHECK(spsc_ring_buffer<int>(3).capacity() == 4);
+	CHECK(spsc_ring_buffer<int>(4).capacity() == 4);
+}
+
+TEST_CASE("mpmc_ring_buffer has a capacity of at least two.")
+{
+	CHECK(mpmc_ring_buffer<int>(0).capacity() == 2);
+	CHECK(mpmc_ring_buffer<int>(1).capacity() == 2);
+	CHECK(mpmc_ring_buffer<int>(3).capacity() == 4);
+	CHECK(mpmc_ring_buffer<int>(4).capacity() == 4);
+}
+
+TEST_CASE("spsc_ring_buffer rejects pushes when full and pops when empty.")
+{
+	for(auto capacity : {1, 2, 8}) {
+		auto queue = spsc_ring_buffer<int>(std::size_t(capacity));
+		check_full_and_empty(queue);
+		check_bulk(queue);
+	}
+}
+
+TEST_CASE("mpmc_ring_buffer rejects pushes when full and pops when empty.")
+{
+	for(auto capacity : {1, 2, 8}) {
+		auto queue = mpmc_ring_buffer<int>(std::size_t(capacity));
+		check_full_and_empty(queue);
+		check_bulk(queue);
+	}
+}
+
+TEST_CASE("Elements left in a ring buffer are destroyed with it.")
+{
+	auto element = Counted{};
+	{
+		auto spsc = spsc_ring_buffer<Counted>(4);
+		auto mpmc = mpmc_ring_buffer<Counted>(4);
+		spsc.try_push(element);
+		spsc.try_push(element);
+		mpmc.try_push(element);
+		CHECK(element.value.use_count() == 4);
+	}
+	CHECK(element.value.use_count() == 1);
+}
+
+TEST_CASE("mpmc_ring_buffer passes every element to exactly one consumer.")
+{
+	constexpr auto producers = 2;
+	constexpr auto consumers = 2;
+	constexpr auto count     = 20000;
+
+	auto queue    = mpmc_ring_buffer<int>(16);
+	auto received = std::vector<std::atomic<int>>(producers * count);
+	auto popped   = std::atomic<int>(0);
+
+	auto threads = std::vector<std::thread>();
+	for(auto p = 0; p < producers; p++) {
+		threads.emplace_back([&, p] {
+			for(auto i = 0; i < count; i++) {
+				while(!queue.try_push(p * count + i))
+					std::this_thread::yield();
+			}
+		});
+	}
+	for(auto c = 0; c < consumers; c++) {
+		threads.emplace_back([&] {
+			auto value = 0;
+			while(popped.load() < producers * count) {
+				if(queue.try_pop(value)) {
+					received[std::size_t(value)]++;
+					popped++;
+				} else {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	for(auto& t : threads)
+		t.join();
+
+	CHECK(queue.empty());
+	CHECK(std::all_of(received.begin(), received.end(), [](auto& r) { return r.load() == 1; }));
+}
@@ -0,0 +1,25 @@
+#include <mirrage/utils/string_utils.hpp>
+
+#include <doctest.h>
+
+#include <sstream>
+#include <string>
+
+using namespace mirrage::util;
+
+namespace {
+	auto json_escaped(std::string_view str)
+	{
+		auto out = std::ostringstream();
+		write_json_escaped(out, str);
+		return out.str();
+	}
+} // namespace
+
+TEST_CASE("write_json_escaped escapes quotes, backslashes and all control characters.")
+{
+	CHECK(json_escaped("plain text/äöü") == "plain text/äöü");
+	CHECK(json_escaped("\"quoted\" \\path") == "\\\"quoted\\\" \\\\path");
+	CHECK(json_escaped("a\nb\rc\td") == "a\\nb\\rc\\td");
+	CHECK(json_escaped(std::string_view("\0\x01\x1f\x20", 4)) == "\\u0000\\u0001\\u001f ");
+}
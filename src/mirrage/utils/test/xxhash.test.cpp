@@ -0,0 +1,74 @@
+#include <mirrage/utils/xxhash.hpp>
+
+#include <doctest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+	using mirrage::util::hash128;
+
+	struct Reference {
+		std::size_t   size;
+		std::uint64_t seed;
+		std::uint64_t hash64;
+		hash128       hash128bit;
+	};
+
+	// calculated with the reference implementation (xxHash 0.8), covering every size class
+	constexpr Reference references[] = {
+	        {0, 0, 0x2d06800538d394c2, {0x6001c324468d497f, 0x99aa06d3014798d8}},
+	        {0, 0x9e3779b97f4a7c15, 0x602b0e2cd6662c8b, {0x4ca5176998171787, 0xd142977a2cca554b}},
+	        {1, 0, 0x4c5cca45d0f4811f, {0x4c5cca45d0f4811f, 0x495b62073ef70ca4}},
+	        {3, 0x9e3779b97f4a7c15, 0x079dd5d54d89480a, {0x079dd5d54d89480a, 0xbf6c84df5f76651d}},
+	        {4, 0, 0xdca012f95811b6b9, {0xb987ca5d9241572a, 0x7fefeeffb4d0eab3}},
+	        {8, 0x9e3779b97f4a7c15, 0x19ef7d3919108aff, {0x3edb070ecf3a9343, 0xc3612dc11470e721}},
+	        {9, 0, 0xcbe393399f17ffbd, {0x4376673580310154, 0xd46556872d230f22}},
+	        {16, 0x9e3779b97f4a7c15, 0xa106510078b0a252, {0x4e683254a04c377f, 0xbe0f27bac4d1f58f}},
+	        {17, 0, 0x208bde5ee2bed407, {0x78c349fe81b2f26c, 0x18217300b5132d5a}},
+	        {128, 0x9e3779b97f4a7c15, 0x95425530beb89fe8, {0x8dd13adf89d20a39, 0xf1355c6816c0b724}},
+	        {129, 0, 0xf8f76713f2bb60fa, {0xc51bc887976aef63, 0x6881633650cd8924}},
+	        {240, 0x9e3779b97f4a7c15, 0x2d882e7899ff64cc, {0xde896b7f1ae3bc6f, 0x5b131678a4a9b8f4}},
+	        {241, 0, 0x0b3b630948ce4a00, {0x0b3b630948ce4a00, 0x92b991a7192f3f08}},
+	        {1024, 0x9e3779b97f4a7c15, 0x7e249adc60e1f9b4, {0x7e249adc60e1f9b4, 0x927c8d2b50d33f53}},
+	        {4096, 0, 0xa3c19f8174cde0bb, {0xa3c19f8174cde0bb, 0x49d3842b33d51e8a}},
+	};
+
+	auto test_data()
+	{
+		auto data = std::vector<std::uint8_t>(4096);
+		for(auto i = std::size_t(0); i < data.size(); i++)
+			data[i] = std::uint8_t(i * 31 + 7);
+		return data;
+	}
+} // namespace
+
+TEST_CASE("xxh3_64 and xxh3_128 match the reference implementation.")
+{
+	auto data = test_data();
+	for(auto& ref : references) {
+		CHECK(mirrage::util::xxh3_64(data.data(), ref.size, ref.seed) == ref.hash64);
+		CHECK(mirrage::util::xxh3_128(data.data(), ref.size, ref.seed) == ref.hash128bit);
+	}
+}
+
+TEST_CASE("xxh3_hasher matches the one-shot functions for any chunk size.")
+{
+	auto data = test_data();
+	for(auto& ref : references) {
+		for(auto chunk : {std::size_t(1), std::size_t(7), std::size_t(64), std::size_t(1000)}) {
+			auto hasher = mirrage::util::xxh3_hasher(ref.seed);
+			for(auto offset = std::size_t(0); offset < ref.size; offset += chunk)
+				hasher.update(data.data() + offset, std::min(chunk, ref.size - offset));
+
+			CHECK(hasher.digest64() == ref.hash64);
+			CHECK(hasher.digest128() == ref.hash128bit);
+		}
+	}
+}
+
+TEST_CASE("to_hex prints 128 bit hashes in the canonical order.")
+{
+	CHECK(mirrage::util::to_hex(mirrage::util::xxh3_128("mirrage")) == "c848137cd4b62ec2217207a7cbf97ddb");
+}